@@ -0,0 +1,277 @@
+#include "bench.h"
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/heli_attitude.h>
+#include <cpp-math/pose_context.h>
+#include <cpp-math/reference.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  constexpr double distance = 1000;
+  cpp_math::Vector3d const position{100, -200, 1500};
+
+  struct Sample
+  {
+    cpp_math::HeliAngles angles;
+    cpp_math::CameraAngles camera_angles;
+    // Vector for rotateVector, camera angles are not used there
+    cpp_math::Vector3d vector;
+  };
+
+  struct Category
+  {
+    std::string name;
+    std::vector<Sample> samples;
+  };
+
+  /// @brief Results of a function over one category, written into arrays so batch kernels fit in
+  struct Outputs
+  {
+    std::vector<double> x, y, z;
+
+    explicit Outputs(size_t count) : x(count), y(count), z(count) {}
+
+    void set(size_t i, cpp_math::Vector3d const& v)
+    {
+      x[i] = v.x;
+      y[i] = v.y;
+      z[i] = v.z;
+    }
+  };
+
+  struct Function
+  {
+    std::string name;
+    // Reference of rotateVector or of calculatePointByDistanceAndAngles
+    bool is_rotation;
+    // In ULP of float instead of double
+    bool is_float;
+    std::function<void(std::vector<Sample> const&, Outputs&)> run;
+  };
+
+  cpp_math::Vector3d randomUnitVector(std::mt19937_64& generator)
+  {
+    std::normal_distribution<double> normal(0, 1);
+    auto v = cpp_math::Vector3d{normal(generator), normal(generator), normal(generator)};
+    auto length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+    return {v.x / length, v.y / length, v.z / length};
+  }
+
+  std::vector<Category> makeCategories(size_t samples)
+  {
+    std::mt19937_64 generator(23);
+    std::uniform_real_distribution<double> angle(-180, 180);
+    auto random = [&](double yaw, double pitch, double roll, cpp_math::CameraAngles camera) {
+      return Sample{{yaw, pitch, roll}, camera, randomUnitVector(generator)};
+    };
+    std::vector<Category> categories;
+
+    // Every multiple of 30 degrees, rotation orders change on these
+    Category grid{"grid", {}};
+    for(double yaw = -180; yaw <= 180; yaw += 30) {
+      for(double pitch = -180; pitch <= 180; pitch += 30) {
+        for(double roll = -180; roll <= 180; roll += 30) {
+          grid.samples.push_back({{yaw, pitch, roll}, {0, 0}, {1, 0, 0}});
+          grid.samples.push_back({{yaw, pitch, roll}, {15, -45}, {0, 0, 1}});
+        }
+      }
+    }
+    categories.push_back(grid);
+
+    Category uniform{"random", {}};
+    for(size_t i = 0; i < samples; ++i) {
+      uniform.samples.push_back(random(angle(generator), angle(generator), angle(generator), {angle(generator), angle(generator)}));
+    }
+    categories.push_back(uniform);
+
+    // Pitch with camera pitch about +-90, yaw and roll lose their meaning there
+    Category gimbal{"pitch +-90", {}};
+    double const offsets[] = {0, 1e-15, -1e-15, 1e-13, -1e-13, 1e-9, -1e-9, 1e-6, -1e-6};
+    for(size_t i = 0; i < samples; ++i) {
+      auto pitch = (i % 2 == 0 ? 90 : -90) + offsets[i % 9];
+      auto camera_pitch = i % 3 == 0 ? 0.0 : angle(generator);
+      gimbal.samples.push_back(random(angle(generator), pitch - camera_pitch, angle(generator), {angle(generator), camera_pitch}));
+    }
+    categories.push_back(gimbal);
+
+    std::uniform_real_distribution<double> turns(-1e6, 1e6);
+    Category multi_turn{"multi-turn", {}};
+    for(size_t i = 0; i < samples; ++i) {
+      auto big = [&]() { return 360 * std::round(turns(generator)) + angle(generator); };
+      multi_turn.samples.push_back(random(big(), big(), big(), {big(), big()}));
+    }
+    categories.push_back(multi_turn);
+
+    // Angles and vector components about the threshold of close_to_zero, 2.2e-14
+    Category near_zero{"near zero", {}};
+    double const tiny[] = {0, 1e-16, 1e-14, 2.2e-14, 3e-14, 1e-12};
+    for(size_t i = 0; i < samples; ++i) {
+      auto pick = [&](size_t shift) { return (i >> shift) % 3 == 0 ? tiny[(i + shift) % 6] : angle(generator); };
+      auto sample = random(pick(0), pick(2), pick(4), {i % 5 == 0 ? -pick(0) : 0.0, 0});
+      sample.vector = {1, tiny[i % 6], tiny[(i / 6) % 6]};
+      near_zero.samples.push_back(sample);
+    }
+    categories.push_back(near_zero);
+    return categories;
+  }
+
+  std::vector<Function> makeFunctions()
+  {
+    std::vector<Function> functions;
+    auto rotation = [](std::string name, cpp_math::TrigPolicy policy) {
+      return Function{name, true, false, [policy](std::vector<Sample> const& samples, Outputs& outputs) {
+        for(size_t i = 0; i < samples.size(); ++i) {
+          outputs.set(i, cpp_math::rotateVector(samples[i].vector, samples[i].angles, policy));
+        }
+      }};
+    };
+    functions.push_back(rotation("rotateVector", cpp_math::TrigPolicy::Standard));
+    functions.push_back(rotation("rotateVector Ulp1", cpp_math::TrigPolicy::Ulp1));
+    functions.push_back({"rotateVector float", true, true, [](std::vector<Sample> const& samples, Outputs& outputs) {
+      for(size_t i = 0; i < samples.size(); ++i) {
+        auto const& s = samples[i];
+        auto v = cpp_math::rotateVector(
+          cpp_math::Vector3f{float(s.vector.x), float(s.vector.y), float(s.vector.z)},
+          cpp_math::HeliAnglesf{float(s.angles.yaw), float(s.angles.pitch), float(s.angles.roll)}
+        );
+        outputs.set(i, {v.x, v.y, v.z});
+      }
+    }});
+    functions.push_back({"HeliAttitude::apply", true, false, [](std::vector<Sample> const& samples, Outputs& outputs) {
+      for(size_t i = 0; i < samples.size(); ++i) {
+        outputs.set(i, cpp_math::HeliAttitude(samples[i].angles).apply(samples[i].vector));
+      }
+    }});
+
+    auto point = [](std::string name, cpp_math::TrigPolicy policy) {
+      return Function{name, false, false, [policy](std::vector<Sample> const& samples, Outputs& outputs) {
+        for(size_t i = 0; i < samples.size(); ++i) {
+          outputs.set(
+            i, cpp_math::calculatePointByDistanceAndAngles(distance, position, samples[i].angles, samples[i].camera_angles, policy)
+          );
+        }
+      }};
+    };
+    functions.push_back(point("calculatePoint", cpp_math::TrigPolicy::Standard));
+    functions.push_back(point("calculatePoint Ulp1", cpp_math::TrigPolicy::Ulp1));
+    functions.push_back({"PoseContext", false, false, [](std::vector<Sample> const& samples, Outputs& outputs) {
+      cpp_math::PoseContext context;
+      for(size_t i = 0; i < samples.size(); ++i) {
+        outputs.set(i, context.calculatePoint(distance, position, samples[i].angles, samples[i].camera_angles));
+      }
+    }});
+    for(auto mode : {cpp_math::BatchMode::Fast, cpp_math::BatchMode::Strict}) {
+      auto name = std::string(mode == cpp_math::BatchMode::Fast ? "batch Fast" : "batch Strict");
+      functions.push_back({name, false, false, [mode](std::vector<Sample> const& samples, Outputs& outputs) {
+        auto count = samples.size();
+        std::vector<double> distances(count, distance), x(count, position.x), y(count, position.y), z(count, position.z);
+        std::vector<double> yaw(count), pitch(count), roll(count), camera_yaw(count), camera_pitch(count);
+        for(size_t i = 0; i < count; ++i) {
+          yaw[i] = samples[i].angles.yaw;
+          pitch[i] = samples[i].angles.pitch;
+          roll[i] = samples[i].angles.roll;
+          camera_yaw[i] = samples[i].camera_angles.yaw;
+          camera_pitch[i] = samples[i].camera_angles.pitch;
+        }
+        cpp_math::calculatePointsByDistanceAndAngles(
+          count,
+          distances.data(),
+          {x.data(), y.data(), z.data()},
+          {yaw.data(), pitch.data(), roll.data()},
+          {camera_yaw.data(), camera_pitch.data()},
+          {outputs.x.data(), outputs.y.data(), outputs.z.data()},
+          mode
+        );
+      }});
+    }
+    return functions;
+  }
+
+  Sample roundedToFloat(Sample const& s)
+  {
+    auto round = [](double value) { return static_cast<double>(static_cast<float>(value)); };
+    return {
+      {round(s.angles.yaw), round(s.angles.pitch), round(s.angles.roll)},
+      {round(s.camera_angles.yaw), round(s.camera_angles.pitch)},
+      {round(s.vector.x), round(s.vector.y), round(s.vector.z)}
+    };
+  }
+
+  /// @return Calls per second, the function is repeated over the samples for at least duration
+  double measureThroughput(Function const& function, std::vector<Sample> const& samples, std::chrono::milliseconds duration)
+  {
+    Outputs outputs(samples.size());
+    uint64_t calls = 0;
+    auto const start = Clock::now();
+    auto elapsed = Clock::duration();
+    do {
+      function.run(samples, outputs);
+      cpp_math_bench::doNotOptimize(outputs.x[0]);
+      calls += samples.size();
+      elapsed = Clock::now() - start;
+    } while(elapsed < duration);
+    return static_cast<double>(calls) / std::chrono::duration<double>(elapsed).count();
+  }
+}  // namespace
+
+namespace cpp_math_bench
+{
+
+  void runAccuracy(size_t samples)
+  {
+    auto categories = makeCategories(samples);
+    auto functions = makeFunctions();
+    std::cout << "Errors against the long double reference, points at " << distance << " m, rotated vectors are unit\n"
+              << "ULP are of the largest component (float ULP for float), calls/s include the loop over samples\n"
+              << "Float picks rotation orders with float thresholds, so near zero it may rotate differently\n";
+    std::cout << std::left << std::setw(22) << "function" << std::setw(12) << "angles" << std::right << std::setw(10) << "samples"
+              << std::setw(14) << "max error" << std::setw(14) << "mean error" << std::setw(12) << "max ULP" << std::setw(12)
+              << "mean ULP" << std::setw(14) << "calls/s" << "\n";
+    for(auto const& function : functions) {
+      for(auto const& category : categories) {
+        auto const& inputs = category.samples;
+        Outputs outputs(inputs.size());
+        function.run(inputs, outputs);
+        long double max_error = 0, sum_error = 0;
+        double max_ulp = 0, sum_ulp = 0;
+        for(size_t i = 0; i < inputs.size(); ++i) {
+          // Float functions get rounded inputs, the reference starts from the same ones
+          auto s = function.is_float ? roundedToFloat(inputs[i]) : inputs[i];
+          auto expected = function.is_rotation
+                        ? cpp_math::reference::rotateVector(s.vector, s.angles)
+                        : cpp_math::reference::calculatePointByDistanceAndAngles(distance, position, s.angles, s.camera_angles);
+          auto result = cpp_math::Vector3d{outputs.x[i], outputs.y[i], outputs.z[i]};
+          auto error = cpp_math::reference::absoluteError(result, expected);
+          auto ulp = function.is_float
+                   ? cpp_math::reference::ulpError(cpp_math::Vector3f{float(result.x), float(result.y), float(result.z)}, expected)
+                   : cpp_math::reference::ulpError(result, expected);
+          max_error = std::max(max_error, error);
+          sum_error += error;
+          max_ulp = std::max(max_ulp, ulp);
+          sum_ulp += ulp;
+        }
+        auto count = static_cast<double>(inputs.size());
+        std::cout << std::left << std::setw(22) << function.name << std::setw(12) << category.name << std::right
+                  << std::setw(10) << inputs.size() << std::scientific << std::setprecision(2) << std::setw(14)
+                  << static_cast<double>(max_error) << std::setw(14) << static_cast<double>(sum_error) / count
+                  << std::fixed << std::setprecision(2) << std::setw(12) << max_ulp << std::setw(12) << sum_ulp / count
+                  << std::setprecision(0) << std::setw(14) << measureThroughput(function, inputs, std::chrono::milliseconds(50))
+                  << "\n";
+      }
+    }
+  }
+
+}  // namespace cpp_math_bench
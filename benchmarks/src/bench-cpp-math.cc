@@ -0,0 +1,675 @@
+#include "bench.h"
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/fixed_rotation.h>
+#include <cpp-math/geodetic.h>
+#include <cpp-math/heli_attitude.h>
+#include <cpp-math/lidar_scan.h>
+#include <cpp-math/packed.h>
+#include <cpp-math/pointing.h>
+#include <cpp-math/pose_context.h>
+#include <cpp-math/quaternion.h>
+#include <cpp-math/sensor_rig.h>
+#include <cpp-math/trigonometry.h>
+#include <cpp-math/uncertainty.h>
+#include <cpp-math/vector_expression.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using cpp_math_bench::Distribution;
+  using cpp_math_bench::doNotOptimize;
+  using cpp_math_bench::registerBenchmark;
+
+  // Inputs are reused in a loop, small enough to stay in L1
+  constexpr size_t inputs_count = 256;
+  constexpr size_t inputs_mask = inputs_count - 1;
+  constexpr size_t batch_size = 1024;
+
+  std::vector<double> makeAxisAngles(Distribution distribution)
+  {
+    std::vector<double> result;
+    for(auto const& angles : cpp_math_bench::makeHeliAngles(distribution, inputs_count)) {
+      result.push_back(angles.pitch);
+    }
+    return result;
+  }
+
+  void registerRotations(Distribution distribution)
+  {
+    auto suffix = "/" + cpp_math_bench::distributionName(distribution);
+    auto heli_angles = cpp_math_bench::makeHeliAngles(distribution, inputs_count);
+    auto camera_angles = cpp_math_bench::makeCameraAngles(distribution, inputs_count);
+    auto axis_angles = makeAxisAngles(distribution);
+    auto vectors = cpp_math_bench::makeVectors(inputs_count);
+
+    registerBenchmark("rotateVector/HeliAngles" + suffix, [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(cpp_math::rotateVector(vectors[i & inputs_mask], heli_angles[i & inputs_mask]));
+      }
+    });
+    registerBenchmark("rotateVector/Axis" + suffix, [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(cpp_math::rotateVector(vectors[i & inputs_mask], cpp_math::Axis::Y, axis_angles[i & inputs_mask]));
+      }
+    });
+    registerBenchmark("calculatePointByDistanceAndAngles" + suffix, [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(cpp_math::calculatePointByDistanceAndAngles(
+          100, vectors[i & inputs_mask], heli_angles[i & inputs_mask], camera_angles[i & inputs_mask]
+        ));
+      }
+    });
+    registerBenchmark("calculateRotationMatrix" + suffix, [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(cpp_math::calculateRotationMatrix(
+          cpp_math::Axis::Y, cpp_math::degreesToRadians(axis_angles[i & inputs_mask])
+        ));
+      }
+    });
+    registerBenchmark("HeliAttitude/construct" + suffix, [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(cpp_math::HeliAttitude(heli_angles[i & inputs_mask], camera_angles[i & inputs_mask]));
+      }
+    });
+    registerBenchmark("sincosDeg" + suffix, [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        double s, c;
+        cpp_math::sincosDeg(axis_angles[i & inputs_mask], s, c);
+        doNotOptimize(s);
+        doNotOptimize(c);
+      }
+    });
+  }
+
+  void registerMatrices()
+  {
+    auto heli_angles = cpp_math_bench::makeHeliAngles(Distribution::Random, inputs_count);
+    std::vector<cpp_math::Mat3> matrices;
+    for(auto const& angles : heli_angles) {
+      matrices.push_back(cpp_math::calculateRotationMatrix(cpp_math::Axis::Z, cpp_math::degreesToRadians(angles.yaw)));
+    }
+    std::vector<cpp_math::Matrix3d> legacy_matrices(matrices.begin(), matrices.end());
+
+    registerBenchmark("multiplyMatrices/Mat3", [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(cpp_math::multiplyMatrices(matrices[i & inputs_mask], matrices[(i + 1) & inputs_mask]));
+      }
+    });
+    registerBenchmark("multiplyMatrices/Matrix3d", [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(cpp_math::multiplyMatrices(legacy_matrices[i & inputs_mask], legacy_matrices[(i + 1) & inputs_mask]));
+      }
+    });
+    // Mount offset of -2.5 degrees around Y applied before the attitude
+    registerBenchmark("mountRotation/runtime", [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        auto mount = cpp_math::calculateRotationMatrixFromDegrees(cpp_math::Axis::Y, -2.5, cpp_math::TrigPolicy::Standard);
+        doNotOptimize(cpp_math::composeRotations(mount, matrices[i & inputs_mask]));
+      }
+    });
+    registerBenchmark("mountRotation/FixedRotation", [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(cpp_math::FixedRotation<cpp_math::Axis::Y, -5, 2>::then(matrices[i & inputs_mask]));
+      }
+    });
+  }
+
+  /// @brief One op is one point, so the numbers are comparable with calculatePointByDistanceAndAngles
+  void registerBatch(Distribution distribution)
+  {
+    auto const count = batch_size;
+    auto heli_angles = cpp_math_bench::makeHeliAngles(distribution, count);
+    auto camera_angles = cpp_math_bench::makeCameraAngles(distribution, count);
+    auto positions = cpp_math_bench::makeVectors(count);
+    struct Arrays
+    {
+      std::vector<double> distances, x, y, z, yaw, pitch, roll, camera_yaw, camera_pitch, result_x, result_y, result_z;
+    };
+    Arrays arrays;
+    for(size_t i = 0; i < count; ++i) {
+      arrays.distances.push_back(100);
+      arrays.x.push_back(positions[i].x);
+      arrays.y.push_back(positions[i].y);
+      arrays.z.push_back(positions[i].z);
+      arrays.yaw.push_back(heli_angles[i].yaw);
+      arrays.pitch.push_back(heli_angles[i].pitch);
+      arrays.roll.push_back(heli_angles[i].roll);
+      arrays.camera_yaw.push_back(camera_angles[i].yaw);
+      arrays.camera_pitch.push_back(camera_angles[i].pitch);
+    }
+    arrays.result_x.resize(count);
+    arrays.result_y.resize(count);
+    arrays.result_z.resize(count);
+
+    registerBenchmark(
+      "calculatePointsByDistanceAndAngles/per point/" + cpp_math_bench::distributionName(distribution),
+      [arrays](uint64_t begin, uint64_t end) mutable {
+        for(uint64_t done = begin; done < end; done += batch_size) {
+          auto batch = static_cast<size_t>(std::min<uint64_t>(batch_size, end - done));
+          cpp_math::calculatePointsByDistanceAndAngles(
+            batch, arrays.distances.data(), {arrays.x.data(), arrays.y.data(), arrays.z.data()},
+            {arrays.yaw.data(), arrays.pitch.data(), arrays.roll.data()},
+            {arrays.camera_yaw.data(), arrays.camera_pitch.data()},
+            {arrays.result_x.data(), arrays.result_y.data(), arrays.result_z.data()}
+          );
+          doNotOptimize(arrays.result_x[0]);
+        }
+      }
+    );
+  }
+
+  /// @brief p + d * R * v over structure of arrays, one op is one point. Arrays are larger than L2
+  void registerExpressions()
+  {
+    constexpr size_t count = 1 << 16;
+    auto positions = cpp_math_bench::makeVectors(count);
+    struct Arrays
+    {
+      std::vector<double> distances, x, y, z, temporary_x, temporary_y, temporary_z, result_x, result_y, result_z;
+    };
+    auto arrays = std::make_shared<Arrays>();
+    for(size_t i = 0; i < count; ++i) {
+      arrays->distances.push_back(static_cast<double>(i % 100));
+      arrays->x.push_back(positions[i].x);
+      arrays->y.push_back(positions[i].y);
+      arrays->z.push_back(positions[i].z);
+    }
+    for(auto* values : {&arrays->temporary_x, &arrays->temporary_y, &arrays->temporary_z,
+                        &arrays->result_x, &arrays->result_y, &arrays->result_z})
+    {
+      values->resize(count);
+    }
+    auto matrix = cpp_math::calculateRotationMatrix(cpp_math::Axis::Z, 0.5);
+    auto direction = cpp_math::Vector3d{0.6, 0, 0.8};
+
+    // Every operation is its own pass like code written with the free functions does
+    registerBenchmark("vectorExpression/separate passes", [=](uint64_t begin, uint64_t end) {
+      auto& a = *arrays;
+      for(uint64_t done = begin; done < end; done += count) {
+        auto batch = static_cast<size_t>(std::min<uint64_t>(count, end - done));
+        for(size_t i = 0; i < batch; ++i) {
+          auto rotated = cpp_math::multiplyMatrixByVector(matrix, direction);
+          a.temporary_x[i] = rotated.x;
+          a.temporary_y[i] = rotated.y;
+          a.temporary_z[i] = rotated.z;
+        }
+        for(size_t i = 0; i < batch; ++i) {
+          auto temporary = cpp_math::Vector3d{a.temporary_x[i], a.temporary_y[i], a.temporary_z[i]};
+          auto scaled = cpp_math::multiplyVectorByScalar(temporary, a.distances[i]);
+          a.temporary_x[i] = scaled.x;
+          a.temporary_y[i] = scaled.y;
+          a.temporary_z[i] = scaled.z;
+        }
+        for(size_t i = 0; i < batch; ++i) {
+          auto temporary = cpp_math::Vector3d{a.temporary_x[i], a.temporary_y[i], a.temporary_z[i]};
+          auto sum = cpp_math::addVectors(cpp_math::Vector3d{a.x[i], a.y[i], a.z[i]}, temporary);
+          a.result_x[i] = sum.x;
+          a.result_y[i] = sum.y;
+          a.result_z[i] = sum.z;
+        }
+        doNotOptimize(a.result_x[0]);
+      }
+    });
+    registerBenchmark("vectorExpression/single pass", [=](uint64_t begin, uint64_t end) {
+      auto& a = *arrays;
+      for(uint64_t done = begin; done < end; done += count) {
+        auto batch = static_cast<size_t>(std::min<uint64_t>(count, end - done));
+        cpp_math::evaluate(
+          batch, {a.result_x.data(), a.result_y.data(), a.result_z.data()},
+          cpp_math::arrays({a.x.data(), a.y.data(), a.z.data()}) + cpp_math::perElement(a.distances.data()) * matrix * direction
+        );
+        doNotOptimize(a.result_x[0]);
+      }
+    });
+  }
+
+  /// @brief Camera angles to ground targets from one heli pose, one op is one target
+  void registerPointing()
+  {
+    auto targets = cpp_math_bench::makeVectors(batch_size);
+    auto position = cpp_math::Vector3d{0, 0, 1500};
+    auto angles = cpp_math::HeliAngles{30, -2, 3};
+    struct Arrays
+    {
+      std::vector<double> x, y, z, yaw, pitch, distances;
+    };
+    Arrays arrays;
+    for(auto const& target : targets) {
+      arrays.x.push_back(target.x);
+      arrays.y.push_back(target.y);
+      arrays.z.push_back(target.z);
+    }
+    arrays.yaw.resize(batch_size);
+    arrays.pitch.resize(batch_size);
+    arrays.distances.resize(batch_size);
+
+    registerBenchmark("calculateCameraAnglesToPoint", [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(cpp_math::calculateCameraAnglesToPoint(position, angles, targets[i & (batch_size - 1)]));
+      }
+    });
+    registerBenchmark("PointingSolver/per target", [=](uint64_t begin, uint64_t end) mutable {
+      auto solver = cpp_math::PointingSolver(position, angles);
+      for(uint64_t done = begin; done < end; done += batch_size) {
+        auto batch = static_cast<size_t>(std::min<uint64_t>(batch_size, end - done));
+        solver.solve(
+          batch, {arrays.x.data(), arrays.y.data(), arrays.z.data()}, {arrays.yaw.data(), arrays.pitch.data()},
+          arrays.distances.data()
+        );
+        doNotOptimize(arrays.yaw[0]);
+      }
+    });
+  }
+
+  /// @brief Points within 10 km around one origin, one op is one point
+  void registerGeodetic()
+  {
+    auto origin = cpp_math::Geodetic{55.75, 37.62, 150};
+    auto frame = std::make_shared<cpp_math::LocalTangentFrame>(origin);
+    auto offsets = cpp_math_bench::makeVectors(batch_size);
+    struct Arrays
+    {
+      std::vector<double> x, y, z, latitude, longitude, altitude, result_x, result_y, result_z;
+    };
+    auto arrays = std::make_shared<Arrays>();
+    for(auto const& offset : offsets) {
+      auto enu = cpp_math::multiplyVectorByScalar(offset, 10);
+      auto geodetic = frame->enuToGeodetic(enu);
+      auto ecef = frame->enuToEcef(enu);
+      arrays->x.push_back(ecef.x);
+      arrays->y.push_back(ecef.y);
+      arrays->z.push_back(ecef.z);
+      arrays->latitude.push_back(geodetic.latitude);
+      arrays->longitude.push_back(geodetic.longitude);
+      arrays->altitude.push_back(geodetic.altitude);
+    }
+    arrays->result_x.resize(batch_size);
+    arrays->result_y.resize(batch_size);
+    arrays->result_z.resize(batch_size);
+
+    auto runBatches = [](uint64_t begin, uint64_t end, std::function<void(size_t)> const& run) {
+      for(uint64_t done = begin; done < end; done += batch_size) {
+        run(static_cast<size_t>(std::min<uint64_t>(batch_size, end - done)));
+      }
+    };
+    registerBenchmark("geodetic/ecefToEnu per point", [=](uint64_t begin, uint64_t end) {
+      auto& a = *arrays;
+      runBatches(begin, end, [&](size_t count) {
+        frame->ecefToEnu(count, {a.x.data(), a.y.data(), a.z.data()}, {a.result_x.data(), a.result_y.data(), a.result_z.data()});
+        doNotOptimize(a.result_x[0]);
+      });
+    });
+    registerBenchmark("geodetic/geodeticToEcef per point", [=](uint64_t begin, uint64_t end) {
+      auto& a = *arrays;
+      runBatches(begin, end, [&](size_t count) {
+        cpp_math::geodeticToEcef(
+          count, {a.latitude.data(), a.longitude.data(), a.altitude.data()},
+          {a.result_x.data(), a.result_y.data(), a.result_z.data()}
+        );
+        doNotOptimize(a.result_x[0]);
+      });
+    });
+    registerBenchmark("geodetic/ecefToGeodetic", [=](uint64_t begin, uint64_t end) {
+      auto& a = *arrays;
+      for(uint64_t i = begin; i < end; ++i) {
+        auto index = i & (batch_size - 1);
+        doNotOptimize(cpp_math::ecefToGeodetic({a.x[index], a.y[index], a.z[index]}));
+      }
+    });
+    registerBenchmark("geodetic/geodeticToEnu cached frame", [=](uint64_t begin, uint64_t end) {
+      auto& a = *arrays;
+      for(uint64_t i = begin; i < end; ++i) {
+        auto index = i & (batch_size - 1);
+        doNotOptimize(cpp_math::geodeticToEnu({a.latitude[index], a.longitude[index], a.altitude[index]}, origin));
+      }
+    });
+    registerBenchmark("geodetic/LocalTangentFrame construct", [=](uint64_t begin, uint64_t end) {
+      auto& a = *arrays;
+      for(uint64_t i = begin; i < end; ++i) {
+        auto index = i & (batch_size - 1);
+        doNotOptimize(cpp_math::LocalTangentFrame({a.latitude[index], a.longitude[index], a.altitude[index]}));
+      }
+    });
+  }
+
+  /// @brief Covariance of a point from sigmas of distance and every angle, one op is one point
+  void registerUncertainty()
+  {
+    auto heli_angles = cpp_math_bench::makeHeliAngles(Distribution::Random, inputs_count);
+    auto camera_angles = cpp_math_bench::makeCameraAngles(Distribution::Random, inputs_count);
+    auto position = cpp_math::Vector3d{100, -200, 1500};
+    cpp_math::PointInputCovariance covariance{};
+    double const sigmas[] = {0.5, 0, 0, 0, 0.05, 0.05, 0.05, 0.02, 0.02};
+    for(size_t i = 0; i < cpp_math::point_inputs_count; ++i) {
+      covariance[i][i] = sigmas[i] * sigmas[i];
+    }
+
+    // What callers did before: one-sided differences by distance and the five angles
+    registerBenchmark("pointCovariance/finite differences", [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        auto angles = heli_angles[i & inputs_mask];
+        auto camera = camera_angles[i & inputs_mask];
+        auto point = cpp_math::calculatePointByDistanceAndAngles(1000, position, angles, camera);
+        cpp_math::PointJacobian jacobian;
+        auto difference = [&](size_t column, cpp_math::Vector3d const& moved, double delta) {
+          jacobian.columns[column] = {(moved.x - point.x) / delta, (moved.y - point.y) / delta, (moved.z - point.z) / delta};
+        };
+        auto const delta = 1e-6;
+        difference(0, cpp_math::calculatePointByDistanceAndAngles(1000 + delta, position, angles, camera), delta);
+        difference(4, cpp_math::calculatePointByDistanceAndAngles(1000, position, {angles.yaw + delta, angles.pitch, angles.roll}, camera), delta);
+        difference(5, cpp_math::calculatePointByDistanceAndAngles(1000, position, {angles.yaw, angles.pitch + delta, angles.roll}, camera), delta);
+        difference(6, cpp_math::calculatePointByDistanceAndAngles(1000, position, {angles.yaw, angles.pitch, angles.roll + delta}, camera), delta);
+        difference(7, cpp_math::calculatePointByDistanceAndAngles(1000, position, angles, {camera.yaw + delta, camera.pitch}), delta);
+        difference(8, cpp_math::calculatePointByDistanceAndAngles(1000, position, angles, {camera.yaw, camera.pitch + delta}), delta);
+        jacobian.columns[1] = {1, 0, 0};
+        jacobian.columns[2] = {0, 1, 0};
+        jacobian.columns[3] = {0, 0, 1};
+        doNotOptimize(cpp_math::propagateCovariance(jacobian, covariance));
+      }
+    });
+    registerBenchmark("pointCovariance/analytic", [=](uint64_t begin, uint64_t end) {
+      cpp_math::PointJacobian jacobian;
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(cpp_math::calculatePointWithJacobian(
+          1000, position, heli_angles[i & inputs_mask], camera_angles[i & inputs_mask], jacobian
+        ));
+        doNotOptimize(cpp_math::propagateCovariance(jacobian, covariance));
+      }
+    });
+
+    struct Arrays
+    {
+      std::vector<double> distances, x, y, z, yaw, pitch, roll, camera_yaw, camera_pitch, sigma_distance, sigma_angle;
+      std::vector<double> result[9];
+    };
+    auto arrays = std::make_shared<Arrays>();
+    for(size_t i = 0; i < batch_size; ++i) {
+      arrays->distances.push_back(1000);
+      arrays->x.push_back(position.x);
+      arrays->y.push_back(position.y);
+      arrays->z.push_back(position.z);
+      arrays->yaw.push_back(heli_angles[i & inputs_mask].yaw);
+      arrays->pitch.push_back(heli_angles[i & inputs_mask].pitch);
+      arrays->roll.push_back(heli_angles[i & inputs_mask].roll);
+      arrays->camera_yaw.push_back(camera_angles[i & inputs_mask].yaw);
+      arrays->camera_pitch.push_back(camera_angles[i & inputs_mask].pitch);
+      arrays->sigma_distance.push_back(0.5);
+      arrays->sigma_angle.push_back(0.05);
+    }
+    for(auto& result : arrays->result) {
+      result.resize(batch_size);
+    }
+    registerBenchmark("pointCovariance/batch of sigmas per point", [=](uint64_t begin, uint64_t end) {
+      auto& a = *arrays;
+      for(uint64_t done = begin; done < end; done += batch_size) {
+        auto batch = static_cast<size_t>(std::min<uint64_t>(batch_size, end - done));
+        cpp_math::calculatePointsWithCovariance(
+          batch,
+          a.distances.data(),
+          {a.x.data(), a.y.data(), a.z.data()},
+          {a.yaw.data(), a.pitch.data(), a.roll.data()},
+          {a.camera_yaw.data(), a.camera_pitch.data()},
+          cpp_math::PointInputSigmas{
+            a.sigma_distance.data(),
+            {nullptr, nullptr, nullptr},
+            {a.sigma_angle.data(), a.sigma_angle.data(), a.sigma_angle.data()},
+            {a.sigma_angle.data(), a.sigma_angle.data()}
+          },
+          {a.result[0].data(), a.result[1].data(), a.result[2].data()},
+          {a.result[3].data(), a.result[4].data(), a.result[5].data(), a.result[6].data(), a.result[7].data(), a.result[8].data()}
+        );
+        doNotOptimize(a.result[3][0]);
+      }
+    });
+  }
+
+  /// @brief Packing of a smooth 200 Hz trajectory, one op is one block of batch_size poses
+  void registerPacking()
+  {
+    struct Arrays
+    {
+      std::vector<double> x, y, z, yaw, pitch, roll, camera_yaw, camera_pitch;
+      std::vector<uint8_t> micro, centi, buffer;
+    };
+    auto arrays = std::make_shared<Arrays>();
+    auto& a = *arrays;
+    for(size_t i = 0; i < batch_size; ++i) {
+      auto t = static_cast<double>(i) / 200;
+      a.x.push_back(500000 + 50 * t);
+      a.y.push_back(6000000 + 5 * std::sin(t));
+      a.z.push_back(1500 + std::cos(t));
+      a.yaw.push_back(30 + 2 * std::sin(t / 10));
+      a.pitch.push_back(3 * std::sin(t));
+      a.roll.push_back(5 * std::cos(t));
+      a.camera_yaw.push_back(40 * std::sin(t / 3));
+      a.camera_pitch.push_back(-60 + 20 * std::cos(t / 3));
+    }
+    auto centi_options = cpp_math::PackingOptions();
+    centi_options.angle_precision = cpp_math::AnglePrecision::CentiDegrees;
+    auto pack = [](Arrays& a, std::vector<uint8_t>& buffer, size_t count, cpp_math::PackingOptions const& options) {
+      cpp_math::packPoses(
+        count,
+        {a.x.data(), a.y.data(), a.z.data()},
+        {a.yaw.data(), a.pitch.data(), a.roll.data()},
+        {a.camera_yaw.data(), a.camera_pitch.data()},
+        buffer,
+        options
+      );
+    };
+    pack(a, a.micro, batch_size, cpp_math::PackingOptions());
+    pack(a, a.centi, batch_size, centi_options);
+
+    for(auto precision : {cpp_math::AnglePrecision::MicroDegrees, cpp_math::AnglePrecision::CentiDegrees}) {
+      auto options = cpp_math::PackingOptions();
+      options.angle_precision = precision;
+      auto name = std::string(precision == cpp_math::AnglePrecision::MicroDegrees ? "micro-degrees" : "centi-degrees");
+      registerBenchmark("packPoses/" + name + ", block of 1024", [=](uint64_t begin, uint64_t end) {
+        for(uint64_t i = begin; i < end; ++i) {
+          arrays->buffer.clear();
+          pack(*arrays, arrays->buffer, batch_size, options);
+          doNotOptimize(arrays->buffer.back());
+        }
+      });
+      registerBenchmark("unpackPoses/" + name + ", block of 1024", [=](uint64_t begin, uint64_t end) {
+        auto& a = *arrays;
+        auto const& block = precision == cpp_math::AnglePrecision::MicroDegrees ? a.micro : a.centi;
+        for(uint64_t i = begin; i < end; ++i) {
+          cpp_math::unpackPoses(
+            block.data(),
+            block.size(),
+            {a.x.data(), a.y.data(), a.z.data()},
+            {a.yaw.data(), a.pitch.data(), a.roll.data()},
+            {a.camera_yaw.data(), a.camera_pitch.data()}
+          );
+          doNotOptimize(a.x[0]);
+        }
+      });
+    }
+  }
+
+  /// @brief Gimbal raster scan: the heli attitude holds for a row of 500 camera yaw steps, one op is one point
+  void registerPoseContext()
+  {
+    auto heli_angles = cpp_math_bench::makeHeliAngles(Distribution::Random, inputs_count);
+    auto camera_angles = cpp_math_bench::makeCameraAngles(Distribution::Random, inputs_count);
+    auto position = cpp_math::Vector3d{100, -200, 1500};
+    constexpr uint64_t row_size = 500;
+    auto scan_camera = [](uint64_t i) {
+      return cpp_math::CameraAngles{-45 + 0.18 * static_cast<double>(i % row_size), -60 + static_cast<double>(i / row_size % 8)};
+    };
+
+    registerBenchmark("scan/calculatePointByDistanceAndAngles", [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(cpp_math::calculatePointByDistanceAndAngles(
+          1000, position, heli_angles[(i / row_size) & inputs_mask], scan_camera(i)
+        ));
+      }
+    });
+    auto context = std::make_shared<cpp_math::PoseContext>();
+    registerBenchmark("scan/PoseContext", [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(context->calculatePoint(1000, position, heli_angles[(i / row_size) & inputs_mask], scan_camera(i)));
+      }
+    });
+    // Nothing to reuse, the cost of checking the caches
+    registerBenchmark("scan/PoseContext, every angle changes", [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        doNotOptimize(context->calculatePoint(1000, position, heli_angles[i & inputs_mask], camera_angles[i & inputs_mask]));
+      }
+    });
+  }
+
+  /// @brief Six sensors on one heli, one op is one heli pose with targets of every sensor
+  void registerSensorRig()
+  {
+    constexpr size_t sensors_count = 6;
+    auto heli_angles = cpp_math_bench::makeHeliAngles(Distribution::Random, inputs_count);
+    auto camera_angles = cpp_math_bench::makeCameraAngles(Distribution::Random, inputs_count);
+    auto position = cpp_math::Vector3d{100, -200, 1500};
+
+    registerBenchmark("rig/6 sensors, separate calls", [=](uint64_t begin, uint64_t end) {
+      for(uint64_t i = begin; i < end; ++i) {
+        for(size_t sensor = 0; sensor < sensors_count; ++sensor) {
+          doNotOptimize(cpp_math::calculatePointByDistanceAndAngles(
+            1000, position, heli_angles[i & inputs_mask], camera_angles[(i + sensor) & inputs_mask]
+          ));
+        }
+      }
+    });
+
+    struct Arrays
+    {
+      cpp_math::SensorRig rig;
+      std::vector<double> camera_yaw, camera_pitch, distances, x, y, z;
+    };
+    auto arrays = std::make_shared<Arrays>();
+    for(size_t i = 0; i < inputs_count + sensors_count; ++i) {
+      arrays->camera_yaw.push_back(camera_angles[i & inputs_mask].yaw);
+      arrays->camera_pitch.push_back(camera_angles[i & inputs_mask].pitch);
+    }
+    for(size_t sensor = 0; sensor < sensors_count; ++sensor) {
+      arrays->rig.addSensor({cpp_math::makeRotation(cpp_math::Axis::Z, 60.0 * static_cast<double>(sensor)), {0.5, 0, -1}});
+      arrays->distances.push_back(1000);
+    }
+    arrays->x.resize(sensors_count);
+    arrays->y.resize(sensors_count);
+    arrays->z.resize(sensors_count);
+    registerBenchmark("rig/6 sensors, SensorRig", [=](uint64_t begin, uint64_t end) {
+      auto& a = *arrays;
+      for(uint64_t i = begin; i < end; ++i) {
+        auto offset = static_cast<size_t>(i & inputs_mask);
+        a.rig.calculatePoints(
+          position,
+          heli_angles[offset],
+          {a.camera_yaw.data() + offset, a.camera_pitch.data() + offset},
+          a.distances.data(),
+          {a.x.data(), a.y.data(), a.z.data()}
+        );
+        doNotOptimize(a.x[0]);
+      }
+    });
+  }
+
+  /// @brief Sweep of a spinning LiDAR with 32 lasers, one op is one point
+  void registerLidarScan()
+  {
+    constexpr size_t lasers_count = 32;
+    constexpr size_t azimuth_steps = 1024;
+    constexpr size_t sweep_size = lasers_count * azimuth_steps;
+
+    struct Sweep
+    {
+      std::vector<cpp_math::CameraAngles> beam_angles;
+      std::unique_ptr<cpp_math::LidarScanPattern> pattern;
+      cpp_math::PoseTrack track;
+      std::vector<uint32_t> beams;
+      std::vector<double> ranges, timestamps, x, y, z;
+    };
+    auto sweep = std::make_shared<Sweep>();
+    std::vector<double> pitches;
+    for(size_t laser = 0; laser < lasers_count; ++laser) {
+      pitches.push_back(-15 + static_cast<double>(laser));
+    }
+    for(size_t azimuth = 0; azimuth < azimuth_steps; ++azimuth) {
+      for(auto pitch : pitches) {
+        sweep->beam_angles.push_back({360.0 * static_cast<double>(azimuth) / azimuth_steps, pitch});
+      }
+    }
+    cpp_math::SensorMount mount{cpp_math::makeRotation(cpp_math::Axis::Y, 20.0), {0.3, -0.1, -0.8}};
+    sweep->pattern.reset(new cpp_math::LidarScanPattern(cpp_math::LidarScanPattern::spinning(pitches, azimuth_steps, mount)));
+    for(size_t i = 0; i <= 10; ++i) {
+      auto t = 0.01 * static_cast<double>(i);
+      sweep->track.push(t, {50 * t, 2 * t, 300 - t}, {170 + 100 * t, 5 * std::sin(30 * t), -3 + 20 * t});
+    }
+    for(size_t i = 0; i < sweep_size; ++i) {
+      sweep->beams.push_back(static_cast<uint32_t>(i));
+      sweep->ranges.push_back(20 + static_cast<double>(i % 97));
+      sweep->timestamps.push_back(0.1 * static_cast<double>(i) / sweep_size);
+    }
+    sweep->x.resize(sweep_size);
+    sweep->y.resize(sweep_size);
+    sweep->z.resize(sweep_size);
+
+    // What a sweep costs without deskew, one pose for every point
+    registerBenchmark("lidar/point, calculatePointByDistanceAndAngles, no deskew", [=](uint64_t begin, uint64_t end) {
+      auto const& s = *sweep;
+      for(uint64_t i = begin; i < end; ++i) {
+        auto point = static_cast<size_t>(i % sweep_size);
+        doNotOptimize(cpp_math::calculatePointByDistanceAndAngles(s.ranges[point], {0, 0, 300}, {170, 0, -3}, s.beam_angles[point]));
+      }
+    });
+    registerBenchmark("lidar/point, poseAt and rotateVector", [=](uint64_t begin, uint64_t end) {
+      auto const& s = *sweep;
+      for(uint64_t i = begin; i < end; ++i) {
+        auto point = static_cast<size_t>(i % sweep_size);
+        cpp_math::Pose pose{};
+        s.track.poseAt(s.timestamps[point], pose);
+        auto local = mount.lever_arm + s.ranges[point] * s.pattern->beam(s.beams[point]);
+        doNotOptimize(pose.position + cpp_math::rotateVector(local, pose.attitude));
+      }
+    });
+    registerBenchmark("lidar/point, LidarScanPattern::projectSweep", [=](uint64_t begin, uint64_t end) {
+      auto& s = *sweep;
+      while(begin < end) {
+        auto offset = static_cast<size_t>(begin % sweep_size);
+        auto count = std::min(static_cast<size_t>(end - begin), sweep_size - offset);
+        s.pattern->projectSweep(
+          s.track,
+          count,
+          s.beams.data() + offset,
+          s.ranges.data() + offset,
+          s.timestamps.data() + offset,
+          {s.x.data() + offset, s.y.data() + offset, s.z.data() + offset}
+        );
+        doNotOptimize(s.x[offset]);
+        begin += count;
+      }
+    });
+  }
+
+  bool const registered = []() {
+    for(auto distribution : cpp_math_bench::distributions()) {
+      registerRotations(distribution);
+      registerBatch(distribution);
+    }
+    registerMatrices();
+    registerExpressions();
+    registerPointing();
+    registerGeodetic();
+    registerUncertainty();
+    registerPacking();
+    registerPoseContext();
+    registerSensorRig();
+    registerLidarScan();
+    return true;
+  }();
+}  // namespace
@@ -0,0 +1,134 @@
+#include "bench.h"
+
+#include <cpp-math/batch.h>
+#include <cpp-math/executor.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  // 1M points are 96 MiB of input and output, far beyond the caches like real sweeps
+  constexpr size_t points_count = 1 << 20;
+  // Registered benchmarks take single calls for latency, so their batches are smaller
+  constexpr size_t registered_points_count = 1 << 14;
+  constexpr size_t registered_chunk_size = 1024;
+
+  struct Points
+  {
+    std::vector<double> distances, x, y, z, yaw, pitch, roll, camera_yaw, camera_pitch;
+    std::vector<double> result_x, result_y, result_z;
+
+    explicit Points(size_t count)
+    {
+      auto heli_angles = cpp_math_bench::makeHeliAngles(cpp_math_bench::Distribution::Random, count);
+      auto camera_angles = cpp_math_bench::makeCameraAngles(cpp_math_bench::Distribution::Random, count);
+      auto vectors = cpp_math_bench::makeVectors(count);
+      for(size_t i = 0; i < count; ++i) {
+        distances.push_back(100 + static_cast<double>(i & 1023));
+        x.push_back(vectors[i].x);
+        y.push_back(vectors[i].y);
+        z.push_back(vectors[i].z);
+        yaw.push_back(heli_angles[i].yaw);
+        pitch.push_back(heli_angles[i].pitch);
+        roll.push_back(heli_angles[i].roll);
+        camera_yaw.push_back(camera_angles[i].yaw);
+        camera_pitch.push_back(camera_angles[i].pitch);
+      }
+      result_x.resize(count);
+      result_y.resize(count);
+      result_z.resize(count);
+    }
+
+    void calculate(cpp_math::Executor& executor, size_t chunk_size)
+    {
+      cpp_math::calculatePointsByDistanceAndAngles(
+        distances.size(),
+        distances.data(),
+        {x.data(), y.data(), z.data()},
+        {yaw.data(), pitch.data(), roll.data()},
+        {camera_yaw.data(), camera_pitch.data()},
+        {result_x.data(), result_y.data(), result_z.data()},
+        executor,
+        cpp_math::BatchMode::Fast,
+        chunk_size
+      );
+      cpp_math_bench::doNotOptimize(result_x.back());
+    }
+  };
+
+  std::shared_ptr<Points> registeredPoints()
+  {
+    static auto const points = std::make_shared<Points>(registered_points_count);
+    return points;
+  }
+
+  /// @return Points per second over the duration, whole batches only
+  double measure(Points& points, cpp_math::Executor& executor, size_t chunk_size, std::chrono::milliseconds duration)
+  {
+    // Warm up the threads and the pages of the result
+    points.calculate(executor, chunk_size);
+    uint64_t batches = 0;
+    auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    while(elapsed < duration) {
+      points.calculate(executor, chunk_size);
+      ++batches;
+      elapsed = Clock::now() - start;
+    }
+    return static_cast<double>(batches * points.distances.size()) / std::chrono::duration<double>(elapsed).count();
+  }
+
+  // One op is one batch of 16k points in chunks of 1024
+  bool const registered = []() {
+    cpp_math_bench::registerBenchmark("executor/16k points, sequential", [](uint64_t begin, uint64_t end) {
+      auto points = registeredPoints();
+      for(uint64_t i = begin; i < end; ++i) {
+        points->calculate(cpp_math::sequentialExecutor(), registered_chunk_size);
+      }
+    });
+    cpp_math_bench::registerBenchmark("executor/16k points, pool of every core", [](uint64_t begin, uint64_t end) {
+      static cpp_math::ThreadPoolExecutor pool;
+      auto points = registeredPoints();
+      for(uint64_t i = begin; i < end; ++i) {
+        points->calculate(pool, registered_chunk_size);
+      }
+    });
+    return true;
+  }();
+}  // namespace
+
+namespace cpp_math_bench
+{
+
+  void runExecutorScaling(std::chrono::milliseconds duration)
+  {
+    auto points = std::make_shared<Points>(points_count);
+    std::cout << "calculatePointsByDistanceAndAngles on ThreadPoolExecutor, " << points_count << " points, "
+              << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << std::setw(8) << "threads" << std::setw(8) << "pinned" << std::setw(8) << "chunk" << std::setw(16)
+              << "points/s" << std::setw(10) << "speedup" << std::setw(10) << "steals" << "\n";
+    auto sequential = measure(*points, cpp_math::sequentialExecutor(), cpp_math::default_chunk_size, duration);
+    std::cout << std::setw(8) << 1 << std::setw(8) << "-" << std::setw(8) << cpp_math::default_chunk_size << std::setw(16)
+              << std::fixed << std::setprecision(0) << sequential << std::setw(10) << std::setprecision(2) << 1.0
+              << std::setw(10) << 0 << "\n";
+    for(size_t threads = 1; threads <= 64; threads *= 2) {
+      for(auto pinning : {cpp_math::CpuPinning::None, cpp_math::CpuPinning::NumaCompact}) {
+        for(size_t chunk_size : {size_t(1024), cpp_math::default_chunk_size, size_t(16384)}) {
+          cpp_math::ThreadPoolExecutor pool(threads, pinning);
+          auto rate = measure(*points, pool, chunk_size, duration);
+          std::cout << std::setw(8) << threads << std::setw(8) << (pinning == cpp_math::CpuPinning::None ? "no" : "numa")
+                    << std::setw(8) << chunk_size << std::setw(16) << std::setprecision(0) << rate << std::setw(10)
+                    << std::setprecision(2) << rate / sequential << std::setw(10) << pool.steals() << "\n";
+        }
+      }
+    }
+  }
+
+}  // namespace cpp_math_bench
@@ -0,0 +1,118 @@
+#include "bench.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+namespace
+{
+  void printUsage(char const* program)
+  {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --filter <text>        run only benchmarks which name contains text\n"
+              << "  --min-time <seconds>   minimum time of one repetition, 0.05 by default\n"
+              << "  --json <file>          write results as JSON, - for stdout\n"
+              << "  --baseline <file>      compare with JSON written by --json, exit with 1 on regression\n"
+              << "  --tolerance <fraction> allowed slowdown against baseline, 0.5 by default\n"
+              << "  --add-to-baseline <file>  add results of benchmarks missing in the baseline, keep the others\n"
+              << "  --pose-buffer-scaling <ms>  run PoseBuffer reader scaling instead\n"
+              << "  --executor-scaling <ms>     run ThreadPoolExecutor scaling instead\n"
+              << "  --accuracy <samples>        compare with the long double reference instead\n";
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  std::string filter;
+  std::string json_path;
+  std::string baseline_path;
+  std::string add_to_baseline_path;
+  double min_seconds = 0.05;
+  double tolerance = 0.5;
+
+  for(int i = 1; i < argc; ++i) {
+    auto option = std::string(argv[i]);
+    if(i + 1 >= argc) {
+      printUsage(argv[0]);
+      return 2;
+    }
+    auto value = std::string(argv[++i]);
+    if(option == "--filter") {
+      filter = value;
+    } else if(option == "--min-time") {
+      min_seconds = std::atof(value.c_str());
+    } else if(option == "--json") {
+      json_path = value;
+    } else if(option == "--baseline") {
+      baseline_path = value;
+    } else if(option == "--add-to-baseline") {
+      add_to_baseline_path = value;
+    } else if(option == "--tolerance") {
+      tolerance = std::atof(value.c_str());
+    } else if(option == "--pose-buffer-scaling") {
+      cpp_math_bench::runPoseBufferScaling(std::chrono::milliseconds(std::atoi(value.c_str())));
+      return 0;
+    } else if(option == "--executor-scaling") {
+      cpp_math_bench::runExecutorScaling(std::chrono::milliseconds(std::atoi(value.c_str())));
+      return 0;
+    } else if(option == "--accuracy") {
+      cpp_math_bench::runAccuracy(std::strtoul(value.c_str(), nullptr, 10));
+      return 0;
+    } else {
+      printUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  // Absolute timings of another instruction set say nothing about regressions, such baselines are refused
+  auto loadBaseline = [](std::string const& path, std::string& content) {
+    if(path.empty()) {
+      return true;
+    }
+    std::ifstream file(path);
+    if(not file) {
+      std::cerr << "Can not open baseline " << path << "\n";
+      return false;
+    }
+    content = std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    auto simd_level = cpp_math_bench::baselineSimdLevel(content);
+    if(simd_level != cpp_math_bench::currentSimdLevel()) {
+      std::cerr << "Baseline " << path << " was recorded with SIMD level " << (simd_level.empty() ? "unknown" : simd_level)
+                << ", this machine uses " << cpp_math_bench::currentSimdLevel() << ", refusing to use it\n";
+      return false;
+    }
+    return true;
+  };
+  std::string baseline, previous_baseline;
+  if(not loadBaseline(baseline_path, baseline) or not loadBaseline(add_to_baseline_path, previous_baseline)) {
+    return 2;
+  }
+
+  auto results = cpp_math_bench::runBenchmarks(filter, min_seconds);
+  // Keep stdout clean for JSON
+  auto& table_output = json_path == "-" ? std::cerr : std::cout;
+  cpp_math_bench::printResults(results, table_output);
+
+  if(json_path == "-") {
+    cpp_math_bench::writeJson(results, std::cout);
+  } else if(not json_path.empty()) {
+    std::ofstream json(json_path);
+    cpp_math_bench::writeJson(results, json);
+  }
+
+  if(not add_to_baseline_path.empty()) {
+    std::ofstream output(add_to_baseline_path);
+    cpp_math_bench::addToBaseline(results, previous_baseline, output);
+  }
+
+  if(not baseline_path.empty()) {
+    if(not cpp_math_bench::compareWithBaseline(results, baseline, tolerance, table_output)) {
+      std::cerr << "Performance regressed against " << baseline_path << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include "bench.h"
+
+#include <cpp-math/pose_buffer.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  // Telemetry rate of the heli
+  constexpr double writer_rate_hz = 200;
+
+  /**
+   * @brief Writer pushes poses at 200 Hz while readers query poses in the last second
+   * @return Total number of successful queries
+   */
+  uint64_t runReaders(cpp_math::PoseBuffer& buffer, int readers_count, std::chrono::milliseconds duration)
+  {
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> queries(0);
+    auto start = Clock::now();
+    auto seconds = [start]() { return std::chrono::duration<double>(Clock::now() - start).count(); };
+
+    std::thread writer([&]() {
+      for(uint64_t i = 0; not done; ++i) {
+        auto timestamp = static_cast<double>(i) / writer_rate_hz;
+        buffer.push(timestamp, cpp_math::Vector3d{timestamp, 0, 100}, cpp_math::HeliAngles{timestamp, 1, 2});
+        std::this_thread::sleep_until(start + std::chrono::duration<double>((i + 1) / writer_rate_hz));
+      }
+    });
+
+    std::vector<std::thread> readers;
+    for(int reader = 0; reader < readers_count; ++reader) {
+      readers.emplace_back([&, reader]() {
+        std::mt19937_64 generator(reader);
+        std::uniform_real_distribution<double> age(0, 1);
+        uint64_t local_queries = 0;
+        cpp_math::Pose pose;
+        while(not done) {
+          for(int i = 0; i < 1024; ++i) {
+            local_queries += buffer.poseAt(seconds() - age(generator), pose);
+          }
+        }
+        queries += local_queries;
+      });
+    }
+
+    std::this_thread::sleep_for(duration);
+    done = true;
+    writer.join();
+    for(auto& reader : readers) {
+      reader.join();
+    }
+    return queries;
+  }
+
+  bool const registered = cpp_math_bench::registerBenchmark("PoseBuffer/poseAt", [](uint64_t begin, uint64_t end) {
+    static cpp_math::PoseBuffer buffer(1024);
+    static bool const filled = []() {
+      for(int i = 0; i < 1024; ++i) {
+        auto timestamp = static_cast<double>(i) / writer_rate_hz;
+        buffer.push(timestamp, cpp_math::Vector3d{timestamp, 0, 100}, cpp_math::HeliAngles{timestamp, 1, 2});
+      }
+      return true;
+    }();
+    (void)filled;
+    cpp_math::Pose pose;
+    for(uint64_t i = begin; i < end; ++i) {
+      // Timestamps walk over the whole buffer
+      cpp_math_bench::doNotOptimize(buffer.poseAt(static_cast<double>(i & 4095) / 1024, pose));
+      cpp_math_bench::doNotOptimize(pose);
+    }
+  });
+}  // namespace
+
+namespace cpp_math_bench
+{
+
+  void runPoseBufferScaling(std::chrono::milliseconds duration)
+  {
+    std::cout << "PoseBuffer::poseAt reader scaling, writer at " << writer_rate_hz << " Hz\n";
+    std::cout << std::setw(8) << "readers" << std::setw(16) << "queries/s" << std::setw(20)
+              << "queries/s/reader" << "\n";
+    for(int readers = 1; readers <= 32; readers *= 2) {
+      cpp_math::PoseBuffer buffer(1024);
+      auto queries = runReaders(buffer, readers, duration);
+      auto rate = static_cast<double>(queries) / std::chrono::duration<double>(duration).count();
+      std::cout << std::setw(8) << readers << std::setw(16) << std::fixed << std::setprecision(0) << rate
+                << std::setw(20) << rate / readers << "\n";
+    }
+  }
+
+}  // namespace cpp_math_bench
@@ -0,0 +1,139 @@
+#include "bench.h"
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/terrain.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+  using cpp_math_bench::doNotOptimize;
+  using cpp_math_bench::registerBenchmark;
+
+  // 2 x 2 tiles of 2 km with 2 m cells, 4 MB each
+  constexpr double tile_size = 2048;
+  constexpr uint32_t tile_samples = 1025;
+  constexpr int64_t tiles_count = 2;
+  constexpr size_t rays_count = 1024;
+
+  /// @brief Synthetic hills up to about 300 m written to a temporary directory on the first use
+  class Terrain
+  {
+  public:
+    Terrain()
+    {
+      char path[] = "/tmp/cpp-math-bench-terrain-XXXXXX";
+      if(mkdtemp(path) == nullptr) {
+        throw std::runtime_error("Can not create temporary directory");
+      }
+      directory_ = path;
+      auto cell_size = tile_size / (tile_samples - 1);
+      for(int64_t column = 0; column < tiles_count; ++column) {
+        for(int64_t row = 0; row < tiles_count; ++row) {
+          auto origin_x = static_cast<double>(column) * tile_size;
+          auto origin_y = static_cast<double>(row) * tile_size;
+          std::vector<float> heights;
+          for(uint32_t j = 0; j < tile_samples; ++j) {
+            for(uint32_t i = 0; i < tile_samples; ++i) {
+              auto x = origin_x + i * cell_size;
+              auto y = origin_y + j * cell_size;
+              heights.push_back(static_cast<float>(
+                150 + 100 * std::sin(x / 300) * std::cos(y / 450) + 40 * std::sin((x + 2 * y) / 70) + 5 * std::cos(x / 9)
+              ));
+            }
+          }
+          auto file = directory_ + "/" + std::to_string(column) + "_" + std::to_string(row) + ".dem";
+          cpp_math::writeDemTile(
+            file, cpp_math::makeDemTileHeader(tile_samples, tile_samples, origin_x, origin_y, cell_size), heights
+          );
+          files_.push_back(file);
+        }
+      }
+      cache = std::make_unique<cpp_math::DemTileCache>(directory_, tile_size, 8);
+
+      // Rays from the heli at the middle of the tiles, 20 to 60 degrees from nadir in every direction
+      for(size_t i = 0; i < rays_count; ++i) {
+        auto azimuth = static_cast<double>(i) * 2.39996;
+        auto off_nadir = cpp_math::degreesToRadians(20 + 40 * static_cast<double>((i * 37) % rays_count) / rays_count);
+        x.push_back(std::sin(off_nadir) * std::cos(azimuth));
+        y.push_back(std::sin(off_nadir) * std::sin(azimuth));
+        z.push_back(-std::cos(off_nadir));
+      }
+      hit_x.resize(rays_count);
+      hit_y.resize(rays_count);
+      hit_z.resize(rays_count);
+      distances.resize(rays_count);
+    }
+
+    ~Terrain()
+    {
+      cache.reset();
+      for(auto const& file : files_) {
+        std::remove(file.c_str());
+      }
+      rmdir(directory_.c_str());
+    }
+
+    cpp_math::Vector3d const origin{tile_size, tile_size, 1200};
+    std::unique_ptr<cpp_math::DemTileCache> cache;
+    std::vector<double> x, y, z, hit_x, hit_y, hit_z, distances;
+
+  private:
+    std::string directory_;
+    std::vector<std::string> files_;
+  };
+
+  Terrain& terrain()
+  {
+    static Terrain instance;
+    return instance;
+  }
+
+  bool const registered = []() {
+    // One op is one ray in all of them, so ops/s is rays/s
+    registerBenchmark("intersectTerrain/mipmap per ray", [](uint64_t begin, uint64_t end) {
+      auto& t = terrain();
+      for(uint64_t i = begin; i < end; ++i) {
+        auto ray = i % rays_count;
+        doNotOptimize(cpp_math::intersectTerrain(*t.cache, t.origin, {t.x[ray], t.y[ray], t.z[ray]}, 5000));
+      }
+    });
+    registerBenchmark("intersectTerrain/batch per ray", [](uint64_t begin, uint64_t end) {
+      auto& t = terrain();
+      for(uint64_t done = begin; done < end; done += rays_count) {
+        auto batch = static_cast<size_t>(std::min<uint64_t>(rays_count, end - done));
+        cpp_math::intersectTerrain(
+          *t.cache, batch, t.origin, {t.x.data(), t.y.data(), t.z.data()}, 5000,
+          {t.hit_x.data(), t.hit_y.data(), t.hit_z.data()}, t.distances.data()
+        );
+        doNotOptimize(t.distances[0]);
+      }
+    });
+    // What we did without the intersection: points at guessed distances 1 m apart until one is under the ground
+    registerBenchmark("intersectTerrain/1 m steps per ray", [](uint64_t begin, uint64_t end) {
+      auto& t = terrain();
+      for(uint64_t i = begin; i < end; ++i) {
+        auto ray = i % rays_count;
+        auto direction = cpp_math::Vector3d{t.x[ray], t.y[ray], t.z[ray]};
+        double distance = 0;
+        for(; distance < 5000; distance += 1) {
+          auto point = cpp_math::addVectors(t.origin, cpp_math::multiplyVectorByScalar(direction, distance));
+          if(point.z < t.cache->heightAt(point.x, point.y)) {
+            break;
+          }
+        }
+        doNotOptimize(distance);
+      }
+    });
+    return true;
+  }();
+}  // namespace
@@ -0,0 +1,409 @@
+#include "bench.h"
+
+#include <cpp-math/batch.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <random>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CPP_MATH_BENCH_HAS_TSC
+#endif
+
+namespace
+{
+  std::atomic<uint64_t> allocations(0);
+
+  struct Benchmark
+  {
+    std::string name;
+    cpp_math_bench::BenchmarkFunction function;
+  };
+
+  std::vector<Benchmark>& benchmarks()
+  {
+    static std::vector<Benchmark> result;
+    return result;
+  }
+
+  uint64_t readCycles() noexcept
+  {
+#ifdef CPP_MATH_BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+  }
+
+  constexpr int repetitions_count = 5;
+  constexpr size_t latency_samples_count = 20000;
+
+  uint64_t readTimer() noexcept
+  {
+#ifdef CPP_MATH_BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+  }
+
+  /// @brief Timer ticks in one nanosecond, measured against steady_clock
+  double timerTicksPerNs()
+  {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto ticks_before = readTimer();
+    while(Clock::now() - start < std::chrono::milliseconds(20)) {
+    }
+    auto ticks = readTimer() - ticks_before;
+    return static_cast<double>(ticks) / std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  }
+
+  double percentile(std::vector<double>& values, double fraction)
+  {
+    auto index = static_cast<size_t>(fraction * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+  }
+
+  /// @brief Times single calls one by one with different inputs
+  void measureLatency(Benchmark const& benchmark, cpp_math_bench::Result& result)
+  {
+    static auto const ticks_per_ns = timerTicksPerNs();
+    std::vector<double> overheads(1000);
+    for(auto& overhead : overheads) {
+      auto before = readTimer();
+      overhead = static_cast<double>(readTimer() - before);
+    }
+    auto overhead = percentile(overheads, 0.5);
+
+    std::vector<double> samples(latency_samples_count);
+    for(size_t i = 0; i < samples.size(); ++i) {
+      auto before = readTimer();
+      benchmark.function(i, i + 1);
+      auto ticks = static_cast<double>(readTimer() - before);
+      samples[i] = std::max(ticks - overhead, 0.0) / ticks_per_ns;
+    }
+    result.p50_ns = percentile(samples, 0.5);
+    result.p99_ns = percentile(samples, 0.99);
+  }
+
+  cpp_math_bench::Result measure(Benchmark const& benchmark, uint64_t iterations)
+  {
+    using Clock = std::chrono::steady_clock;
+    auto allocations_before = cpp_math_bench::allocationsCount();
+    auto cycles_before = readCycles();
+    auto start = Clock::now();
+    benchmark.function(0, iterations);
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    auto cycles = readCycles() - cycles_before;
+    auto allocations_count = cpp_math_bench::allocationsCount() - allocations_before;
+    auto ops = static_cast<double>(iterations);
+    return {
+      benchmark.name, iterations, elapsed / ops, static_cast<double>(allocations_count) / ops,
+      static_cast<double>(cycles) / ops, 0, 0
+    };
+  }
+
+  /// @brief Finds "key": value in the object and returns the value, NaN if there is no such key
+  double readNumber(std::string const& object, std::string const& key)
+  {
+    auto position = object.find("\"" + key + "\"");
+    if(position == std::string::npos) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    position = object.find(':', position);
+    return std::strtod(object.c_str() + position + 1, nullptr);
+  }
+
+  struct BaselineEntry
+  {
+    double ns_per_op;
+    double allocations_per_op;
+  };
+
+  /// @brief Reads only what writeJson writes, this is not a general JSON parser
+  std::map<std::string, BaselineEntry> readBaseline(std::string const& baseline)
+  {
+    std::map<std::string, BaselineEntry> result;
+    std::string const name_key = "\"name\": \"";
+    for(auto position = baseline.find(name_key); position != std::string::npos;
+        position = baseline.find(name_key, position)) {
+      auto object_begin = baseline.rfind('{', position);
+      auto object_end = baseline.find('}', position);
+      auto name_begin = position + name_key.size();
+      auto name = baseline.substr(name_begin, baseline.find('"', name_begin) - name_begin);
+      auto object = baseline.substr(object_begin, object_end - object_begin);
+      result[name] = {readNumber(object, "ns_per_op"), readNumber(object, "allocations_per_op")};
+      position = object_end;
+    }
+    return result;
+  }
+
+  /// @return Lines of benchmark objects by name, as writeJson wrote them
+  std::map<std::string, std::string> readBaselineLines(std::string const& baseline)
+  {
+    std::map<std::string, std::string> result;
+    std::string const name_key = "{\"name\": \"";
+    for(auto position = baseline.find(name_key); position != std::string::npos;
+        position = baseline.find(name_key, position)) {
+      auto object_end = baseline.find('}', position);
+      auto name_begin = position + name_key.size();
+      auto name = baseline.substr(name_begin, baseline.find('"', name_begin) - name_begin);
+      result[name] = baseline.substr(position, object_end + 1 - position);
+      position = object_end;
+    }
+    return result;
+  }
+
+  std::string formatEntry(cpp_math_bench::Result const& result)
+  {
+    std::ostringstream output;
+    output << "{\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations << std::fixed
+           << std::setprecision(3) << ", \"ns_per_op\": " << result.ns_per_op
+           << ", \"allocations_per_op\": " << result.allocations_per_op << ", \"cycles_per_op\": " << result.cycles_per_op
+           << ", \"p50_ns\": " << result.p50_ns << ", \"p99_ns\": " << result.p99_ns << "}";
+    return output.str();
+  }
+
+  void writeEntries(std::string const& simd_level, std::map<std::string, std::string> const& entries, std::ostream& output)
+  {
+    output << "{\n";
+    output << "  \"simd_level\": \"" << simd_level << "\",\n";
+#ifdef CPP_MATH_BENCH_HAS_TSC
+    output << "  \"cycles\": \"rdtsc\",\n";
+#else
+    output << "  \"cycles\": \"none\",\n";
+#endif
+    output << "  \"benchmarks\": [\n";
+    size_t i = 0;
+    for(auto const& entry : entries) {
+      output << "    " << entry.second << (++i < entries.size() ? "," : "") << "\n";
+    }
+    output << "  ]\n";
+    output << "}\n";
+  }
+}  // namespace
+
+// Every allocation of the program goes through here, so benchmarks can report allocations/op
+void* operator new(std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if(auto result = std::malloc(size == 0 ? 1 : size)) {
+    return result;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+namespace cpp_math_bench
+{
+
+  bool registerBenchmark(std::string name, BenchmarkFunction function)
+  {
+    benchmarks().push_back({std::move(name), std::move(function)});
+    return true;
+  }
+
+  std::vector<Result> runBenchmarks(std::string const& filter, double min_seconds)
+  {
+    auto sorted = benchmarks();
+    std::stable_sort(sorted.begin(), sorted.end(), [](Benchmark const& b1, Benchmark const& b2) {
+      return b1.name < b2.name;
+    });
+
+    std::vector<Result> results;
+    for(auto const& benchmark : sorted) {
+      if(benchmark.name.find(filter) == std::string::npos) {
+        continue;
+      }
+      // Grow the number of iterations until one repetition is long enough
+      uint64_t iterations = 1;
+      auto result = measure(benchmark, iterations);
+      while(result.ns_per_op * static_cast<double>(iterations) < min_seconds * 1e9) {
+        auto elapsed = std::max(result.ns_per_op * static_cast<double>(iterations), 1.0);
+        auto estimate = static_cast<uint64_t>(min_seconds * 1e9 / elapsed * 1.2 * static_cast<double>(iterations));
+        iterations = std::max(iterations * 2, std::min(estimate, iterations * 100));
+        result = measure(benchmark, iterations);
+      }
+      for(int repetition = 1; repetition < repetitions_count; ++repetition) {
+        auto repeated = measure(benchmark, iterations);
+        if(repeated.ns_per_op < result.ns_per_op) {
+          result = repeated;
+        }
+      }
+      measureLatency(benchmark, result);
+      results.push_back(result);
+    }
+    return results;
+  }
+
+  void printResults(std::vector<Result> const& results, std::ostream& output)
+  {
+    size_t name_width = 4;
+    for(auto const& result : results) {
+      name_width = std::max(name_width, result.name.size());
+    }
+    output << std::left << std::setw(static_cast<int>(name_width) + 2) << "name" << std::right
+           << std::setw(12) << "ns/op" << std::setw(12) << "allocs/op" << std::setw(12) << "cycles/op"
+           << std::setw(12) << "p50 ns" << std::setw(12) << "p99 ns" << std::setw(14) << "iterations"
+           << std::setw(14) << "ops/s" << "\n";
+    for(auto const& result : results) {
+      output << std::left << std::setw(static_cast<int>(name_width) + 2) << result.name << std::right
+             << std::fixed << std::setprecision(2) << std::setw(12) << result.ns_per_op << std::setw(12)
+             << result.allocations_per_op << std::setw(12) << result.cycles_per_op << std::setw(12)
+             << result.p50_ns << std::setw(12) << result.p99_ns << std::setw(14) << result.iterations
+             << std::setprecision(0) << std::setw(14) << (result.ns_per_op > 0 ? 1e9 / result.ns_per_op : 0) << "\n";
+    }
+  }
+
+  std::string currentSimdLevel()
+  {
+    using cpp_math::operator<<;
+    std::ostringstream output;
+    output << cpp_math::bestSimdLevel();
+    return output.str();
+  }
+
+  void writeJson(std::vector<Result> const& results, std::ostream& output)
+  {
+    std::map<std::string, std::string> entries;
+    for(auto const& result : results) {
+      entries[result.name] = formatEntry(result);
+    }
+    writeEntries(currentSimdLevel(), entries, output);
+  }
+
+  void addToBaseline(std::vector<Result> const& results, std::string const& baseline, std::ostream& output)
+  {
+    auto entries = readBaselineLines(baseline);
+    for(auto const& result : results) {
+      entries.emplace(result.name, formatEntry(result));
+    }
+    auto simd_level = baselineSimdLevel(baseline);
+    writeEntries(simd_level.empty() ? currentSimdLevel() : simd_level, entries, output);
+  }
+
+  std::string baselineSimdLevel(std::string const& baseline)
+  {
+    std::string const key = "\"simd_level\": \"";
+    auto position = baseline.find(key);
+    if(position == std::string::npos) {
+      return {};
+    }
+    position += key.size();
+    return baseline.substr(position, baseline.find('"', position) - position);
+  }
+
+  bool compareWithBaseline(
+    std::vector<Result> const& results,
+    std::string const& baseline,
+    double tolerance,
+    std::ostream& output
+  )
+  {
+    auto entries = readBaseline(baseline);
+    auto passed = true;
+    for(auto const& result : results) {
+      auto entry = entries.find(result.name);
+      if(entry == entries.end()) {
+        output << "NEW        " << result.name << "\n";
+        continue;
+      }
+      auto ratio = result.ns_per_op / entry->second.ns_per_op;
+      // One time allocations of a benchmark are spread over its iterations, so tiny fractions are ignored
+      auto more_allocations = result.allocations_per_op > entry->second.allocations_per_op + 0.01;
+      auto slower = ratio > 1 + tolerance;
+      passed = passed and not more_allocations and not slower;
+      output << (slower or more_allocations ? "REGRESSED  " : "ok         ") << result.name << std::fixed
+             << std::setprecision(2) << "  " << entry->second.ns_per_op << " -> " << result.ns_per_op
+             << " ns/op (x" << ratio << "), " << entry->second.allocations_per_op << " -> "
+             << result.allocations_per_op << " allocs/op\n";
+    }
+    return passed;
+  }
+
+  uint64_t allocationsCount() noexcept
+  {
+    return allocations.load(std::memory_order_relaxed);
+  }
+
+  std::vector<Distribution> distributions()
+  {
+    return {Distribution::Zero, Distribution::GimbalLock, Distribution::Random};
+  }
+
+  std::string distributionName(Distribution distribution)
+  {
+    switch(distribution) {
+      case Distribution::Zero:
+        return "zero";
+      case Distribution::GimbalLock:
+        return "gimbal";
+      case Distribution::Random:
+        return "random";
+    }
+    return "";
+  }
+
+  std::vector<cpp_math::HeliAngles> makeHeliAngles(Distribution distribution, size_t count)
+  {
+    std::mt19937_64 generator(1);
+    std::uniform_real_distribution<double> angle(-180, 180);
+    std::uniform_real_distribution<double> noise(-1e-9, 1e-9);
+    std::vector<cpp_math::HeliAngles> result(count, cpp_math::HeliAngles{0, 0, 0});
+    for(auto& angles : result) {
+      if(distribution == Distribution::GimbalLock) {
+        angles = {angle(generator), (angle(generator) < 0 ? -90 : 90) + noise(generator), angle(generator)};
+      } else if(distribution == Distribution::Random) {
+        angles = {angle(generator), angle(generator), angle(generator)};
+      }
+    }
+    return result;
+  }
+
+  std::vector<cpp_math::CameraAngles> makeCameraAngles(Distribution distribution, size_t count)
+  {
+    std::mt19937_64 generator(2);
+    std::uniform_real_distribution<double> angle(-180, 180);
+    std::vector<cpp_math::CameraAngles> result(count, cpp_math::CameraAngles{0, 0});
+    for(auto& angles : result) {
+      if(distribution == Distribution::GimbalLock) {
+        angles = {angle(generator), angle(generator) < 0 ? -90.0 : 90.0};
+      } else if(distribution == Distribution::Random) {
+        angles = {angle(generator), angle(generator)};
+      }
+    }
+    return result;
+  }
+
+  std::vector<cpp_math::Vector3d> makeVectors(size_t count)
+  {
+    std::mt19937_64 generator(3);
+    std::uniform_real_distribution<double> coordinate(-10, 10);
+    std::vector<cpp_math::Vector3d> result(count);
+    for(auto& v : result) {
+      v = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    }
+    return result;
+  }
+
+}  // namespace cpp_math_bench
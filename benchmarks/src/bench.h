@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cpp-math/cpp_math.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace cpp_math_bench
+{
+
+  /**
+   * @brief Runs the measured operation for every iteration index in [begin, end)
+   * @note The index selects the input, so single calls for latency go through different inputs
+   */
+  using BenchmarkFunction = std::function<void(uint64_t begin, uint64_t end)>;
+
+  struct Result
+  {
+    std::string name;
+    uint64_t iterations;
+    double ns_per_op;
+    double allocations_per_op;
+    // Reference cycles of the time stamp counter, zero where it is not available
+    double cycles_per_op;
+    // Latency percentiles of single calls, the cost of reading the timer is subtracted
+    double p50_ns;
+    double p99_ns;
+  };
+
+  /**
+   * @brief Adds benchmark to the global list, call it at static initialization
+   * @note One op is one call of the measured function unless the name says otherwise
+   */
+  bool registerBenchmark(std::string name, BenchmarkFunction function);
+
+  /**
+   * @brief Runs every benchmark which name contains filter
+   * @param min_seconds Minimum time of one repetition, the best of several repetitions is reported
+   */
+  std::vector<Result> runBenchmarks(std::string const& filter, double min_seconds);
+
+  void printResults(std::vector<Result> const& results, std::ostream& output);
+  void writeJson(std::vector<Result> const& results, std::ostream& output);
+
+  /**
+   * @brief Writes the baseline with results of benchmarks it does not have yet, entries it has are kept as they are
+   * @note Use it for new benchmarks, so the baseline of others is not re-recorded with noise of this run
+   */
+  void addToBaseline(std::vector<Result> const& results, std::string const& baseline, std::ostream& output);
+
+  /// @return SIMD level recorded in a baseline written by writeJson, empty if it has none
+  std::string baselineSimdLevel(std::string const& baseline);
+
+  /// @return SIMD level of this machine as writeJson records it
+  std::string currentSimdLevel();
+
+  /**
+   * @brief Compares results with baseline written by writeJson
+   * @param tolerance Allowed relative slowdown of ns/op, allocations/op may not grow at all
+   * @return False if any benchmark regressed
+   */
+  bool compareWithBaseline(
+    std::vector<Result> const& results,
+    std::string const& baseline,
+    double tolerance,
+    std::ostream& output
+  );
+
+  /// @brief Number of operator new calls since the start of the program
+  uint64_t allocationsCount() noexcept;
+
+  /// @brief Angles which the benchmarks are run with
+  enum class Distribution
+  {
+    // All angles are zero, rotateVector skips every rotation
+    Zero,
+    // Pitch is about +-90 degrees, yaw and roll are random
+    GimbalLock,
+    // Every angle is uniform in [-180, 180]
+    Random
+  };
+
+  std::vector<Distribution> distributions();
+  std::string distributionName(Distribution distribution);
+
+  /// @brief Deterministic inputs, the size is a power of two so benchmarks can wrap indices with a mask
+  std::vector<cpp_math::HeliAngles> makeHeliAngles(Distribution distribution, size_t count);
+  std::vector<cpp_math::CameraAngles> makeCameraAngles(Distribution distribution, size_t count);
+  std::vector<cpp_math::Vector3d> makeVectors(size_t count);
+
+  /// @brief Prints queries/s of PoseBuffer::poseAt with a writer and growing number of reader threads
+  void runPoseBufferScaling(std::chrono::milliseconds duration);
+
+  /// @brief Prints points/s of batch points on ThreadPoolExecutor with 1 to 64 threads, chunk sizes and pinning
+  void runExecutorScaling(std::chrono::milliseconds duration);
+
+  /// @brief Prints errors against the long double reference and throughput of every function over categories of angles
+  void runAccuracy(size_t samples);
+
+  /// @brief Keeps the compiler from removing calculation of value
+  template<typename T>
+  inline void doNotOptimize(T const& value)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char const* sink;
+    sink = reinterpret_cast<char const*>(&value);
+#endif
+  }
+
+}  // namespace cpp_math_bench
@@ -0,0 +1,142 @@
+"""ctypes bindings of include/cpp-math/c_api.h, no dependencies besides the standard library.
+
+Arrays are any writable buffer of doubles: array.array('d'), bytearray, mmap, ctypes arrays or numpy
+arrays. They are passed to the library in place as a pointer and a stride in bytes, see `strided`.
+"""
+
+import array as _array
+import ctypes
+import ctypes.util
+import os
+
+OK = 0
+INVALID_ARGUMENT = 1
+ERROR = 2
+
+BATCH_FAST = 0
+BATCH_STRICT = 1
+
+TRIG_STANDARD = 0
+TRIG_ULP1 = 1
+TRIG_ABS_ERROR_1E9 = 2
+TRIG_ABS_ERROR_1E6 = 3
+
+DOUBLE_SIZE = ctypes.sizeof(ctypes.c_double)
+
+
+class ConstArray(ctypes.Structure):
+    _fields_ = [("data", ctypes.c_void_p), ("stride", ctypes.c_ssize_t)]
+
+
+class Array(ctypes.Structure):
+    _fields_ = [("data", ctypes.c_void_p), ("stride", ctypes.c_ssize_t)]
+
+
+def address(buffer):
+    """Address of the first byte of a buffer, the buffer is not copied."""
+    if isinstance(buffer, int):
+        return buffer
+    if hasattr(buffer, "ctypes"):
+        return buffer.ctypes.data
+    if isinstance(buffer, _array.array):
+        return buffer.buffer_info()[0]
+    return ctypes.addressof(ctypes.c_char.from_buffer(buffer))
+
+
+def strided(buffer, offset=0, stride=DOUBLE_SIZE, kind=ConstArray):
+    """Element i is the double at byte offset + i * stride of the buffer.
+
+    Column c of an (n, 3) array of points is strided(points, 8 * c, 24), a stride of 0 repeats one value.
+    The result keeps the buffer alive.
+    """
+    result = kind(address(buffer) + offset, stride)
+    result.buffer = buffer
+    return result
+
+
+def output(buffer, offset=0, stride=DOUBLE_SIZE):
+    return strided(buffer, offset, stride, Array)
+
+
+def constant(value):
+    """The same value for every element."""
+    return strided((ctypes.c_double * 1)(value), 0, 0)
+
+
+def columns(buffer, components=3, kind=ConstArray):
+    """Arrays of every component of interleaved records like x, y, z, x, y, z, ..."""
+    return [strided(buffer, DOUBLE_SIZE * c, DOUBLE_SIZE * components, kind) for c in range(components)]
+
+
+def default_library_path():
+    names = ["libcpp-math-c.so", "libcpp-math-c.dylib", "cpp-math-c.dll"]
+    for directory in [os.environ.get("CPP_MATH_C_LIBRARY_DIR", ""), os.path.dirname(os.path.abspath(__file__))]:
+        for name in names:
+            path = os.path.join(directory, name)
+            if directory and os.path.exists(path):
+                return path
+    return ctypes.util.find_library("cpp-math-c")
+
+
+class Library:
+    def __init__(self, path=None):
+        path = path or default_library_path()
+        if path is None:
+            raise OSError("libcpp-math-c not found, pass its path or set CPP_MATH_C_LIBRARY_DIR")
+        self._lib = ctypes.CDLL(path)
+        lib = self._lib
+        lib.cpp_math_last_error.restype = ctypes.c_char_p
+        lib.cpp_math_last_error.argtypes = []
+        lib.cpp_math_simd_level.restype = ctypes.c_char_p
+        lib.cpp_math_simd_level.argtypes = []
+        lib.cpp_math_executor_create.restype = ctypes.c_void_p
+        lib.cpp_math_executor_create.argtypes = [ctypes.c_size_t]
+        lib.cpp_math_executor_destroy.restype = None
+        lib.cpp_math_executor_destroy.argtypes = [ctypes.c_void_p]
+        lib.cpp_math_calculate_points.restype = ctypes.c_int
+        lib.cpp_math_calculate_points.argtypes = [ctypes.c_size_t] + [ConstArray] * 9 + [Array] * 3 + [ctypes.c_int, ctypes.c_void_p]
+        lib.cpp_math_rotate_vectors.restype = ctypes.c_int
+        lib.cpp_math_rotate_vectors.argtypes = [ctypes.c_size_t] + [ConstArray] * 6 + [Array] * 3 + [ctypes.c_int, ctypes.c_void_p]
+
+    def _check(self, status):
+        if status != OK:
+            message = self._lib.cpp_math_last_error().decode()
+            raise (ValueError if status == INVALID_ARGUMENT else RuntimeError)(message)
+
+    def simd_level(self):
+        return self._lib.cpp_math_simd_level().decode()
+
+    def executor(self, threads=0):
+        return Executor(self._lib, threads)
+
+    def calculate_points(self, count, distances, positions, angles, camera_angles, results, mode=BATCH_FAST, executor=None):
+        """positions, angles (yaw, pitch, roll), camera_angles (yaw, pitch) and results are sequences of arrays."""
+        self._check(self._lib.cpp_math_calculate_points(
+            count, distances, *positions, *angles, *camera_angles, *results, mode, executor.handle if executor else None
+        ))
+
+    def rotate_vectors(self, count, vectors, angles, results, policy=TRIG_STANDARD, executor=None):
+        self._check(self._lib.cpp_math_rotate_vectors(
+            count, *vectors, *angles, *results, policy, executor.handle if executor else None
+        ))
+
+
+class Executor:
+    """Thread pool shared by calls, use it in a with statement or call close."""
+
+    def __init__(self, lib, threads):
+        self._lib = lib
+        self.handle = lib.cpp_math_executor_create(threads)
+        if not self.handle:
+            raise RuntimeError(lib.cpp_math_last_error().decode())
+
+    def close(self):
+        if self.handle:
+            self._lib.cpp_math_executor_destroy(self.handle)
+            self.handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
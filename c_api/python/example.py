@@ -0,0 +1,142 @@
+"""Calls libcpp-math-c through ctypes on a million points, checks the results and prints throughput.
+
+Runs offline with the standard library only; the same calls take numpy arrays in place of array.array.
+
+    python3 example.py --library build/c_api/libcpp-math-c.so [--count 1000000] [--threads 0]
+"""
+
+import argparse
+import array
+import math
+import os
+import random
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import cpp_math_c  # noqa: E402
+
+
+def doubles(count, generate):
+    return array.array("d", (generate(i) for i in range(count)))
+
+
+def check(condition, message):
+    if not condition:
+        raise AssertionError(message)
+
+
+def check_known_points(lib):
+    """Single axis rotations have a closed form that is easy to write in Python."""
+    distances = array.array("d", [10, 10, 10, 5])
+    positions = array.array("d", [1, 2, 3] * 4)  # interleaved x, y, z like an (n, 3) numpy array
+    yaw = array.array("d", [90, 30, 0, 0])
+    pitch = array.array("d", [0, 0, 45, 0])
+    camera_yaw = array.array("d", [0, 15, 0, 0])
+    results = array.array("d", [0] * 12)
+    lib.calculate_points(
+        4,
+        cpp_math_c.strided(distances),
+        cpp_math_c.columns(positions),
+        [cpp_math_c.strided(yaw), cpp_math_c.strided(pitch), cpp_math_c.constant(0)],
+        [cpp_math_c.strided(camera_yaw), cpp_math_c.constant(0)],
+        cpp_math_c.columns(results, kind=cpp_math_c.Array),
+        mode=cpp_math_c.BATCH_STRICT,
+    )
+    expected = [
+        (1, 12, 3),
+        (1 + 10 * math.cos(math.radians(45)), 2 + 10 * math.sin(math.radians(45)), 3),
+        (1 + 10 * math.cos(math.radians(45)), 2, 3 - 10 * math.sin(math.radians(45))),
+        (6, 2, 3),
+    ]
+    for i, point in enumerate(expected):
+        for c in range(3):
+            check(abs(results[3 * i + c] - point[c]) < 1e-12, f"point {i}: {results[3 * i:3 * i + 3]} != {point}")
+
+    vectors = array.array("d", [1, 0, 0])
+    rotated = array.array("d", [0, 0, 0])
+    lib.rotate_vectors(
+        1,
+        cpp_math_c.columns(vectors),
+        [cpp_math_c.constant(90), cpp_math_c.constant(0), cpp_math_c.constant(0)],
+        cpp_math_c.columns(rotated, kind=cpp_math_c.Array),
+        policy=cpp_math_c.TRIG_ULP1,
+    )
+    check(list(rotated) == [0, 1, 0], f"rotated {list(rotated)}")
+
+    try:
+        lib.calculate_points(1, *([cpp_math_c.constant(0)] * 1), [cpp_math_c.constant(0)] * 3, [cpp_math_c.constant(0)] * 3,
+                             [cpp_math_c.constant(0)] * 2, cpp_math_c.columns(results, kind=cpp_math_c.Array), mode=7)
+        check(False, "unknown mode accepted")
+    except ValueError as e:
+        check("mode" in str(e), str(e))
+
+
+def timed(name, count, call):
+    call()  # warm up pages and threads
+    best = math.inf
+    for _ in range(3):
+        start = time.perf_counter()
+        call()
+        best = min(best, time.perf_counter() - start)
+    print(f"{name:<40} {count / best / 1e6:8.1f} Mpoints/s  {best * 1e9 / count:6.1f} ns/point")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--library", help="path of libcpp-math-c, searched by default")
+    parser.add_argument("--count", type=int, default=1_000_000)
+    parser.add_argument("--threads", type=int, default=0, help="threads of the executor, 0 for all")
+    args = parser.parse_args()
+
+    lib = cpp_math_c.Library(args.library)
+    print(f"SIMD level: {lib.simd_level()}")
+    check_known_points(lib)
+
+    n = args.count
+    rng = random.Random(24)
+    distances = doubles(n, lambda i: rng.uniform(100, 2000))
+    positions = doubles(3 * n, lambda i: rng.uniform(-1000, 1000))
+    yaw = doubles(n, lambda i: rng.uniform(-180, 180))
+    pitch = doubles(n, lambda i: rng.uniform(-30, 30))
+    roll = doubles(n, lambda i: rng.uniform(-30, 30))
+    camera_yaw = doubles(n, lambda i: rng.uniform(-90, 90))
+    camera_pitch = doubles(n, lambda i: rng.uniform(-90, 0))
+    # Positions and results as interleaved x, y, z records, angles as separate arrays
+    position_columns = cpp_math_c.columns(positions)
+    angles = [cpp_math_c.strided(a) for a in (yaw, pitch, roll)]
+    camera_angles = [cpp_math_c.strided(a) for a in (camera_yaw, camera_pitch)]
+    strided_results = array.array("d", bytes(24 * n))
+    fast_results = [array.array("d", bytes(8 * n)) for _ in range(3)]
+    strict_results = [array.array("d", bytes(8 * n)) for _ in range(3)]
+    contiguous_positions = [array.array("d", positions[c::3]) for c in range(3)]
+
+    def run(results, positions_arrays, mode=cpp_math_c.BATCH_FAST, executor=None):
+        lib.calculate_points(n, cpp_math_c.strided(distances), positions_arrays, angles, camera_angles, results, mode, executor)
+
+    contiguous = ([cpp_math_c.strided(p) for p in contiguous_positions], [cpp_math_c.output(r) for r in fast_results])
+    interleaved = (position_columns, cpp_math_c.columns(strided_results, kind=cpp_math_c.Array))
+
+    with lib.executor(args.threads) as executor:
+        timed("fast, contiguous", n, lambda: run(contiguous[1], contiguous[0]))
+        timed("fast, interleaved xyz", n, lambda: run(interleaved[1], interleaved[0]))
+        timed("fast, contiguous, executor", n, lambda: run(contiguous[1], contiguous[0], executor=executor))
+        timed("fast, interleaved xyz, executor", n, lambda: run(interleaved[1], interleaved[0], executor=executor))
+        timed("strict, contiguous, executor", n,
+              lambda: run([cpp_math_c.output(r) for r in strict_results], contiguous[0], cpp_math_c.BATCH_STRICT, executor))
+
+        # Layouts and threads take the same kernels, fast differs from single calls only by rounding
+        run(interleaved[1], interleaved[0], executor=executor)
+        worst = 0.0
+        for i in range(n):
+            for c in range(3):
+                fast = fast_results[c][i]
+                check(abs(strided_results[3 * i + c] - fast) <= 1e-9, f"layouts differ at {i}")
+                worst = max(worst, abs(fast - strict_results[c][i]))
+        check(worst < 1e-9, f"fast and strict differ by {worst}")
+    print(f"max |fast - strict|: {worst:.3g} m")
+    print("OK")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,230 @@
+#include <cpp-math/c_api.h>
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/executor.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+struct cpp_math_executor
+{
+  explicit cpp_math_executor(size_t threads) : pool(threads) {}
+
+  cpp_math::ThreadPoolExecutor pool;
+};
+
+namespace
+{
+  using namespace cpp_math;
+
+  // Strided inputs are gathered into blocks of this size, small enough for the stacks of pool threads
+  constexpr size_t block_size = 256;
+
+  thread_local std::string last_error;
+
+  struct InvalidArgument : std::runtime_error
+  {
+    using std::runtime_error::runtime_error;
+  };
+
+  double const& at(cpp_math_const_array const& array, size_t i) noexcept
+  {
+    return *reinterpret_cast<double const*>(reinterpret_cast<char const*>(array.data) + static_cast<ptrdiff_t>(i) * array.stride);
+  }
+
+  double& at(cpp_math_array const& array, size_t i) noexcept
+  {
+    return *reinterpret_cast<double*>(reinterpret_cast<char*>(array.data) + static_cast<ptrdiff_t>(i) * array.stride);
+  }
+
+  template<class Array>
+  bool contiguous(Array const& array) noexcept
+  {
+    return array.stride == static_cast<ptrdiff_t>(sizeof(double));
+  }
+
+  template<class Array>
+  void checkArray(size_t count, Array const& array, char const* name)
+  {
+    if(count > 0 && array.data == nullptr) {
+      throw InvalidArgument(std::string(name) + " is null");
+    }
+  }
+
+  Executor& executorOf(cpp_math_executor* executor) noexcept
+  {
+    if(executor == nullptr) {
+      return sequentialExecutor();
+    }
+    return executor->pool;
+  }
+
+  /// @brief Exceptions must not cross the C boundary, they become a status and the message of cpp_math_last_error
+  template<class Call>
+  cpp_math_status guarded(Call const& call) noexcept
+  {
+    try {
+      call();
+      return CPP_MATH_OK;
+    } catch(InvalidArgument const& e) {
+      last_error = e.what();
+      return CPP_MATH_INVALID_ARGUMENT;
+    } catch(std::exception const& e) {
+      last_error = e.what();
+      return CPP_MATH_ERROR;
+    } catch(...) {
+      last_error = "unknown error";
+      return CPP_MATH_ERROR;
+    }
+  }
+}  // namespace
+
+extern "C"
+{
+  char const* cpp_math_last_error(void)
+  {
+    return last_error.c_str();
+  }
+
+  char const* cpp_math_simd_level(void)
+  {
+    switch(bestSimdLevel()) {
+      case SimdLevel::None: return "none";
+      case SimdLevel::Sse2: return "sse2";
+      case SimdLevel::Avx2: return "avx2";
+      case SimdLevel::Avx512: return "avx512";
+    }
+    return "unknown";
+  }
+
+  cpp_math_executor* cpp_math_executor_create(size_t threads)
+  {
+    cpp_math_executor* executor = nullptr;
+    guarded([&]() { executor = new cpp_math_executor(threads); });
+    return executor;
+  }
+
+  void cpp_math_executor_destroy(cpp_math_executor* executor)
+  {
+    delete executor;
+  }
+
+  cpp_math_status cpp_math_calculate_points(
+    size_t count,
+    cpp_math_const_array distances,
+    cpp_math_const_array position_x,
+    cpp_math_const_array position_y,
+    cpp_math_const_array position_z,
+    cpp_math_const_array yaw,
+    cpp_math_const_array pitch,
+    cpp_math_const_array roll,
+    cpp_math_const_array camera_yaw,
+    cpp_math_const_array camera_pitch,
+    cpp_math_array result_x,
+    cpp_math_array result_y,
+    cpp_math_array result_z,
+    cpp_math_batch_mode mode,
+    cpp_math_executor* executor
+  )
+  {
+    return guarded([&]() {
+      cpp_math_const_array const inputs[] = {distances, position_x, position_y, position_z, yaw, pitch, roll, camera_yaw, camera_pitch};
+      char const* const input_names[] = {"distances", "position_x", "position_y", "position_z", "yaw", "pitch", "roll", "camera_yaw", "camera_pitch"};
+      cpp_math_array const results[] = {result_x, result_y, result_z};
+      char const* const result_names[] = {"result_x", "result_y", "result_z"};
+      for(size_t k = 0; k < 9; ++k) {
+        checkArray(count, inputs[k], input_names[k]);
+      }
+      for(size_t k = 0; k < 3; ++k) {
+        checkArray(count, results[k], result_names[k]);
+      }
+      if(mode != CPP_MATH_BATCH_FAST && mode != CPP_MATH_BATCH_STRICT) {
+        throw InvalidArgument("Unknown batch mode " + std::to_string(static_cast<int>(mode)));
+      }
+      auto const batch_mode = mode == CPP_MATH_BATCH_FAST ? BatchMode::Fast : BatchMode::Strict;
+
+      if(std::all_of(std::begin(inputs), std::end(inputs), contiguous<cpp_math_const_array>) &&
+         std::all_of(std::begin(results), std::end(results), contiguous<cpp_math_array>)) {
+        calculatePointsByDistanceAndAngles(
+          count,
+          distances.data,
+          {position_x.data, position_y.data, position_z.data},
+          {yaw.data, pitch.data, roll.data},
+          {camera_yaw.data, camera_pitch.data},
+          {result_x.data, result_y.data, result_z.data},
+          executorOf(executor),
+          batch_mode
+        );
+        return;
+      }
+
+      executorOf(executor).parallelFor(count, default_chunk_size, [&](size_t begin, size_t end) {
+        double in[9][block_size];
+        double out[3][block_size];
+        for(size_t block = begin; block < end; block += block_size) {
+          auto n = std::min(block_size, end - block);
+          for(size_t k = 0; k < 9; ++k) {
+            for(size_t i = 0; i < n; ++i) {
+              in[k][i] = at(inputs[k], block + i);
+            }
+          }
+          calculatePointsByDistanceAndAngles(
+            n, in[0], {in[1], in[2], in[3]}, {in[4], in[5], in[6]}, {in[7], in[8]}, {out[0], out[1], out[2]}, batch_mode
+          );
+          for(size_t k = 0; k < 3; ++k) {
+            for(size_t i = 0; i < n; ++i) {
+              at(results[k], block + i) = out[k][i];
+            }
+          }
+        }
+      });
+    });
+  }
+
+  cpp_math_status cpp_math_rotate_vectors(
+    size_t count,
+    cpp_math_const_array x,
+    cpp_math_const_array y,
+    cpp_math_const_array z,
+    cpp_math_const_array yaw,
+    cpp_math_const_array pitch,
+    cpp_math_const_array roll,
+    cpp_math_array result_x,
+    cpp_math_array result_y,
+    cpp_math_array result_z,
+    cpp_math_trig_policy policy,
+    cpp_math_executor* executor
+  )
+  {
+    return guarded([&]() {
+      checkArray(count, x, "x");
+      checkArray(count, y, "y");
+      checkArray(count, z, "z");
+      checkArray(count, yaw, "yaw");
+      checkArray(count, pitch, "pitch");
+      checkArray(count, roll, "roll");
+      checkArray(count, result_x, "result_x");
+      checkArray(count, result_y, "result_y");
+      checkArray(count, result_z, "result_z");
+      TrigPolicy trig_policy;
+      switch(policy) {
+        case CPP_MATH_TRIG_STANDARD: trig_policy = TrigPolicy::Standard; break;
+        case CPP_MATH_TRIG_ULP1: trig_policy = TrigPolicy::Ulp1; break;
+        case CPP_MATH_TRIG_ABS_ERROR_1E9: trig_policy = TrigPolicy::AbsError1e9; break;
+        case CPP_MATH_TRIG_ABS_ERROR_1E6: trig_policy = TrigPolicy::AbsError1e6; break;
+        default: throw InvalidArgument("Unknown trig policy " + std::to_string(static_cast<int>(policy)));
+      }
+
+      executorOf(executor).parallelFor(count, default_chunk_size, [&](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; ++i) {
+          auto rotated = rotateVector(Vector3d{at(x, i), at(y, i), at(z, i)}, HeliAngles{at(yaw, i), at(pitch, i), at(roll, i)}, trig_policy);
+          at(result_x, i) = rotated.x;
+          at(result_y, i) = rotated.y;
+          at(result_z, i) = rotated.z;
+        }
+      });
+    });
+  }
+}  // extern "C"
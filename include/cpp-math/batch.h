@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/executor.h>
+
+#include <cstddef>
+
+namespace cpp_math
+{
+
+  /// @brief Structure of arrays with coordinates of many vectors, element i is {x[i], y[i], z[i]}
+  struct Vector3dArrays
+  {
+    double* x;
+    double* y;
+    double* z;
+  };
+
+  struct ConstVector3dArrays
+  {
+    double const* x;
+    double const* y;
+    double const* z;
+  };
+
+  /// @brief Structure of arrays with heli angles, see HeliAngles for the meaning of every angle
+  struct HeliAnglesArrays
+  {
+    double const* yaw;
+    double const* pitch;
+    double const* roll;
+  };
+
+  /// @brief Structure of arrays with camera angles, see CameraAngles for the meaning of every angle
+  struct CameraAnglesArrays
+  {
+    double const* yaw;
+    double const* pitch;
+  };
+
+  enum class BatchMode
+  {
+    // Closed form rotation evaluated with SIMD. Differs from the single call functions
+    // only by rounding (a few ULP)
+    Fast,
+    // Every element goes through the single call function, results are bit-for-bit identical
+    Strict
+  };
+
+  enum class SimdLevel
+  {
+    None,
+    Sse2,
+    Avx2,
+    Avx512
+  };
+
+  /// @return The widest instruction set supported both by the CPU and by this build of the library
+  SimdLevel bestSimdLevel();
+
+  /**
+   * @brief Batch version of calculatePointByDistanceAndAngles
+   * @param count Number of elements in every array
+   * @param distances Distances to searched points
+   * @param initial_positions Points from which the distances are measured
+   * @param angles Angles of the heli
+   * @param camera_angles Cameras angles
+   * @param result Caller provided arrays which receive coordinates of the points, may not overlap inputs
+   * @param mode Fast uses SIMD kernel chosen by bestSimdLevel, Strict gives the same bits as single calls
+   */
+  void calculatePointsByDistanceAndAngles(
+    size_t count,
+    double const* distances,
+    ConstVector3dArrays initial_positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    Vector3dArrays result,
+    BatchMode mode = BatchMode::Fast
+  );
+
+  /// @brief Same as above but uses the given SIMD level in Fast mode. It is lowered to bestSimdLevel if not supported
+  void calculatePointsByDistanceAndAngles(
+    size_t count,
+    double const* distances,
+    ConstVector3dArrays initial_positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    Vector3dArrays result,
+    SimdLevel simd_level
+  );
+
+  /**
+   * @brief Same as above but chunks of chunk_size points run on the executor
+   * @note Results do not depend on the number of threads, only on the chunk size (see Executor)
+   */
+  void calculatePointsByDistanceAndAngles(
+    size_t count,
+    double const* distances,
+    ConstVector3dArrays initial_positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    Vector3dArrays result,
+    Executor& executor,
+    BatchMode mode = BatchMode::Fast,
+    size_t chunk_size = default_chunk_size
+  );
+
+  /// @brief Batch version of composeRotations, result[i] = composeRotations(first[i], second[i])
+  void composeRotations(
+    size_t count,
+    Mat3 const* first,
+    Mat3 const* second,
+    Mat3* result,
+    Executor& executor = sequentialExecutor(),
+    size_t chunk_size = default_chunk_size
+  );
+
+  std::ostream& operator<<(std::ostream& os, SimdLevel level);
+
+}  // namespace cpp_math
@@ -0,0 +1,124 @@
+#pragma once
+
+/**
+ * @brief C interface of the batch functions for callers from other languages (Python ctypes, cffi, Rust, ...),
+ *        built as the shared library cpp-math-c.
+ * Arrays are passed as a pointer and a stride in bytes, so numpy arrays of any layout are used in place:
+ * a column of an (n, 3) array of points is {data + column * 8, 24}, a contiguous array is {data, 8} and
+ * a stride of 0 repeats the same value for every element. Nothing is allocated or copied per element.
+ * Functions never throw, they return a status and cpp_math_last_error describes the failure
+ */
+
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(CPP_MATH_C_API_EXPORTS)
+#  define CPP_MATH_C_API __declspec(dllexport)
+#elif defined(_WIN32)
+#  define CPP_MATH_C_API __declspec(dllimport)
+#else
+#  define CPP_MATH_C_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum cpp_math_status
+{
+  CPP_MATH_OK = 0,
+  // Null array, unknown mode or policy
+  CPP_MATH_INVALID_ARGUMENT = 1,
+  // Any other failure, for example threads could not be started
+  CPP_MATH_ERROR = 2
+} cpp_math_status;
+
+/// @brief See cpp_math::BatchMode
+typedef enum cpp_math_batch_mode
+{
+  CPP_MATH_BATCH_FAST = 0,
+  CPP_MATH_BATCH_STRICT = 1
+} cpp_math_batch_mode;
+
+/// @brief See cpp_math::TrigPolicy
+typedef enum cpp_math_trig_policy
+{
+  CPP_MATH_TRIG_STANDARD = 0,
+  CPP_MATH_TRIG_ULP1 = 1,
+  CPP_MATH_TRIG_ABS_ERROR_1E9 = 2,
+  CPP_MATH_TRIG_ABS_ERROR_1E6 = 3
+} cpp_math_trig_policy;
+
+/// @brief Element i is at (char const*)data + i * stride
+typedef struct cpp_math_const_array
+{
+  double const* data;
+  ptrdiff_t stride;
+} cpp_math_const_array;
+
+typedef struct cpp_math_array
+{
+  double* data;
+  ptrdiff_t stride;
+} cpp_math_array;
+
+/// @brief Thread pool of cpp_math::ThreadPoolExecutor, may be shared by calls from one thread at a time
+typedef struct cpp_math_executor cpp_math_executor;
+
+/// @return Message of the last failed call on this thread, empty if there was none
+CPP_MATH_C_API char const* cpp_math_last_error(void);
+
+/// @return Name of the SIMD kernel used by CPP_MATH_BATCH_FAST, see cpp_math::bestSimdLevel
+CPP_MATH_C_API char const* cpp_math_simd_level(void);
+
+/**
+ * @param threads Number of threads including the calling one, 0 means all hardware threads
+ * @return Executor to pass to batch functions or NULL if it could not be created, see cpp_math_last_error
+ */
+CPP_MATH_C_API cpp_math_executor* cpp_math_executor_create(size_t threads);
+
+/// @brief Joins threads of the executor, NULL is ignored
+CPP_MATH_C_API void cpp_math_executor_destroy(cpp_math_executor* executor);
+
+/**
+ * @brief Batch version of calculatePointByDistanceAndAngles, see cpp_math::calculatePointsByDistanceAndAngles
+ * @param executor Runs chunks of points on its threads, NULL runs them on the calling thread
+ * @note Contiguous arrays go straight to the SIMD kernels, other strides are gathered into small
+ *       blocks on the stack first. Results may not overlap inputs
+ */
+CPP_MATH_C_API cpp_math_status cpp_math_calculate_points(
+  size_t count,
+  cpp_math_const_array distances,
+  cpp_math_const_array position_x,
+  cpp_math_const_array position_y,
+  cpp_math_const_array position_z,
+  cpp_math_const_array yaw,
+  cpp_math_const_array pitch,
+  cpp_math_const_array roll,
+  cpp_math_const_array camera_yaw,
+  cpp_math_const_array camera_pitch,
+  cpp_math_array result_x,
+  cpp_math_array result_y,
+  cpp_math_array result_z,
+  cpp_math_batch_mode mode,
+  cpp_math_executor* executor
+);
+
+/// @brief rotateVector of every element, element i of results may only overlap element i of inputs
+CPP_MATH_C_API cpp_math_status cpp_math_rotate_vectors(
+  size_t count,
+  cpp_math_const_array x,
+  cpp_math_const_array y,
+  cpp_math_const_array z,
+  cpp_math_const_array yaw,
+  cpp_math_const_array pitch,
+  cpp_math_const_array roll,
+  cpp_math_array result_x,
+  cpp_math_array result_y,
+  cpp_math_array result_z,
+  cpp_math_trig_policy policy,
+  cpp_math_executor* executor
+);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/heli_attitude.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace cpp_math
+{
+
+  /**
+   * @brief Pinhole camera with optional Brown-Conrady distortion (the same model OpenCV uses)
+   * @note Camera looks along positive X axis, image columns go to negative Y and rows go to negative Z,
+   *       so the image is seen the usual way from the heli with zero angles
+   * @note Pixel centres have integer coordinates
+   */
+  struct CameraIntrinsics
+  {
+    size_t width, height;
+
+    // Focal lengths in pixels
+    double fx, fy;
+
+    // Principal point in pixels
+    double cx, cy;
+
+    // Radial distortion coefficients, zeros for pinhole
+    double k1, k2, k3;
+
+    // Tangential distortion coefficients, zeros for pinhole
+    double p1, p2;
+  };
+
+  /**
+   * @brief Unit rays of every pixel of the camera, computed once per camera
+   * @note Rays of a frame are the rays of the grid rotated by HeliAttitude::matrix(),
+   *       so the ray through the principal point is the direction calculatePointByDistanceAndAngles uses
+   */
+  class PixelRayGrid
+  {
+  public:
+    explicit PixelRayGrid(CameraIntrinsics const& intrinsics);
+
+    CameraIntrinsics const& intrinsics() const noexcept { return intrinsics_; }
+
+    /// @return Number of pixels, size of the arrays passed to calculate functions
+    size_t size() const noexcept { return x_.size(); }
+
+    /// @brief Pixels are stored by rows
+    size_t index(size_t column, size_t row) const noexcept { return row * intrinsics_.width + column; }
+
+    /// @return Unit ray of the pixel in the camera frame
+    Vector3d ray(size_t column, size_t row) const noexcept;
+
+    ConstVector3dArrays rays() const noexcept { return {x_.data(), y_.data(), z_.data()}; }
+
+    /**
+     * @brief Rotates rays of every pixel into the world frame
+     * @param attitude Attitude of the heli and camera
+     * @param result Arrays of size() elements
+     */
+    void calculateRays(HeliAttitude const& attitude, Vector3dArrays result) const;
+
+    /// @brief Same as above, chunks of pixels run on the executor. Keep one ThreadPoolExecutor for all frames
+    void calculateRays(
+      HeliAttitude const& attitude,
+      Vector3dArrays result,
+      Executor& executor,
+      size_t chunk_size = default_chunk_size
+    ) const;
+
+    /**
+     * @brief Intersects rays of every pixel with the horizontal plane z = ground_z
+     * @param initial_position Position of the camera
+     * @param result Arrays of size() elements, NaN for pixels which look above the horizon
+     */
+    void calculateGroundPoints(
+      HeliAttitude const& attitude,
+      Vector3d const& initial_position,
+      double ground_z,
+      Vector3dArrays result
+    ) const;
+
+    /// @brief Same as above, chunks of pixels run on the executor
+    void calculateGroundPoints(
+      HeliAttitude const& attitude,
+      Vector3d const& initial_position,
+      double ground_z,
+      Vector3dArrays result,
+      Executor& executor,
+      size_t chunk_size = default_chunk_size
+    ) const;
+
+  private:
+    CameraIntrinsics intrinsics_;
+    std::vector<double> x_, y_, z_;
+  };
+
+}  // namespace cpp_math
@@ -9,45 +9,106 @@
 
 #include <vector>
 #include <ostream>
+#include <cstddef>
+#include <type_traits>
 
 namespace cpp_math
 {
 
   using Matrix3d = std::vector<std::vector<double>>;
 
-  struct Vector3d
+  /**
+   * @note Types and functions of this header are templates over the scalar type T.
+   *       Only float and double are instantiated. T defaults to double where it can not be
+   *       deduced from arguments, so calls written for the double only version keep compiling
+   */
+  template<typename T>
+  struct Vector3
+  {
+    T x, y, z;
+  };
+
+  using Vector3d = Vector3<double>;
+  using Vector3f = Vector3<float>;
+
+  namespace detail
+  {
+    template<typename T>
+    struct NonDeducedType
+    {
+      using type = T;
+    };
+  }  // namespace detail
+
+  /// @brief Scalar parameters take T from the vectors next to them, so 2 and 2.0f are fine for any T
+  template<typename T>
+  using NonDeduced = typename detail::NonDeducedType<T>::type;
+
+  /**
+   * @brief Fixed-size 3x3 matrix stored by rows.
+   * @note Unlike Matrix3d it never touches the heap, so it can be passed around by value.
+   * @note It converts implicitly to Matrix3d so code written against Matrix3d keeps compiling.
+   *       The opposite direction is explicit (see toMat3) to keep overload resolution unambiguous
+   */
+  template<typename T>
+  struct alignas(16) BasicMat3
   {
-    double x, y, z;
+    T m[3][3];
+
+    constexpr T* operator[](size_t row) noexcept { return m[row]; }
+    constexpr T const* operator[](size_t row) const noexcept { return m[row]; }
+
+    operator Matrix3d() const
+    {
+      return {
+        {m[0][0], m[0][1], m[0][2]},
+        {m[1][0], m[1][1], m[1][2]},
+        {m[2][0], m[2][1], m[2][2]}
+      };
+    }
   };
 
-  struct HeliAngles
+  using Mat3 = BasicMat3<double>;
+  using Mat3f = BasicMat3<float>;
+
+  static_assert(std::is_trivially_copyable<Mat3>::value, "Mat3 must stay trivially copyable");
+
+  template<typename T>
+  struct BasicHeliAngles
   {
     // This should be in degrees [-inf, inf]
     // Since we use a right-handed coordinate system
     // positive values are counter clockwise if we see
     // towards the thumb finger (Z axis)
-    double yaw;
+    T yaw;
 
     // This should be in degrees [-inf, inf]
     // Since we use a right-handed coordinate system
     // positive values are counter clockwise if we see
     // towards the middle finger
-    double pitch;
+    T pitch;
 
     // This should be in degrees [-inf, inf]
     // Since we use a right-handed coordinate system
     // positive values are counter clockwise if we see
     // towards the index finger
-    double roll;
+    T roll;
   };
 
-  struct CameraAngles
+  using HeliAngles = BasicHeliAngles<double>;
+  using HeliAnglesf = BasicHeliAngles<float>;
+
+  template<typename T>
+  struct BasicCameraAngles
   {
     // These should be in degrees [-inf, inf]
     // Read the comment in HeliAngles
-    double yaw, pitch;
+    T yaw, pitch;
   };
 
+  using CameraAngles = BasicCameraAngles<double>;
+  using CameraAnglesf = BasicCameraAngles<float>;
+
   enum class HeliAngle
   {
     Roll,
@@ -62,18 +123,48 @@ namespace cpp_math
     Z
   };
 
+  /**
+   * @brief How rotation functions calculate sin and cos of angles
+   * @note All policies except Standard work in degrees and reduce the angle exactly,
+   *       so rotations by multiples of 90 degrees give exact zeros. See sincosDeg
+   */
+  enum class TrigPolicy
+  {
+    // std::sin and std::cos of radians, the default
+    Standard,
+    // Below 1 ULP, degrees are reduced exactly before conversion to radians
+    Ulp1,
+    // Absolute error below 1e-9
+    AbsError1e9,
+    // Absolute error below 1e-6
+    AbsError1e6
+  };
+
   /// @brief This function calculates the point by distance from initial_position and angles from heli and camera at the bottom of the heli which has its own two rotation axes
   /// @param distance Distance to searched point
   /// @param initial_position Point from which the distance is measured
   /// @param angles Angles of the heli (read the comment in HeliAngles)
   /// @param camera_angles Cameras angles
   /// @return Coordinates of the point
-  Vector3d calculatePointByDistanceAndAngles(
-    double distance,
-    Vector3d initial_position,
-    HeliAngles angles,
-    CameraAngles camera_angles
-  );
+  /// @note With float the error grows with distance, it is about 2 cm at 20 km from a position within 1 km.
+  ///       Within about 0.01 degree of multiples of 90 degrees float may apply angles in another order, see rotateVector
+  template<typename T = double>
+  Vector3<T> calculatePointByDistanceAndAngles(
+    NonDeduced<T> distance,
+    Vector3<T> initial_position,
+    BasicHeliAngles<T> angles,
+    BasicCameraAngles<T> camera_angles
+  ) noexcept;
+
+  /// @brief Same as above, but sin and cos are calculated according to the policy
+  template<typename T = double>
+  Vector3<T> calculatePointByDistanceAndAngles(
+    NonDeduced<T> distance,
+    Vector3<T> initial_position,
+    BasicHeliAngles<T> angles,
+    BasicCameraAngles<T> camera_angles,
+    TrigPolicy policy
+  ) noexcept;
 
   /**
    * @brief Rotates vector by angles
@@ -83,26 +174,106 @@ namespace cpp_math
    * @note This function takes care about order in which to rotate the vector. 
    * @note For example if we pass v(1, 0, 0) and angles with roll = 90, pitch = 0, yaw = 45, it will first apply yaw, and only then roll. It is important because if we would apply roll first - we would end up rotating vector around itself which wouldn't reflect any rotation at all. Roll only makes sense after yaw
    * @note If we pass angles with roll = 0, pitch = 0, yaw = 0, it will return the same vector
+   * @note Never allocates memory or throws, so it can be called from real-time code
    */
-  Vector3d rotateVector(Vector3d const& v, HeliAngles const& angles);
+  template<typename T = double>
+  Vector3<T> rotateVector(Vector3<T> const& v, BasicHeliAngles<T> const& angles) noexcept;
+
+  template<typename T = double>
+  Vector3<T> rotateVector(Vector3<T> const& v, BasicHeliAngles<T> const& angles, TrigPolicy policy) noexcept;
+
+  template<typename T = double>
+  Vector3<T> rotateVector(Vector3<T> const& v, Axis axis, NonDeduced<T> angle);
 
-  Vector3d rotateVector(Vector3d const& v, Axis axis, double angle);
+  template<typename T = double>
+  Vector3<T> rotateVector(Vector3<T> const& v, Axis axis, NonDeduced<T> angle, TrigPolicy policy);
 
-  Matrix3d calculateRotationMatrix(Axis axis, double radians);
+  /// @note Returns Mat3, which still converts to Matrix3d for older callers. Use calculateRotationMatrix<float> for Mat3f
+  template<typename T = double>
+  BasicMat3<T> calculateRotationMatrix(Axis axis, NonDeduced<T> radians);
+
+  /// @brief Rotation matrix by angle in degrees, sin and cos are calculated according to the policy
+  /// @note Policies other than Standard calculate sin and cos in double for float too
+  template<typename T = double>
+  BasicMat3<T> calculateRotationMatrixFromDegrees(Axis axis, NonDeduced<T> degrees, TrigPolicy policy);
 
   Axis heliAngleToRotationAxis(HeliAngle angle);
 
-  double degreesToRadians(double degrees);
+  template<typename T = double>
+  T degreesToRadians(NonDeduced<T> degrees) noexcept;
 
-  Vector3d addVectors(Vector3d const& v1, Vector3d const& v2);
-  Vector3d subtractVectors(Vector3d const& v1, Vector3d const& v2);
-  Vector3d multiplyVectorByScalar(Vector3d const& v, double scalar);
+  template<typename T = double>
+  Vector3<T> addVectors(Vector3<T> const& v1, Vector3<T> const& v2) noexcept;
+  template<typename T = double>
+  Vector3<T> subtractVectors(Vector3<T> const& v1, Vector3<T> const& v2) noexcept;
+  template<typename T = double>
+  Vector3<T> multiplyVectorByScalar(Vector3<T> const& v, NonDeduced<T> scalar) noexcept;
   Vector3d multiplyMatrixByVector(Matrix3d const& matrix, Vector3d const& v);
   Matrix3d multiplyMatrices(Matrix3d const& m1, Matrix3d const& m2);
 
-  std::ostream& operator<<(std::ostream& os, Vector3d const& v);
+  /// @throws std::runtime_error if matrix is not 3x3
+  Mat3 toMat3(Matrix3d const& matrix);
+
+  template<typename T = double>
+  constexpr BasicMat3<T> identityMatrix() noexcept
+  {
+    return BasicMat3<T>{{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+  }
+
+  template<typename T>
+  constexpr Vector3<T> multiplyMatrixByVector(BasicMat3<T> const& matrix, Vector3<T> const& v) noexcept
+  {
+    return Vector3<T>{
+      matrix.m[0][0] * v.x + matrix.m[0][1] * v.y + matrix.m[0][2] * v.z,
+      matrix.m[1][0] * v.x + matrix.m[1][1] * v.y + matrix.m[1][2] * v.z,
+      matrix.m[2][0] * v.x + matrix.m[2][1] * v.y + matrix.m[2][2] * v.z
+    };
+  }
+
+  template<typename T>
+  constexpr BasicMat3<T> multiplyMatrices(BasicMat3<T> const& m1, BasicMat3<T> const& m2) noexcept
+  {
+    BasicMat3<T> result{};
+    for(size_t row = 0; row < 3; ++row) {
+      for(size_t col = 0; col < 3; ++col) {
+        result.m[row][col] = m1.m[row][0] * m2.m[0][col] + m1.m[row][1] * m2.m[1][col]
+                           + m1.m[row][2] * m2.m[2][col];
+      }
+    }
+    return result;
+  }
+
+  /// @note For rotation matrices the transpose is the inverse rotation
+  template<typename T>
+  constexpr BasicMat3<T> transposeMatrix(BasicMat3<T> const& matrix) noexcept
+  {
+    BasicMat3<T> result{};
+    for(size_t row = 0; row < 3; ++row) {
+      for(size_t col = 0; col < 3; ++col) {
+        result.m[row][col] = matrix.m[col][row];
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Composes two rotations
+   * @return Matrix which applies first and only then second
+   */
+  template<typename T>
+  constexpr BasicMat3<T> composeRotations(BasicMat3<T> const& first, BasicMat3<T> const& second) noexcept
+  {
+    return multiplyMatrices(second, first);
+  }
+
+  template<typename T>
+  std::ostream& operator<<(std::ostream& os, Vector3<T> const& v);
   std::ostream& operator<<(std::ostream& os, Matrix3d const& matrix);
-  std::ostream& operator<<(std::ostream& os, HeliAngles const& angles);
-  std::ostream& operator<<(std::ostream& os, CameraAngles const& angles);
+  template<typename T>
+  std::ostream& operator<<(std::ostream& os, BasicMat3<T> const& matrix);
+  template<typename T>
+  std::ostream& operator<<(std::ostream& os, BasicHeliAngles<T> const& angles);
+  template<typename T>
+  std::ostream& operator<<(std::ostream& os, BasicCameraAngles<T> const& angles);
 
 }  // namespace cpp_math
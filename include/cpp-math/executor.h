@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cpp_math
+{
+
+  /// @brief Chunk size of batch functions unless the caller passes another one
+  constexpr size_t default_chunk_size = 4096;
+
+  /**
+   * @brief Runs chunks of batch functions, possibly in parallel
+   * @note Chunk boundaries depend only on the count and the chunk size, never on the number of threads.
+   *       Batch functions write every element from exactly one chunk, so their results are the same bits
+   *       with any executor as long as the chunk size is the same
+   */
+  class Executor
+  {
+  public:
+    /// @brief Type erased process(begin, end) of the chunks of [0, count)
+    struct ChunkTask
+    {
+      void const* context;
+      void (*call)(void const* context, size_t begin, size_t end);
+      size_t count;
+      size_t chunk_size;
+
+      // Without count + chunk_size, which overflows for chunk sizes near SIZE_MAX
+      size_t chunksCount() const noexcept { return count / chunk_size + (count % chunk_size != 0); }
+
+      void runChunk(size_t chunk) const
+      {
+        auto begin = chunk * chunk_size;
+        call(context, begin, count - begin > chunk_size ? begin + chunk_size : count);
+      }
+    };
+
+    virtual ~Executor() = default;
+
+    /// @return Number of threads which run chunks, including the calling one
+    virtual size_t concurrency() const noexcept = 0;
+
+    /**
+     * @brief Calls process(begin, end) for chunks [i * chunk_size, (i + 1) * chunk_size) of [0, count) and waits for all of them
+     * @note Chunks may run in any order and on any thread
+     * @note If process throws, chunks which have not started yet are skipped. The first exception is
+     *       rethrown once the running chunks finish
+     */
+    template<class Process>
+    void parallelFor(size_t count, size_t chunk_size, Process const& process)
+    {
+      if(count == 0) {
+        return;
+      }
+      ChunkTask task{
+        &process,
+        [](void const* context, size_t begin, size_t end) { (*static_cast<Process const*>(context))(begin, end); },
+        count,
+        chunk_size == 0 ? default_chunk_size : chunk_size
+      };
+      run(task);
+    }
+
+  protected:
+    virtual void run(ChunkTask const& task) = 0;
+  };
+
+  /// @brief Runs chunks in order on the calling thread
+  class SequentialExecutor final : public Executor
+  {
+  public:
+    size_t concurrency() const noexcept override { return 1; }
+
+  protected:
+    void run(ChunkTask const& task) override;
+  };
+
+  /// @brief Executor of batch functions which do not get one
+  SequentialExecutor& sequentialExecutor() noexcept;
+
+  enum class CpuPinning
+  {
+    // Threads run wherever the OS puts them
+    None,
+    // Worker threads are pinned to CPUs one by one, filling a NUMA node before going to the next one.
+    // Neighbouring chunks start on the same node, so do the caches and memory they touch
+    NumaCompact
+  };
+
+  /**
+   * @brief Pool of threads which share chunks by work stealing
+   * @note Every thread starts with a contiguous range of chunks and takes them from the front.
+   *       A thread which runs out takes half of the rest of another thread's range from the back.
+   *       Ranges are single atomic words, so there are no locks while a batch runs
+   * @note The calling thread works too, so threads - 1 threads are started. One batch runs at a time,
+   *       parallelFor called from a chunk of the same pool runs the nested chunks on the calling thread
+   */
+  class ThreadPoolExecutor final : public Executor
+  {
+  public:
+    /// @param threads Number of threads including the calling one, 0 means std::thread::hardware_concurrency
+    explicit ThreadPoolExecutor(size_t threads = 0, CpuPinning pinning = CpuPinning::None);
+    ~ThreadPoolExecutor() override;
+
+    ThreadPoolExecutor(ThreadPoolExecutor const&) = delete;
+    ThreadPoolExecutor& operator=(ThreadPoolExecutor const&) = delete;
+
+    size_t concurrency() const noexcept override { return threads_count_; }
+
+    /// @return Number of successful steals since construction, for tests and benchmarks
+    uint64_t steals() const noexcept { return steals_.load(std::memory_order_relaxed); }
+
+  protected:
+    void run(ChunkTask const& task) override;
+
+  private:
+    // Chunks [front, back) packed as front << 32 | back. Padded, so ranges of threads do not share
+    // cache lines (alignas would need the aligned new of C++17)
+    struct Range
+    {
+      std::atomic<uint64_t> value;
+      char padding[128 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    void work(size_t index);
+    void workerLoop(size_t index);
+
+    size_t threads_count_;
+    std::unique_ptr<Range[]> ranges_;
+    std::vector<std::thread> threads_;
+
+    std::mutex batch_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    uint64_t generation_;
+    bool stop_;
+
+    ChunkTask const* task_;
+    // First exception of a chunk of the batch, guarded by mutex_
+    std::exception_ptr error_;
+    std::atomic<bool> failed_;
+    std::atomic<size_t> remaining_;
+    std::atomic<size_t> active_;
+    std::atomic<uint64_t> steals_;
+  };
+
+}  // namespace cpp_math
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cpp-math/cpp_math.h>
+
+#include <cstdint>
+
+/**
+ * @brief Rotations by angles known at compile time, for example fixed mount offsets of cameras and sensors.
+ * Everything here is constexpr in C++14, so the matrices are folded into constants and
+ * only the composition with the runtime attitude is left for runtime
+ */
+
+namespace cpp_math
+{
+  namespace detail
+  {
+    struct ConstexprSinCos
+    {
+      double sin, cos;
+    };
+
+    /// @brief sin and cos of |radians| <= pi / 4 by Taylor series, the remainder is below 1e-22
+    constexpr ConstexprSinCos constexprSinCosReduced(double radians) noexcept
+    {
+      double x2 = radians * radians;
+      double sin_value = 0;
+      double cos_value = 0;
+      for(int n = 21; n >= 1; n -= 2) {
+        // Horner scheme, terms x^n / n! for sin and x^(n - 1) / (n - 1)! for cos
+        sin_value = 1 - sin_value * x2 / ((n + 1) * (n + 2));
+        cos_value = 1 - cos_value * x2 / (n * (n + 1));
+      }
+      return {radians * sin_value, cos_value};
+    }
+
+    /**
+     * @brief sin and cos of angle in degrees, usable in constant expressions
+     * @note Angle is reduced to [-45, 45] by a multiple of 90, which is exact, so multiples of 90 give exact zeros.
+     *       Results are within a couple of ULP from std::sin and std::cos
+     */
+    constexpr ConstexprSinCos constexprSinCosDeg(double degrees) noexcept
+    {
+      auto quotient = degrees / 90;
+      auto quadrant = static_cast<int64_t>(quotient < 0 ? quotient - 0.5 : quotient + 0.5);
+      auto reduced = constexprSinCosReduced((degrees - 90.0 * static_cast<double>(quadrant)) * (3.14159265358979323846 / 180));
+      switch(((quadrant % 4) + 4) % 4) {
+        case 0: return {reduced.sin, reduced.cos};
+        case 1: return {reduced.cos, -reduced.sin};
+        case 2: return {-reduced.sin, -reduced.cos};
+        default: return {-reduced.cos, reduced.sin};
+      }
+    }
+  }  // namespace detail
+
+  /**
+   * @brief Rotation matrix by angle in degrees, the same as calculateRotationMatrixFromDegrees up to a couple of ULP
+   * @note Use it to initialize constexpr matrices: constexpr auto mount = makeRotation(Axis::Y, -2.5);
+   *       Reduction is exact for angles within +-1e15 degrees
+   */
+  template<typename T = double>
+  constexpr BasicMat3<T> makeRotation(Axis axis, NonDeduced<T> degrees) noexcept
+  {
+    auto sin_cos = detail::constexprSinCosDeg(static_cast<double>(degrees));
+    auto s = static_cast<T>(sin_cos.sin);
+    auto c = static_cast<T>(sin_cos.cos);
+    switch(axis) {
+      case Axis::X: return BasicMat3<T>{{{1, 0, 0}, {0, c, -s}, {0, s, c}}};
+      case Axis::Y: return BasicMat3<T>{{{c, 0, s}, {0, 1, 0}, {-s, 0, c}}};
+      case Axis::Z: return BasicMat3<T>{{{c, -s, 0}, {s, c, 0}, {0, 0, 1}}};
+    }
+    return identityMatrix<T>();
+  }
+
+  /**
+   * @brief Rotation which applies roll, then pitch, then yaw
+   * @note This is the order rotateVector uses for vectors which are not on rotation axes,
+   *       but unlike rotateVector it does not look for another order for degenerate cases
+   */
+  template<typename T = double>
+  constexpr BasicMat3<T> makeRotation(BasicHeliAngles<T> const& angles) noexcept
+  {
+    return composeRotations(
+      composeRotations(makeRotation<T>(Axis::X, angles.roll), makeRotation<T>(Axis::Y, angles.pitch)),
+      makeRotation<T>(Axis::Z, angles.yaw)
+    );
+  }
+
+  /**
+   * @brief Rotation by a fixed angle given as a fraction of degrees, since C++14 does not allow double template parameters
+   * @note FixedRotation<Axis::Y, -5, 2>::matrix() is a constant rotation by -2.5 degrees around Y
+   */
+  template<Axis axis, int64_t degrees_numerator, int64_t degrees_denominator = 1, typename T = double>
+  struct FixedRotation
+  {
+    static_assert(degrees_denominator != 0, "Denominator of the angle must not be zero");
+
+    static constexpr T degrees() noexcept
+    {
+      return static_cast<T>(static_cast<double>(degrees_numerator) / static_cast<double>(degrees_denominator));
+    }
+
+    static constexpr BasicMat3<T> matrix() noexcept { return makeRotation<T>(axis, degrees()); }
+
+    /// @brief Applies the fixed rotation first and then the runtime one, for example mount and then heli attitude
+    static constexpr BasicMat3<T> then(BasicMat3<T> const& runtime_rotation) noexcept
+    {
+      return composeRotations(matrix(), runtime_rotation);
+    }
+
+    static constexpr Vector3<T> apply(Vector3<T> const& v) noexcept { return multiplyMatrixByVector(matrix(), v); }
+  };
+
+}  // namespace cpp_math
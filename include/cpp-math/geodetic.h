@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+
+#include <cstddef>
+#include <ostream>
+
+/**
+ * @brief Conversions between WGS84 geodetic coordinates, ECEF and local East-North-Up frames.
+ * ENU is right-handed with X to the east, Y to the north and Z up, so it can be the frame of
+ * calculatePointByDistanceAndAngles: yaw 0 looks to the east and yaw 90 to the north
+ */
+
+namespace cpp_math
+{
+
+  struct Geodetic
+  {
+    // Degrees, positive to the north
+    double latitude;
+    // Degrees, positive to the east
+    double longitude;
+    // Meters above the WGS84 ellipsoid
+    double altitude;
+  };
+
+  /// @brief Structure of arrays with geodetic coordinates, see Geodetic
+  struct GeodeticArrays
+  {
+    double const* latitude;
+    double const* longitude;
+    double const* altitude;
+  };
+
+  struct GeodeticResultArrays
+  {
+    double* latitude;
+    double* longitude;
+    double* altitude;
+  };
+
+  namespace wgs84
+  {
+    constexpr double semi_major_axis = 6378137.0;
+    constexpr double flattening = 1 / 298.257223563;
+    constexpr double semi_minor_axis = semi_major_axis * (1 - flattening);
+    // Square of the first eccentricity
+    constexpr double eccentricity2 = flattening * (2 - flattening);
+  }  // namespace wgs84
+
+  Vector3d geodeticToEcef(Geodetic const& point) noexcept;
+
+  /**
+   * @brief Closed form conversion by Heikkinen, no iterations
+   * @note Round trip error is below 1e-12 degrees and 3e-8 m up to 40000 km above the ellipsoid.
+   *       Points within about 50 km of the center of the Earth are out of its domain
+   */
+  Geodetic ecefToGeodetic(Vector3d const& ecef) noexcept;
+
+  /// @brief Batch version, sin and cos go through the SIMD version of sincosDeg
+  void geodeticToEcef(size_t count, GeodeticArrays points, Vector3dArrays result);
+
+  void ecefToGeodetic(size_t count, ConstVector3dArrays ecef, GeodeticResultArrays result) noexcept;
+
+  /**
+   * @brief East-North-Up frame tangent to the ellipsoid at the origin
+   * @note The rotation is calculated once on construction, so conversions between ECEF and ENU
+   *       are a matrix multiplication each. Keep the frame around for points near the same origin
+   */
+  class LocalTangentFrame
+  {
+  public:
+    explicit LocalTangentFrame(Geodetic const& origin) noexcept;
+
+    Geodetic const& origin() const noexcept { return origin_; }
+    Vector3d const& originEcef() const noexcept { return origin_ecef_; }
+
+    /// @brief Rows are east, north and up in ECEF, so it rotates ECEF offsets into ENU
+    Mat3 const& ecefToEnuMatrix() const noexcept { return ecef_to_enu_; }
+
+    Vector3d ecefToEnu(Vector3d const& ecef) const noexcept;
+    Vector3d enuToEcef(Vector3d const& enu) const noexcept;
+
+    Vector3d geodeticToEnu(Geodetic const& point) const noexcept;
+    Geodetic enuToGeodetic(Vector3d const& enu) const noexcept;
+
+    /// @brief Batch versions, result may be the same arrays as the input
+    void ecefToEnu(size_t count, ConstVector3dArrays ecef, Vector3dArrays enu) const noexcept;
+    void enuToEcef(size_t count, ConstVector3dArrays enu, Vector3dArrays ecef) const noexcept;
+
+    void geodeticToEnu(size_t count, GeodeticArrays points, Vector3dArrays enu) const;
+    void enuToGeodetic(size_t count, ConstVector3dArrays enu, GeodeticResultArrays result) const noexcept;
+
+  private:
+    Geodetic origin_;
+    Vector3d origin_ecef_;
+    Mat3 ecef_to_enu_;
+    Mat3 enu_to_ecef_;
+  };
+
+  /**
+   * @brief Single point conversions around an origin which may change between calls
+   * @note Every thread keeps the frame of the last origin, so calls with the same origin do not
+   *       calculate the rotation again
+   */
+  Vector3d geodeticToEnu(Geodetic const& point, Geodetic const& origin) noexcept;
+  Geodetic enuToGeodetic(Vector3d const& enu, Geodetic const& origin) noexcept;
+
+  std::ostream& operator<<(std::ostream& os, Geodetic const& point);
+
+}  // namespace cpp_math
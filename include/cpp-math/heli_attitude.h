@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cpp-math/cpp_math.h>
+
+#include <array>
+#include <cstddef>
+
+namespace cpp_math
+{
+
+  /**
+   * @brief Heli angles resolved into rotation matrices once, so they can be applied to many vectors
+   * @note rotateVector picks the order of rotations for every vector separately (see its notes).
+   *       HeliAttitude keeps this behaviour: it precomputes the composed matrix of every order and
+   *       apply only decides which one to use. No trigonometry or allocations happen after construction
+   */
+  class HeliAttitude
+  {
+  public:
+    /// @param policy How sin and cos of the angles are calculated
+    explicit HeliAttitude(HeliAngles const& angles, TrigPolicy policy = TrigPolicy::Standard);
+
+    /// @brief Camera angles are added to the heli angles the same way calculatePointByDistanceAndAngles does
+    HeliAttitude(
+      HeliAngles const& angles,
+      CameraAngles const& camera_angles,
+      TrigPolicy policy = TrigPolicy::Standard
+    );
+
+    /// @return The same vector as rotateVector(v, angles())
+    Vector3d apply(Vector3d const& v) const noexcept;
+
+    /// @return The same point as calculatePointByDistanceAndAngles with the angles of this attitude
+    Vector3d calculatePoint(double distance, Vector3d const& initial_position) const noexcept;
+
+    /// @return Rotated X axis, the direction the heli (or camera) looks at
+    Vector3d const& direction() const noexcept { return direction_; }
+
+    /// @return Rotation matrix in the order resolved for the X axis, i.e. the one which produces direction()
+    Mat3 const& matrix() const noexcept { return direction_matrix_; }
+
+    /**
+     * @brief The same matrix as HeliAttitude(angles, policy).matrix(), but only the order resolved for
+     *        the X axis is composed, so it is a few times cheaper than constructing HeliAttitude
+     */
+    static Mat3 directionMatrix(HeliAngles const& angles, TrigPolicy policy = TrigPolicy::Standard);
+
+    HeliAngles const& angles() const noexcept { return angles_; }
+
+  private:
+    struct ResolvedOrder
+    {
+      // Rows of the partial rotation before each applied step which give vector components
+      // checked by can_rotate. Steps with zero angle are skipped like rotateVector does
+      std::array<std::array<Vector3d, 2>, 3> check_rows;
+      size_t steps_count;
+      Mat3 composed;
+    };
+
+    size_t findOrder(Vector3d const& v) const noexcept;
+
+    HeliAngles angles_;
+    bool is_zero_;
+    std::array<ResolvedOrder, 6> orders_;
+    Mat3 direction_matrix_;
+    Vector3d direction_;
+  };
+
+}  // namespace cpp_math
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+/**
+ * @brief Counters of the hot paths, compiled in with -DBUILD_cpp-math_INSTRUMENTATION=ON.
+ * Every thread counts into its own counters without atomic read-modify-write, a snapshot sums the counters
+ * of running threads and of threads which have exited. Without the option the hooks are empty inline
+ * functions, the snapshot is all zeros and instrumentationEnabled() is false
+ */
+
+namespace cpp_math
+{
+
+  enum class InstrumentedFunction : uint8_t
+  {
+    // Both angles overloads, float and double
+    RotateVector,
+    CalculatePointByDistanceAndAngles,
+    // Every call of the kernel, so every chunk for the executor overload
+    CalculatePointsByDistanceAndAngles
+  };
+
+  constexpr size_t instrumented_functions_count = 3;
+
+  /// @brief Bucket i counts calls which took [2^i, 2^(i+1)) ns, the first one also counts 0 ns, the last one everything above
+  constexpr size_t latency_buckets_count = 32;
+
+  /// @brief Number of orders rotateVector tries, see rotationOrderName
+  constexpr size_t rotation_orders_count = 6;
+
+  struct FunctionCounters
+  {
+    uint64_t calls = 0;
+    std::array<uint64_t, latency_buckets_count> latency_ns{};
+  };
+
+  struct InstrumentationSnapshot
+  {
+    bool enabled = false;
+    // Threads which have counted anything, including exited ones
+    size_t threads = 0;
+    std::array<FunctionCounters, instrumented_functions_count> functions{};
+    // How many times rotateVector applied the order, an index far from zero means failed orders before it
+    std::array<uint64_t, rotation_orders_count> rotation_orders{};
+    // Orders rotateVector checked, skipped duplicates of failed orders are not counted
+    uint64_t orders_tried = 0;
+    // All angles are zero, nothing to rotate
+    uint64_t zero_angles = 0;
+    // No order could be applied and rotateVector returned the vector unchanged
+    uint64_t fallbacks = 0;
+
+    FunctionCounters const& operator[](InstrumentedFunction function) const noexcept
+    {
+      return functions[static_cast<size_t>(function)];
+    }
+  };
+
+  /// @return true if the library is built with the counters
+  bool instrumentationEnabled() noexcept;
+
+  /// @brief Sums the counters of all threads, counters of running threads may be a few calls behind
+  InstrumentationSnapshot instrumentationSnapshot();
+
+  /// @brief Zeroes the counters of all threads, calls running at the same time may keep their old counts
+  void resetInstrumentation();
+
+  /// @return "roll, pitch, yaw" style name of the order with the index of InstrumentationSnapshot::rotation_orders
+  char const* rotationOrderName(size_t index) noexcept;
+
+  /// @return Name of the function as it is written in JSON
+  char const* instrumentedFunctionName(InstrumentedFunction function) noexcept;
+
+  /// @brief Writes a JSON object with every counter, histograms are arrays of latency_buckets_count numbers
+  void writeInstrumentationJson(InstrumentationSnapshot const& snapshot, std::ostream& output);
+
+}  // namespace cpp_math
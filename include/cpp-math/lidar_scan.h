@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/executor.h>
+#include <cpp-math/pose_buffer.h>
+#include <cpp-math/quaternion.h>
+#include <cpp-math/sensor_rig.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cpp_math
+{
+
+  /**
+   * @brief Timestamped heli poses over a LiDAR sweep, interpolated at the time of every point
+   * @note Plain arrays for one thread, unlike PoseBuffer. Copy the samples covering a sweep here
+   *       (e.g. from PoseBuffer::poseAt) and project the sweep from them
+   * @note Attitudes are stored on the hemisphere of the previous sample, so interpolation between
+   *       neighbours is a plain weighted sum along the shortest path
+   */
+  class PoseTrack
+  {
+  public:
+    /// @throws std::runtime_error if the timestamp is not greater than the last one
+    void push(double timestamp, Pose const& pose);
+
+    /// @brief Pushes quaternionFromHeliAngles(angles), the rotation SensorRig and calculatePointByDistanceAndAngles apply
+    ///        to the X axis
+    void push(double timestamp, Vector3d const& position, HeliAngles const& angles);
+
+    size_t size() const noexcept { return timestamps_.size(); }
+
+    void clear() noexcept;
+
+    std::vector<double> const& timestamps() const noexcept { return timestamps_; }
+
+    ConstVector3dArrays positions() const noexcept { return {x_.data(), y_.data(), z_.data()}; }
+
+    ConstQuaternionArrays attitudes() const noexcept { return {qw_.data(), qx_.data(), qy_.data(), qz_.data()}; }
+
+    /**
+     * @brief Interpolates pose at the timestamp, position linearly and attitude with nlerp
+     * @return false if the timestamp is outside of the samples
+     */
+    bool poseAt(double timestamp, Pose& result) const noexcept;
+
+  private:
+    std::vector<double> timestamps_;
+    std::vector<double> x_, y_, z_;
+    std::vector<double> qw_, qx_, qy_, qz_;
+  };
+
+  /**
+   * @brief Unit directions of the beams of a LiDAR in the heli frame, computed once per scan pattern
+   * @note A beam is given by angles in the sensor frame: the X axis rotated by pitch and then yaw, then
+   *       by the mount rotation into the heli frame. With a constant pose pushed as heli angles a point
+   *       is the one SensorRig::calculatePoints gives for the same mount with beam angles as camera angles
+   */
+  class LidarScanPattern
+  {
+  public:
+    /// @param beams Angles of every beam, index of a beam is its position in the vector
+    LidarScanPattern(std::vector<CameraAngles> const& beams, SensorMount const& mount, TrigPolicy policy = TrigPolicy::Standard);
+
+    /**
+     * @brief Pattern of a spinning LiDAR with a column of lasers
+     * @param laser_pitches Pitch of every laser, positive looks down
+     * @param azimuth_steps Number of firings per revolution, evenly spread over 360 degrees of yaw
+     * @note Beam azimuth * laser_pitches.size() + laser is the laser fired at the azimuth step
+     */
+    static LidarScanPattern spinning(
+      std::vector<double> const& laser_pitches,
+      size_t azimuth_steps,
+      SensorMount const& mount,
+      TrigPolicy policy = TrigPolicy::Standard
+    );
+
+    size_t size() const noexcept { return x_.size(); }
+
+    SensorMount const& mount() const noexcept { return mount_; }
+
+    /// @return Unit direction of the beam in the heli frame
+    Vector3d beam(size_t index) const noexcept { return {x_[index], y_[index], z_[index]}; }
+
+    ConstVector3dArrays beams() const noexcept { return {x_.data(), y_.data(), z_.data()}; }
+
+    /**
+     * @brief Points of a sweep in the world frame, every one projected from the heli pose at its own time
+     * @param track Poses of the heli covering the timestamps of the points
+     * @param count Number of points
+     * @param beams Beam of every point
+     * @param ranges Distance measured by every point
+     * @param timestamps Time of every point, in the units of the track. Any order works, sorted sweeps are the fastest
+     * @param result Arrays of count elements, NaN for points outside of the track
+     * @return Number of points within the track
+     * @throws std::runtime_error if a beam is not in the pattern, nothing is written then
+     * @note point = position(t) + R(t) * (lever_arm + range * beam), where R(t) is the attitude of the track
+     *       interpolated with nlerp. Interpolation and beam lookup run per point, the rotation runs in a
+     *       loop without calls which is vectorized over points
+     * @note Every point is calculated on its own, results do not depend on the executor or the chunk size
+     */
+    size_t projectSweep(
+      PoseTrack const& track,
+      size_t count,
+      uint32_t const* beams,
+      double const* ranges,
+      double const* timestamps,
+      Vector3dArrays result,
+      Executor& executor = sequentialExecutor(),
+      size_t chunk_size = default_chunk_size
+    ) const;
+
+  private:
+    SensorMount mount_;
+    std::vector<double> x_, y_, z_;
+  };
+
+}  // namespace cpp_math
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/pointing.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Compact blocks of poses and points for logs and IPC buffers.
+ * Angles are fixed point of fixed width, so they are converted in vector loops. Positions are integer
+ * ticks of the block resolution, every position is stored as zigzag varint deltas from the previous one
+ * (the first one from the block origin), so a heli moving by less than 8 m between poses takes 6 bytes.
+ * Blocks are in native byte order and may follow each other in one buffer
+ *
+ * Precision loss:
+ * - MicroDegrees angles are within 5e-7 degree, 0.2 mm across at 20 km. CentiDegrees ones within 0.005 degree, 1.7 m at 20 km
+ * - angles are wrapped into [-180, 180], the rotation is the same
+ * - coordinates are within half of the resolution, 0.5 mm by default
+ */
+
+namespace cpp_math
+{
+
+  enum class AnglePrecision : uint8_t
+  {
+    // int32 millionths of degree, 20 bytes per pose
+    MicroDegrees,
+    // int16 hundredths of degree, 10 bytes per pose
+    CentiDegrees
+  };
+
+  enum class PackedBlockKind : uint8_t
+  {
+    // Position, heli angles and camera angles
+    Poses,
+    // Position only
+    Points
+  };
+
+  struct PackingOptions
+  {
+    AnglePrecision angle_precision = AnglePrecision::MicroDegrees;
+    // Meters per tick of positions
+    double position_resolution = 0.001;
+  };
+
+  /**
+   * @brief Header of every block
+   * @note Poses block is followed by count angles of every kind in the order yaw, pitch, roll, camera yaw,
+   *       camera pitch, then by the positions. Points block is followed by the positions
+   */
+  struct PackedBlockHeader
+  {
+    char magic[4];
+    PackedBlockKind kind;
+    AnglePrecision angle_precision;
+    uint16_t reserved;
+    uint32_t count;
+    // Bytes of the whole block including this header
+    uint32_t size;
+    double position_resolution;
+    // Ticks of the position the first delta is taken from
+    int64_t origin[3];
+  };
+
+  /// @brief Structure of arrays which receives heli angles, see HeliAnglesArrays
+  struct HeliAnglesResultArrays
+  {
+    double* yaw;
+    double* pitch;
+    double* roll;
+  };
+
+  /**
+   * @brief Appends a block of poses to the buffer
+   * @note Angles must be finite, coordinates must be within 9e15 ticks
+   * @throws std::runtime_error if the block would be bigger than 4 GiB
+   */
+  void packPoses(
+    size_t count,
+    ConstVector3dArrays positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    std::vector<uint8_t>& buffer,
+    PackingOptions const& options = PackingOptions()
+  );
+
+  /// @brief Appends a block of points to the buffer, angle_precision of options is not used
+  void packPoints(
+    size_t count,
+    ConstVector3dArrays points,
+    std::vector<uint8_t>& buffer,
+    PackingOptions const& options = PackingOptions()
+  );
+
+  /**
+   * @brief Reads the header of the block at data
+   * @throws std::runtime_error if size bytes do not hold a whole block
+   */
+  PackedBlockHeader readPackedBlockHeader(uint8_t const* data, size_t size);
+
+  /**
+   * @brief Unpacks a block of poses, arrays are provided by the caller and hold the count of the header
+   * @return Size of the block, the next block starts there
+   * @throws std::runtime_error if the block is not a whole block of poses
+   */
+  size_t unpackPoses(
+    uint8_t const* data,
+    size_t size,
+    Vector3dArrays positions,
+    HeliAnglesResultArrays angles,
+    CameraAnglesResultArrays camera_angles
+  );
+
+  /// @brief Same as above for a block of points
+  size_t unpackPoints(uint8_t const* data, size_t size, Vector3dArrays points);
+
+}  // namespace cpp_math
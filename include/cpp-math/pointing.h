@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+
+#include <cstddef>
+
+namespace cpp_math
+{
+
+  /// @brief Camera angles which point the camera at a target and the distance to it
+  struct CameraPointing
+  {
+    CameraAngles camera_angles;
+    double distance;
+  };
+
+  /// @brief Structure of arrays which receives camera angles, see CameraAnglesArrays
+  struct CameraAnglesResultArrays
+  {
+    double* yaw;
+    double* pitch;
+  };
+
+  /**
+   * @brief Inverse of calculatePointByDistanceAndAngles: camera angles and distance which give the target
+   * @note rotateVector applies roll between yaw and pitch when the roll is not zero, so the camera can only
+   *       reach directions with |y| <= |cos(roll)|. Angles of unreachable targets are NaN
+   * @note Directions which need yaw of exactly 0 or 180 degrees with a nonzero roll make rotateVector fall back
+   *       to another rotation order. The solver moves them by 1e-12 radians, so they are still reached
+   * @note Camera angles are within [-180, 180]. Of two solutions the one with smaller pitch of the heli and
+   *       the camera together is returned, without roll it is always within [-90, 90]
+   */
+  class PointingSolver
+  {
+  public:
+    PointingSolver(Vector3d const& initial_position, HeliAngles const& angles) noexcept;
+
+    CameraPointing solve(Vector3d const& target) const noexcept;
+
+    /**
+     * @brief Solves every target with the same heli position and angles
+     * @param count Number of elements in every array
+     * @param result Caller provided arrays of camera angles, NaN for unreachable targets
+     * @param distances Caller provided array of distances to targets
+     */
+    void solve(size_t count, ConstVector3dArrays targets, CameraAnglesResultArrays result, double* distances) const noexcept;
+
+  private:
+    Vector3d initial_position_;
+    HeliAngles angles_;
+    bool roll_is_applied_;
+    double roll_sin_, roll_cos_;
+  };
+
+  /// @brief Single target version of PointingSolver
+  CameraPointing calculateCameraAnglesToPoint(
+    Vector3d const& initial_position,
+    HeliAngles const& angles,
+    Vector3d const& target
+  ) noexcept;
+
+}  // namespace cpp_math
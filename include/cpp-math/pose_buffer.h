@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/quaternion.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace cpp_math
+{
+
+  struct Pose
+  {
+    Vector3d position;
+    Quaternion attitude;
+  };
+
+  /**
+   * @brief Ring buffer of timestamped poses with one writer and any number of readers
+   * @note Neither push nor poseAt take locks or allocate. Every slot is guarded by a sequence
+   *       counter (seqlock), readers retry when the writer touches the slot they read
+   * @note Timestamps must be pushed in increasing order, units are up to the caller
+   */
+  class PoseBuffer
+  {
+  public:
+    /**
+     * @param capacity Number of stored poses, rounded up to a power of two.
+     *        Readers see capacity - 1 latest poses, the oldest slot is the one the writer fills next
+     */
+    explicit PoseBuffer(size_t capacity);
+
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+    /// @brief Must only be called from one thread at a time
+    void push(double timestamp, Pose const& pose) noexcept;
+
+    /// @brief Pushes quaternionFromHeliAngles(angles), the rotation calculatePointByDistanceAndAngles applies to the X axis
+    void push(double timestamp, Vector3d const& position, HeliAngles const& angles);
+
+    /**
+     * @brief Interpolates pose at the timestamp, position linearly and attitude with slerp
+     * @param result Receives the pose
+     * @return false if the timestamp is outside of the stored samples
+     */
+    bool poseAt(double timestamp, Pose& result) const noexcept;
+
+    /// @return false if the buffer is empty
+    bool latest(double& timestamp, Pose& result) const noexcept;
+
+  private:
+    static constexpr size_t values_count = 8;
+
+    struct Slot
+    {
+      std::atomic<uint64_t> sequence;
+      std::atomic<uint64_t> index;
+      // timestamp, position and attitude
+      std::atomic<double> values[values_count];
+    };
+
+    struct Sample
+    {
+      double timestamp;
+      Pose pose;
+    };
+
+    /// @return false if the slot no longer holds the sample with the given index
+    bool read(uint64_t index, Sample& sample) const noexcept;
+
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> head_;
+  };
+
+}  // namespace cpp_math
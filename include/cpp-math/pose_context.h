@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cpp-math/cpp_math.h>
+
+#include <array>
+#include <cstdint>
+
+namespace cpp_math
+{
+
+  /// @brief Hits and misses of the caches of PoseContext
+  struct PoseContextStats
+  {
+    // The whole direction was reused, same heli and camera angles as the previous call
+    uint64_t direction_hits = 0;
+    uint64_t direction_misses = 0;
+    // Rotation matrix of one angle was reused, counted only for angles the rotation needed
+    uint64_t rotation_hits = 0;
+    uint64_t rotation_misses = 0;
+  };
+
+  /**
+   * @brief calculatePointByDistanceAndAngles for a stream of poses which change a little from call to call,
+   * like a gimbal scan where the heli attitude stays the same and only camera angles sweep
+   * @note Camera angles are added to heli yaw and pitch before the rotation, so the heli rotation itself
+   *       can not be separated from the camera one. Instead the context remembers the rotation matrix of
+   *       every angle and the resolved direction of the last call. A camera sweeping in yaw only recalculates
+   *       the yaw matrix, the same pose with another distance reuses the direction. The point is the same bits
+   *       as calculatePointByDistanceAndAngles with the policy of the context
+   * @note Not thread safe, use a context per thread
+   */
+  class PoseContext
+  {
+  public:
+    explicit PoseContext(TrigPolicy policy = TrigPolicy::Standard) noexcept;
+
+    Vector3d calculatePoint(
+      double distance,
+      Vector3d const& initial_position,
+      HeliAngles const& angles,
+      CameraAngles const& camera_angles
+    ) noexcept;
+
+    /// @return Rotated X axis, the same as rotateVector({1, 0, 0}, angles with camera angles added)
+    Vector3d const& direction(HeliAngles const& angles, CameraAngles const& camera_angles) noexcept;
+
+    PoseContextStats const& stats() const noexcept { return stats_; }
+
+    void resetStats() noexcept { stats_ = PoseContextStats(); }
+
+    /// @brief Forgets cached rotations, stats are kept
+    void invalidate() noexcept;
+
+  private:
+    struct CachedRotation
+    {
+      bool valid;
+      double degrees;
+      Mat3 matrix;
+    };
+
+    Mat3 const& rotation(HeliAngle angle, double degrees) noexcept;
+
+    TrigPolicy policy_;
+    // Indexed by HeliAngle
+    std::array<CachedRotation, 3> rotations_;
+    bool has_direction_;
+    HeliAngles direction_angles_;
+    Vector3d direction_;
+    PoseContextStats stats_;
+  };
+
+}  // namespace cpp_math
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cpp-math/cpp_math.h>
+
+#include <cstddef>
+#include <ostream>
+
+namespace cpp_math
+{
+
+  /**
+   * @brief Unit quaternion w + xi + yj + zk describing a rotation
+   * @note Rotation by angle around unit axis a is {cos(angle / 2), sin(angle / 2) * a},
+   *       positive angles are counter clockwise like everywhere in this library
+   */
+  struct Quaternion
+  {
+    double w, x, y, z;
+  };
+
+  struct QuaternionArrays
+  {
+    double* w;
+    double* x;
+    double* y;
+    double* z;
+  };
+
+  struct ConstQuaternionArrays
+  {
+    double const* w;
+    double const* x;
+    double const* y;
+    double const* z;
+  };
+
+  constexpr Quaternion identityQuaternion() noexcept
+  {
+    return Quaternion{1, 0, 0, 0};
+  }
+
+  /**
+   * @brief Converts heli angles to quaternion with the convention of the library
+   * @note It is the rotation rotateVector applies to the X axis, HeliAttitude::directionMatrix(angles).
+   *       The heli looks along rotateVector(X, q) where calculatePointByDistanceAndAngles looks
+   */
+  Quaternion quaternionFromHeliAngles(HeliAngles const& angles);
+
+  /**
+   * @brief Rotation by roll first, then by pitch and then by yaw
+   * @note rotateVector uses this order for vectors which are not on rotation axes. For the X axis with
+   *       roll != 0 it differs from quaternionFromHeliAngles
+   */
+  Quaternion quaternionFromRollPitchYaw(HeliAngles const& angles);
+
+  /// @return Angles with yaw and roll in [-180, 180] and pitch in [-90, 90] which give the same rotation with quaternionFromRollPitchYaw
+  HeliAngles rollPitchYawFromQuaternion(Quaternion const& q);
+
+  /// @param matrix Rotation matrix, the result is undefined for anything else
+  Quaternion quaternionFromMatrix(Mat3 const& matrix);
+
+  Mat3 matrixFromQuaternion(Quaternion const& q) noexcept;
+
+  Vector3d rotateVector(Vector3d const& v, Quaternion const& q) noexcept;
+
+  Quaternion multiplyQuaternions(Quaternion const& q1, Quaternion const& q2) noexcept;
+
+  /// @return Quaternion which applies first and only then second
+  Quaternion composeRotations(Quaternion const& first, Quaternion const& second) noexcept;
+
+  /// @brief For unit quaternions this is the inverse rotation
+  Quaternion conjugateQuaternion(Quaternion const& q) noexcept;
+
+  Quaternion normalizeQuaternion(Quaternion const& q) noexcept;
+
+  /**
+   * @brief Spherical linear interpolation, rotates with constant angular velocity from q1 (t = 0) to q2 (t = 1)
+   * @note Always takes the shortest path
+   */
+  Quaternion slerp(Quaternion const& q1, Quaternion const& q2, double t) noexcept;
+
+  /**
+   * @brief Normalized linear interpolation
+   * @note Much cheaper than slerp and close to it for small angles between q1 and q2, e.g. between telemetry samples
+   */
+  Quaternion nlerp(Quaternion const& q1, Quaternion const& q2, double t) noexcept;
+
+  /// @brief Batch slerp, element i of result is slerp(q1[i], q2[i], t[i])
+  void slerp(size_t count, ConstQuaternionArrays q1, ConstQuaternionArrays q2, double const* t, QuaternionArrays result);
+
+  /// @brief Batch nlerp, element i of result is nlerp(q1[i], q2[i], t[i])
+  void nlerp(size_t count, ConstQuaternionArrays q1, ConstQuaternionArrays q2, double const* t, QuaternionArrays result);
+
+  std::ostream& operator<<(std::ostream& os, Quaternion const& q);
+
+}  // namespace cpp_math
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cpp-math/cpp_math.h>
+
+/**
+ * @brief Slow long double versions of the rotations, an oracle to measure how far the double and float
+ * functions and batch kernels drift from the exact result.
+ * Degrees are reduced exactly before sin and cos, so multi-turn angles are as precise as small ones.
+ * Rotation orders are chosen with the thresholds of double (see rotateVector), so near degenerate cases
+ * the reference takes the same decisions as the functions it checks unless their rounding flips them
+ */
+
+namespace cpp_math
+{
+  namespace reference
+  {
+    using LongVector3 = Vector3<long double>;
+
+    void sincosDegrees(long double degrees, long double& sin_result, long double& cos_result) noexcept;
+
+    /// @brief rotateVector in long double, angles are taken as exact values
+    LongVector3 rotateVector(Vector3d const& v, HeliAngles const& angles) noexcept;
+
+    /// @brief calculatePointByDistanceAndAngles in long double, camera angles are added without rounding to double
+    LongVector3 calculatePointByDistanceAndAngles(
+      double distance,
+      Vector3d const& initial_position,
+      HeliAngles const& angles,
+      CameraAngles const& camera_angles
+    ) noexcept;
+
+    /// @return Euclidean distance between the result and the reference
+    long double absoluteError(Vector3d const& result, LongVector3 const& reference) noexcept;
+    long double absoluteError(Vector3f const& result, LongVector3 const& reference) noexcept;
+
+    /**
+     * @return Largest error of a component in units in the last place of the largest component of the reference,
+     *         so components close to zero do not turn tiny absolute errors into huge ULP numbers
+     */
+    double ulpError(Vector3d const& result, LongVector3 const& reference) noexcept;
+
+    /// @brief Same as above in ULP of float
+    double ulpError(Vector3f const& result, LongVector3 const& reference) noexcept;
+  }  // namespace reference
+}  // namespace cpp_math
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace cpp_math
+{
+
+  /// @brief How a sensor is mounted on the heli, both in the heli frame
+  struct SensorMount
+  {
+    // Rotation from the sensor frame into the heli frame, see makeRotation in fixed_rotation.h
+    Mat3 rotation;
+    // Position of the sensor relative to the heli position
+    Vector3d lever_arm;
+  };
+
+  /**
+   * @brief Sensors mounted on one heli, their targets are calculated from one heli pose at once
+   * @note The heli rotation is resolved once per call, composed with every mount rotation and applied
+   *       to camera directions of all sensors in loops over the sensors. Camera angles turn the sensor
+   *       in its own frame: direction = H * mount * C * X, where H is HeliAttitude(angles).matrix() and
+   *       C rotates by camera pitch and then yaw. calculatePointByDistanceAndAngles instead adds camera
+   *       angles to heli angles, the two agree for an identity mount when heli pitch and roll are zero
+   */
+  class SensorRig
+  {
+  public:
+    SensorRig() = default;
+    explicit SensorRig(std::vector<SensorMount> const& mounts);
+
+    /// @return Index of the sensor in arrays of calculatePoints
+    size_t addSensor(SensorMount const& mount);
+
+    size_t size() const noexcept { return lever_x_.size(); }
+
+    SensorMount mount(size_t sensor) const;
+
+    /**
+     * @brief Target of every sensor
+     * @param camera_angles Angles of every sensor in its frame
+     * @param distances Distance to the target of every sensor
+     * @param result Arrays of size() elements
+     * @param policy How sin and cos of heli and camera angles are calculated
+     * @note Does not allocate
+     */
+    void calculatePoints(
+      Vector3d const& initial_position,
+      HeliAngles const& angles,
+      CameraAnglesArrays camera_angles,
+      double const* distances,
+      Vector3dArrays result,
+      TrigPolicy policy = TrigPolicy::Standard
+    ) const;
+
+  private:
+    // Structure of arrays over sensors: rows of mount rotations and lever arms
+    std::vector<double> mount_[3][3];
+    std::vector<double> lever_x_, lever_y_, lever_z_;
+  };
+
+}  // namespace cpp_math
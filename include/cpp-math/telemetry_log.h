@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Binary telemetry logs and georeferencing of them in chunks through the batch path.
+ * Files are arrays of records in native byte order without a header, so loggers can write structs as they are
+ */
+
+namespace cpp_math
+{
+
+  struct TelemetryRecord
+  {
+    // Seconds, the same clock as PoseBuffer
+    double timestamp;
+    Vector3d position;
+    HeliAngles angles;
+    CameraAngles camera_angles;
+    // Distance measured by the rangefinder
+    double distance;
+  };
+
+  static_assert(sizeof(TelemetryRecord) == 10 * sizeof(double), "TelemetryRecord must not have padding");
+
+  /// @brief Point of calculatePointByDistanceAndAngles for a telemetry record
+  struct GeoreferencedRecord
+  {
+    double timestamp;
+    Vector3d point;
+  };
+
+  static_assert(sizeof(GeoreferencedRecord) == 4 * sizeof(double), "GeoreferencedRecord must not have padding");
+
+  /// @brief Records per chunk of Georeferencer, 160 KiB of records and their arrays stay in L2
+  constexpr size_t georeference_chunk_size = 1024;
+
+  void writeTelemetryLog(std::string const& path, std::vector<TelemetryRecord> const& records);
+
+  /**
+   * @brief Telemetry log mapped into memory for reading
+   * @note Nothing is read on construction, pages come in as records are touched, so logs may be bigger than RAM
+   */
+  class TelemetryLog
+  {
+  public:
+    /// @throws std::runtime_error if the file can not be mapped or its size is not a whole number of records
+    explicit TelemetryLog(std::string const& path);
+    ~TelemetryLog();
+
+    TelemetryLog(TelemetryLog const&) = delete;
+    TelemetryLog& operator=(TelemetryLog const&) = delete;
+
+    size_t size() const noexcept { return size_; }
+    TelemetryRecord const* records() const noexcept { return records_; }
+
+    /// @brief Drops mapped pages of records before end, they are not read again
+    void release(size_t end) noexcept;
+
+  private:
+    void* mapping_;
+    size_t size_;
+    TelemetryRecord const* records_;
+  };
+
+  /**
+   * @brief File of georeferenced records mapped into memory for writing
+   * @note Results are written right into the page cache, there is no buffer to copy them from
+   */
+  class GeoreferencedLogWriter
+  {
+  public:
+    /// @throws std::runtime_error if the file can not be created or its blocks for the given number of records allocated
+    GeoreferencedLogWriter(std::string const& path, size_t count);
+    ~GeoreferencedLogWriter();
+
+    GeoreferencedLogWriter(GeoreferencedLogWriter const&) = delete;
+    GeoreferencedLogWriter& operator=(GeoreferencedLogWriter const&) = delete;
+
+    size_t size() const noexcept { return size_; }
+    GeoreferencedRecord* records() noexcept { return records_; }
+
+    /// @brief Starts writing back records before end and drops their pages from the mapping
+    void release(size_t end) noexcept;
+
+  private:
+    void* mapping_;
+    size_t size_;
+    GeoreferencedRecord* records_;
+  };
+
+  /**
+   * @brief Georeferences chunks of records with calculatePointsByDistanceAndAngles
+   * @note Records are spread into arrays of one chunk and points are gathered back into the output records,
+   *       both stay in cache. Keep one per thread
+   */
+  class Georeferencer
+  {
+  public:
+    explicit Georeferencer(size_t chunk_size = georeference_chunk_size, BatchMode mode = BatchMode::Fast);
+
+    size_t chunkSize() const noexcept { return chunk_size_; }
+
+    /// @brief Any count, it goes in chunks. result may not overlap records
+    void process(TelemetryRecord const* records, size_t count, GeoreferencedRecord* result);
+
+  private:
+    void processChunk(TelemetryRecord const* records, size_t count, GeoreferencedRecord* result);
+
+    size_t chunk_size_;
+    BatchMode mode_;
+    // distance, position, angles and camera angles, then the point
+    std::vector<double> arrays_;
+  };
+
+}  // namespace cpp_math
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace cpp_math
+{
+
+  /**
+   * @brief Header of a DEM tile file, it is followed by width * height little endian floats
+   * @note Heights are stored by rows, sample (column, row) is at x = origin_x + column * cell_size,
+   *       y = origin_y + row * cell_size. Between samples the height is bilinear
+   */
+  struct DemTileHeader
+  {
+    char magic[8];
+    uint32_t width, height;
+    double origin_x, origin_y;
+    double cell_size;
+  };
+
+  /// @brief Writes a tile file, heights are stored by rows
+  void writeDemTile(std::string const& path, DemTileHeader const& header, std::vector<float> const& heights);
+
+  /// @brief DemTileHeader with the magic filled in
+  DemTileHeader makeDemTileHeader(uint32_t width, uint32_t height, double origin_x, double origin_y, double cell_size);
+
+  /**
+   * @brief Tile of a digital elevation model mapped into memory
+   * @note On load it builds a mipmap of max heights, level k keeps the max over 2^k x 2^k cells.
+   *       Rays which pass above the max of a block skip the whole block
+   */
+  class DemTile
+  {
+  public:
+    /// @throws std::runtime_error if the file can not be mapped or is not a tile
+    explicit DemTile(std::string const& path);
+    ~DemTile();
+
+    DemTile(DemTile const&) = delete;
+    DemTile& operator=(DemTile const&) = delete;
+
+    DemTileHeader const& header() const noexcept { return *header_; }
+
+    float sample(size_t column, size_t row) const noexcept { return heights_[row * header_->width + column]; }
+
+    /// @return Max height of the tile, the top of the mipmap
+    float maxHeight() const noexcept { return max_heights_.back()[0]; }
+
+    /// @return Bilinear height, NaN outside of the tile
+    double heightAt(double x, double y) const noexcept;
+
+    /**
+     * @brief Finds the first point of the ray below the surface with distance in [begin, end]
+     * @param direction Unit direction of the ray
+     * @param distance Receives the distance from origin to the hit
+     * @return false if the ray does not hit the tile in the range
+     */
+    bool intersect(Vector3d const& origin, Vector3d const& direction, double begin, double end, double& distance) const noexcept;
+
+  private:
+    struct Ray;
+
+    bool traverse(Ray const& ray, size_t level, size_t column, size_t row, double begin, double end, double& distance) const noexcept;
+    bool intersectCell(Ray const& ray, size_t column, size_t row, double begin, double end, double& distance) const noexcept;
+
+    void* mapping_;
+    size_t mapping_size_;
+    DemTileHeader const* header_;
+    float const* heights_;
+
+    // Max heights of blocks, level 0 is cells between samples
+    std::vector<std::vector<float>> max_heights_;
+    std::vector<size_t> level_widths_, level_heights_;
+  };
+
+  /**
+   * @brief LRU cache of tiles laid on a regular grid
+   * @note Tile (i, j) covers x in [i * tile_size, (i + 1) * tile_size] and the same for y, it is read from
+   *       directory/i_j.dem. Missing files are areas without terrain
+   * @note The directory is listed once on construction, tiles added later are not seen. Tiles which are
+   *       not on disk are not looked up and do not take places in the cache
+   * @note It is safe to use from several threads, tiles stay alive while somebody holds them
+   */
+  class DemTileCache
+  {
+  public:
+    using TilePointer = std::shared_ptr<DemTile const>;
+
+    /// @param capacity Number of tiles kept mapped, at least one
+    DemTileCache(std::string directory, double tile_size, size_t capacity);
+
+    double tileSize() const noexcept { return tile_size_; }
+
+    /// @return Tile with the given index, nullptr if there is no file for it
+    TilePointer tile(int64_t column, int64_t row);
+
+    /**
+     * @brief Range of tile indices on disk
+     * @return false if there are no tiles
+     */
+    bool tileExtent(int64_t& min_column, int64_t& min_row, int64_t& max_column, int64_t& max_row) const noexcept;
+
+    /// @return Max height of all tiles once each of them has been loaded, infinity before
+    double maxHeight() const noexcept { return max_height_.load(std::memory_order_relaxed); }
+
+    /// @return Tile which covers the point, nullptr if there is no file for it
+    TilePointer tileAt(double x, double y);
+
+    /// @return Bilinear height, NaN where there is no terrain
+    double heightAt(double x, double y);
+
+    uint64_t hits() const noexcept { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const noexcept { return misses_.load(std::memory_order_relaxed); }
+
+  private:
+    using Key = std::pair<int64_t, int64_t>;
+
+    struct KeyHash
+    {
+      size_t operator()(Key const& key) const noexcept;
+    };
+
+    struct Entry
+    {
+      TilePointer tile;
+      std::list<Key>::iterator position;
+    };
+
+    std::string directory_;
+    double tile_size_;
+    size_t capacity_;
+    // File names of tiles on disk, they do not change after construction
+    std::unordered_map<Key, std::string, KeyHash> files_;
+    int64_t min_column_, min_row_, max_column_, max_row_;
+
+    std::mutex mutex_;
+    // Most recently used keys go first
+    std::list<Key> order_;
+    std::unordered_map<Key, Entry, KeyHash> entries_;
+    // Tiles which have been loaded at least once and the max of their heights
+    std::unordered_set<Key, KeyHash> measured_;
+    double measured_max_height_;
+    std::atomic<double> max_height_;
+    std::atomic<uint64_t> hits_, misses_;
+  };
+
+  struct TerrainHit
+  {
+    Vector3d point;
+    double distance;
+  };
+
+  /**
+   * @brief Intersects the ray with the terrain, walking over tiles along it
+   * @param direction Direction of the ray, it does not have to be unit
+   * @param max_distance Ray is not followed further, it must be finite
+   * @return Point and distance of the first hit, NaN if there is none
+   * @note The walk stops where the ray leaves the extent of tiles on disk or once it is above the max height
+   *       of all tiles and does not descend
+   */
+  TerrainHit intersectTerrain(DemTileCache& cache, Vector3d const& origin, Vector3d const& direction, double max_distance);
+
+  /**
+   * @brief Intersects rays from one origin, for example rays of PixelRayGrid::calculateRays
+   * @param points Caller provided arrays of hit points, NaN for rays which do not hit
+   * @param distances Caller provided array of distances to hits, NaN for rays which do not hit
+   */
+  void intersectTerrain(
+    DemTileCache& cache,
+    size_t count,
+    Vector3d const& origin,
+    ConstVector3dArrays directions,
+    double max_distance,
+    Vector3dArrays points,
+    double* distances
+  );
+
+  /// @brief Same as above, chunks of rays run on the executor. Rays cost much more than points, so chunks are smaller
+  void intersectTerrain(
+    DemTileCache& cache,
+    size_t count,
+    Vector3d const& origin,
+    ConstVector3dArrays directions,
+    double max_distance,
+    Vector3dArrays points,
+    double* distances,
+    Executor& executor,
+    size_t chunk_size = 256
+  );
+
+}  // namespace cpp_math
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cpp-math/cpp_math.h>
+
+#include <cstddef>
+
+namespace cpp_math
+{
+
+  /**
+   * @brief Calculates sin and cos of angle in degrees
+   * @param degrees Any finite angle, see HeliAngles
+   * @param policy Precision of the result, Standard is the same as Ulp1 here
+   * @note Range reduction is exact, so sin(180) is exactly zero and huge multi-turn angles keep their precision
+   */
+  void sincosDeg(double degrees, double& sin_result, double& cos_result, TrigPolicy policy = TrigPolicy::Ulp1) noexcept;
+
+  /**
+   * @brief Batch version of sincosDeg which uses SIMD chosen by bestSimdLevel
+   * @note Error bounds are the same as for the single value version, but the last bit may differ
+   *       since AVX2 and AVX-512 kernels use fused multiply-add
+   */
+  void sincosDeg(
+    size_t count,
+    double const* degrees,
+    double* sin_result,
+    double* cos_result,
+    TrigPolicy policy = TrigPolicy::Ulp1
+  );
+
+}  // namespace cpp_math
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/executor.h>
+
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief Analytic derivatives of calculatePointByDistanceAndAngles and propagation of input
+ * uncertainty to the point: covariance of the point is J * covariance of inputs * J^T
+ */
+
+namespace cpp_math
+{
+
+  /// @brief Inputs of calculatePointByDistanceAndAngles, indices of PointJacobian columns and PointInputCovariance
+  enum class PointInput
+  {
+    Distance,
+    X,
+    Y,
+    Z,
+    Yaw,
+    Pitch,
+    Roll,
+    CameraYaw,
+    CameraPitch
+  };
+
+  constexpr size_t point_inputs_count = 9;
+
+  /**
+   * @brief Derivatives of the point by every input
+   * @note Angles are in degrees, so columns of angles are meters per degree.
+   *       Camera angles are added to the heli ones, their columns are the same as of yaw and pitch
+   */
+  struct PointJacobian
+  {
+    std::array<Vector3d, point_inputs_count> columns;
+
+    Vector3d const& operator[](PointInput input) const noexcept { return columns[static_cast<size_t>(input)]; }
+  };
+
+  /// @brief Covariance of inputs in the order of PointInput, variances of angles are in degrees squared
+  using PointInputCovariance = std::array<std::array<double, point_inputs_count>, point_inputs_count>;
+
+  /**
+   * @brief Calculates the same point as calculatePointByDistanceAndAngles and its derivatives
+   * @note rotateVector may change the order of rotations when an angle crosses zero (see its notes), so the point
+   *       jumps there. Derivatives are of the order resolved for the given angles, an angle which is zero keeps
+   *       its place in that order
+   */
+  Vector3d calculatePointWithJacobian(
+    double distance,
+    Vector3d const& initial_position,
+    HeliAngles const& angles,
+    CameraAngles const& camera_angles,
+    PointJacobian& jacobian
+  ) noexcept;
+
+  /// @return Covariance of the point, jacobian * covariance * jacobian^T
+  Mat3 propagateCovariance(PointJacobian const& jacobian, PointInputCovariance const& covariance) noexcept;
+
+  /**
+   * @brief Structure of arrays with standard deviations of independent inputs, angles are in degrees
+   * @note nullptr is an input without uncertainty, for example position.x, y and z for a known position
+   */
+  struct PointInputSigmas
+  {
+    double const* distance;
+    ConstVector3dArrays position;
+    HeliAnglesArrays angles;
+    CameraAnglesArrays camera_angles;
+  };
+
+  /// @brief Structure of arrays which receives symmetric 3x3 matrices, the upper triangle of each
+  struct CovarianceArrays
+  {
+    double* xx;
+    double* xy;
+    double* xz;
+    double* yy;
+    double* yz;
+    double* zz;
+  };
+
+  /**
+   * @brief Points of calculatePointByDistanceAndAngles and their covariances in one pass
+   * @param sigmas Standard deviations of inputs of every point
+   * @param points Caller provided arrays, the same points as single calls give
+   * @param covariances Caller provided arrays of covariances of the points
+   */
+  void calculatePointsWithCovariance(
+    size_t count,
+    double const* distances,
+    ConstVector3dArrays initial_positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    PointInputSigmas sigmas,
+    Vector3dArrays points,
+    CovarianceArrays covariances,
+    Executor& executor = sequentialExecutor(),
+    size_t chunk_size = default_chunk_size
+  );
+
+  /// @brief Same as above with correlated inputs, every point has the same covariance of inputs
+  void calculatePointsWithCovariance(
+    size_t count,
+    double const* distances,
+    ConstVector3dArrays initial_positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    PointInputCovariance const& covariance,
+    Vector3dArrays points,
+    CovarianceArrays covariances,
+    Executor& executor = sequentialExecutor(),
+    size_t chunk_size = default_chunk_size
+  );
+
+}  // namespace cpp_math
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @brief Operators for Vector3 which build lazy expressions instead of temporaries.
+ * p + d * (R * v) is evaluated component by component in one go, with the same roundings as the
+ * free functions (no fused multiply-add whatever the target, so results do not depend on build flags).
+ * The same expressions work over structures of arrays (see arrays and perElement), then evaluate
+ * calculates the whole expression in a single pass over memory.
+ * @note Expressions keep their operands by value, so it is fine to keep them in auto variables.
+ *       Only arrays are referenced by pointers
+ */
+
+namespace cpp_math
+{
+  /// @brief Base of all vector expressions, E is the expression itself
+  template<typename E>
+  struct VectorExpression
+  {
+    constexpr E const& self() const noexcept { return static_cast<E const&>(*this); }
+
+    /// @brief Evaluates a single vector expression, so Vector3d p = a + d * v; works
+    template<typename T>
+    operator Vector3<T>() const noexcept
+    {
+      static_assert(std::is_same<T, typename E::value_type>::value, "Expression has another scalar type");
+      static_assert(not E::is_batch, "Use evaluate(count, result, expression) for expressions over arrays");
+      return self().at(0);
+    }
+  };
+
+  /// @brief Value of a single vector expression, arrays in the expression are not allowed here
+  template<typename E>
+  Vector3<typename E::value_type> evaluate(VectorExpression<E> const& expression) noexcept
+  {
+    static_assert(not E::is_batch, "Use evaluate(count, result, expression) for expressions over arrays");
+    return expression.self().at(0);
+  }
+
+  /**
+   * @brief Calculates expression for every element i < count in a single pass
+   * @note result may be one of the arrays in the expression, every element is read before it is written
+   */
+  template<typename E>
+  void evaluate(size_t count, Vector3dArrays result, VectorExpression<E> const& expression) noexcept
+  {
+    static_assert(std::is_same<typename E::value_type, double>::value, "Arrays are double");
+    auto const& self = expression.self();
+    for(size_t i = 0; i < count; ++i) {
+      auto value = self.at(i);
+      result.x[i] = value.x;
+      result.y[i] = value.y;
+      result.z[i] = value.z;
+    }
+  }
+
+  namespace expression
+  {
+    template<typename T>
+    struct VectorTerminal : VectorExpression<VectorTerminal<T>>
+    {
+      using value_type = T;
+      static constexpr bool is_batch = false;
+
+      constexpr explicit VectorTerminal(Vector3<T> const& value) noexcept : value(value) {}
+      constexpr Vector3<T> at(size_t) const noexcept { return value; }
+
+      Vector3<T> value;
+    };
+
+    struct ArraysTerminal : VectorExpression<ArraysTerminal>
+    {
+      using value_type = double;
+      static constexpr bool is_batch = true;
+
+      constexpr explicit ArraysTerminal(ConstVector3dArrays arrays) noexcept : arrays(arrays) {}
+      constexpr Vector3d at(size_t i) const noexcept { return {arrays.x[i], arrays.y[i], arrays.z[i]}; }
+
+      ConstVector3dArrays arrays;
+    };
+
+    template<typename T>
+    struct ScalarTerminal
+    {
+      static constexpr bool is_batch = false;
+      constexpr T at(size_t) const noexcept { return value; }
+      T value;
+    };
+
+    /// @brief One scalar per element, for example distances of points
+    struct ScalarArrayTerminal
+    {
+      static constexpr bool is_batch = true;
+      constexpr double at(size_t i) const noexcept { return values[i]; }
+      double const* values;
+    };
+
+    template<typename L, typename R>
+    struct Sum : VectorExpression<Sum<L, R>>
+    {
+      using value_type = typename L::value_type;
+      static constexpr bool is_batch = L::is_batch or R::is_batch;
+
+      constexpr Sum(L const& left, R const& right) noexcept : left(left), right(right) {}
+      Vector3<value_type> at(size_t i) const noexcept { return addTo(left.at(i), right, i); }
+
+      L left;
+      R right;
+    };
+
+    template<typename L, typename R>
+    struct Difference : VectorExpression<Difference<L, R>>
+    {
+      using value_type = typename L::value_type;
+      static constexpr bool is_batch = L::is_batch or R::is_batch;
+
+      constexpr Difference(L const& left, R const& right) noexcept : left(left), right(right) {}
+      Vector3<value_type> at(size_t i) const noexcept
+      {
+        auto a = left.at(i);
+        auto b = right.at(i);
+        return {a.x - b.x, a.y - b.y, a.z - b.z};
+      }
+
+      L left;
+      R right;
+    };
+
+    template<typename E>
+    struct Negation : VectorExpression<Negation<E>>
+    {
+      using value_type = typename E::value_type;
+      static constexpr bool is_batch = E::is_batch;
+
+      constexpr explicit Negation(E const& operand) noexcept : operand(operand) {}
+      Vector3<value_type> at(size_t i) const noexcept
+      {
+        auto a = operand.at(i);
+        return {-a.x, -a.y, -a.z};
+      }
+
+      E operand;
+    };
+
+    template<typename S, typename E>
+    struct Scaled : VectorExpression<Scaled<S, E>>
+    {
+      using value_type = typename E::value_type;
+      static constexpr bool is_batch = S::is_batch or E::is_batch;
+
+      constexpr Scaled(S const& scalar, E const& operand) noexcept : scalar(scalar), operand(operand) {}
+      Vector3<value_type> at(size_t i) const noexcept
+      {
+        value_type s = scalar.at(i);
+        auto a = operand.at(i);
+        return {a.x * s, a.y * s, a.z * s};
+      }
+
+      S scalar;
+      E operand;
+    };
+
+    template<typename E>
+    struct Rotated : VectorExpression<Rotated<E>>
+    {
+      using value_type = typename E::value_type;
+      static constexpr bool is_batch = E::is_batch;
+
+      constexpr Rotated(BasicMat3<value_type> const& matrix, E const& operand) noexcept : matrix(matrix), operand(operand)
+      {}
+      Vector3<value_type> at(size_t i) const noexcept { return multiplyMatrixByVector(matrix, operand.at(i)); }
+
+      BasicMat3<value_type> matrix;
+      E operand;
+    };
+
+    /// @brief d * R, which only makes sense before a vector: d * R * v is d * (R * v)
+    template<typename S, typename T>
+    struct ScaledMatrix
+    {
+      S scalar;
+      BasicMat3<T> matrix;
+    };
+
+    /// @brief a + b
+    template<typename T, typename E>
+    Vector3<T> addTo(Vector3<T> const& a, E const& b, size_t i) noexcept
+    {
+      auto value = b.at(i);
+      return {a.x + value.x, a.y + value.y, a.z + value.z};
+    }
+
+    template<typename X>
+    struct IsVectorOperand : std::is_base_of<VectorExpression<X>, X>
+    {};
+
+    template<typename T>
+    struct IsVectorOperand<Vector3<T>> : std::true_type
+    {};
+
+    template<typename E>
+    constexpr E const& toExpression(VectorExpression<E> const& expression) noexcept
+    {
+      return expression.self();
+    }
+
+    template<typename T>
+    constexpr VectorTerminal<T> toExpression(Vector3<T> const& v) noexcept
+    {
+      return VectorTerminal<T>(v);
+    }
+
+    template<typename X>
+    using ExpressionOf = typename std::decay<decltype(toExpression(std::declval<X>()))>::type;
+
+    template<typename X, typename Result = void>
+    using EnableIfVector = typename std::enable_if<IsVectorOperand<X>::value, Result>::type;
+
+    template<typename X, typename Result = void>
+    using EnableIfScalar = typename std::enable_if<std::is_arithmetic<X>::value, Result>::type;
+  }  // namespace expression
+
+  /// @brief Vectors of structure of arrays as an operand of expressions
+  inline expression::ArraysTerminal arrays(ConstVector3dArrays values) noexcept
+  {
+    return expression::ArraysTerminal(values);
+  }
+
+  /// @brief Scalars of an array as an operand of expressions, element i of the result uses values[i]
+  inline expression::ScalarArrayTerminal perElement(double const* values) noexcept
+  {
+    return expression::ScalarArrayTerminal{values};
+  }
+
+  template<typename L, typename R, typename = expression::EnableIfVector<L>, typename = expression::EnableIfVector<R>>
+  constexpr expression::Sum<expression::ExpressionOf<L>, expression::ExpressionOf<R>> operator+(L const& left, R const& right) noexcept
+  {
+    return {expression::toExpression(left), expression::toExpression(right)};
+  }
+
+  template<typename L, typename R, typename = expression::EnableIfVector<L>, typename = expression::EnableIfVector<R>>
+  constexpr expression::Difference<expression::ExpressionOf<L>, expression::ExpressionOf<R>> operator-(L const& left, R const& right) noexcept
+  {
+    return {expression::toExpression(left), expression::toExpression(right)};
+  }
+
+  template<typename E, typename = expression::EnableIfVector<E>>
+  constexpr expression::Negation<expression::ExpressionOf<E>> operator-(E const& operand) noexcept
+  {
+    return expression::Negation<expression::ExpressionOf<E>>(expression::toExpression(operand));
+  }
+
+  template<typename S, typename E, typename = expression::EnableIfScalar<S>, typename = expression::EnableIfVector<E>>
+  constexpr auto operator*(S scalar, E const& operand) noexcept
+  {
+    using Operand = expression::ExpressionOf<E>;
+    using Scalar = expression::ScalarTerminal<typename Operand::value_type>;
+    return expression::Scaled<Scalar, Operand>(Scalar{static_cast<typename Operand::value_type>(scalar)}, expression::toExpression(operand));
+  }
+
+  template<typename E, typename S, typename = expression::EnableIfVector<E>, typename = expression::EnableIfScalar<S>>
+  constexpr auto operator*(E const& operand, S scalar) noexcept
+  {
+    return scalar * operand;
+  }
+
+  template<typename E, typename = expression::EnableIfVector<E>>
+  constexpr auto operator*(expression::ScalarArrayTerminal scalars, E const& operand) noexcept
+  {
+    return expression::Scaled<expression::ScalarArrayTerminal, expression::ExpressionOf<E>>(scalars, expression::toExpression(operand));
+  }
+
+  template<typename T, typename E, typename = expression::EnableIfVector<E>>
+  constexpr auto operator*(BasicMat3<T> const& matrix, E const& operand) noexcept
+  {
+    return expression::Rotated<expression::ExpressionOf<E>>(matrix, expression::toExpression(operand));
+  }
+
+  template<typename S, typename T, typename = expression::EnableIfScalar<S>>
+  constexpr auto operator*(S scalar, BasicMat3<T> const& matrix) noexcept
+  {
+    return expression::ScaledMatrix<expression::ScalarTerminal<T>, T>{expression::ScalarTerminal<T>{static_cast<T>(scalar)}, matrix};
+  }
+
+  template<typename T>
+  constexpr auto operator*(expression::ScalarArrayTerminal scalars, BasicMat3<T> const& matrix) noexcept
+  {
+    return expression::ScaledMatrix<expression::ScalarArrayTerminal, T>{scalars, matrix};
+  }
+
+  template<typename S, typename T, typename E, typename = expression::EnableIfVector<E>>
+  constexpr auto operator*(expression::ScaledMatrix<S, T> const& scaled, E const& operand) noexcept
+  {
+    using Rotated = expression::Rotated<expression::ExpressionOf<E>>;
+    return expression::Scaled<S, Rotated>(scaled.scalar, Rotated(scaled.matrix, expression::toExpression(operand)));
+  }
+
+}  // namespace cpp_math
@@ -0,0 +1,156 @@
+#include <cpp-math/batch.h>
+
+#include "batch_kernels.h"
+#include "instrumentation_hooks.h"
+
+namespace
+{
+  using namespace cpp_math;
+
+  SimdLevel detectSimdLevel()
+  {
+#if defined(CPP_MATH_X86_KERNELS)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+      return SimdLevel::Avx512;
+    }
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+      return SimdLevel::Avx2;
+    }
+    return SimdLevel::Sse2;
+#else
+    return SimdLevel::None;
+#endif
+  }
+
+  void calculatePointsStrict(detail::PointsBatch const& batch)
+  {
+    for(size_t i = 0; i < batch.count; ++i) {
+      auto point = calculatePointByDistanceAndAngles(
+        batch.distances[i],
+        Vector3d{batch.initial_positions.x[i], batch.initial_positions.y[i], batch.initial_positions.z[i]},
+        HeliAngles{batch.angles.yaw[i], batch.angles.pitch[i], batch.angles.roll[i]},
+        CameraAngles{batch.camera_angles.yaw[i], batch.camera_angles.pitch[i]}
+      );
+      batch.result.x[i] = point.x;
+      batch.result.y[i] = point.y;
+      batch.result.z[i] = point.z;
+    }
+  }
+
+  void calculatePoints(detail::PointsBatch const& batch, SimdLevel simd_level)
+  {
+    if(static_cast<int>(simd_level) > static_cast<int>(bestSimdLevel())) {
+      simd_level = bestSimdLevel();
+    }
+    switch(simd_level) {
+#if defined(CPP_MATH_X86_KERNELS)
+      case SimdLevel::Avx512: return detail::calculatePointsAvx512(batch);
+      case SimdLevel::Avx2: return detail::calculatePointsAvx2(batch);
+      case SimdLevel::Sse2: return detail::calculatePointsSse2(batch);
+#else
+      case SimdLevel::Avx512:
+      case SimdLevel::Avx2:
+      case SimdLevel::Sse2:
+#endif
+      case SimdLevel::None: return detail::calculatePointsGeneric(batch);
+    }
+  }
+}  // namespace
+
+namespace cpp_math
+{
+  SimdLevel bestSimdLevel()
+  {
+    static SimdLevel const level = detectSimdLevel();
+    return level;
+  }
+
+  void calculatePointsByDistanceAndAngles(
+    size_t count,
+    double const* distances,
+    ConstVector3dArrays initial_positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    Vector3dArrays result,
+    BatchMode mode
+  )
+  {
+    detail::ScopedCall call(InstrumentedFunction::CalculatePointsByDistanceAndAngles);
+    auto batch = detail::PointsBatch{count, distances, initial_positions, angles, camera_angles, result};
+    if(mode == BatchMode::Strict) {
+      calculatePointsStrict(batch);
+    }
+    else {
+      calculatePoints(batch, bestSimdLevel());
+    }
+  }
+
+  void calculatePointsByDistanceAndAngles(
+    size_t count,
+    double const* distances,
+    ConstVector3dArrays initial_positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    Vector3dArrays result,
+    SimdLevel simd_level
+  )
+  {
+    detail::ScopedCall call(InstrumentedFunction::CalculatePointsByDistanceAndAngles);
+    auto batch = detail::PointsBatch{count, distances, initial_positions, angles, camera_angles, result};
+    calculatePoints(batch, simd_level);
+  }
+
+  void calculatePointsByDistanceAndAngles(
+    size_t count,
+    double const* distances,
+    ConstVector3dArrays initial_positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    Vector3dArrays result,
+    Executor& executor,
+    BatchMode mode,
+    size_t chunk_size
+  )
+  {
+    executor.parallelFor(count, chunk_size, [&](size_t begin, size_t end) {
+      calculatePointsByDistanceAndAngles(
+        end - begin,
+        distances + begin,
+        {initial_positions.x + begin, initial_positions.y + begin, initial_positions.z + begin},
+        {angles.yaw + begin, angles.pitch + begin, angles.roll + begin},
+        {camera_angles.yaw + begin, camera_angles.pitch + begin},
+        {result.x + begin, result.y + begin, result.z + begin},
+        mode
+      );
+    });
+  }
+
+  void composeRotations(
+    size_t count,
+    Mat3 const* first,
+    Mat3 const* second,
+    Mat3* result,
+    Executor& executor,
+    size_t chunk_size
+  )
+  {
+    executor.parallelFor(count, chunk_size, [&](size_t begin, size_t end) {
+      for(auto i = begin; i < end; ++i) {
+        result[i] = composeRotations(first[i], second[i]);
+      }
+    });
+  }
+
+  std::ostream& operator<<(std::ostream& os, SimdLevel level)
+  {
+    switch(level) {
+      case SimdLevel::None: return os << "none";
+      case SimdLevel::Sse2: return os << "sse2";
+      case SimdLevel::Avx2: return os << "avx2";
+      case SimdLevel::Avx512: return os << "avx512";
+    }
+    return os << "unknown";
+  }
+
+}  // namespace cpp_math
@@ -0,0 +1,19 @@
+#include "batch_kernel_impl.h"
+
+namespace cpp_math
+{
+  namespace detail
+  {
+    using DoubleAvx2 = double __attribute__((vector_size(32)));
+
+    void calculatePointsAvx2(PointsBatch const& batch)
+    {
+      calculatePointsKernel<DoubleAvx2>(batch);
+    }
+
+    void sincosDegreesAvx2(TrigPolicy policy, size_t count, double const* degrees, double* sin_result, double* cos_result)
+    {
+      sincosDegreesKernel<DoubleAvx2>(policy, count, degrees, sin_result, cos_result);
+    }
+  }  // namespace detail
+}  // namespace cpp_math
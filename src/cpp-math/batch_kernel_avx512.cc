@@ -0,0 +1,19 @@
+#include "batch_kernel_impl.h"
+
+namespace cpp_math
+{
+  namespace detail
+  {
+    using DoubleAvx512 = double __attribute__((vector_size(64)));
+
+    void calculatePointsAvx512(PointsBatch const& batch)
+    {
+      calculatePointsKernel<DoubleAvx512>(batch);
+    }
+
+    void sincosDegreesAvx512(TrigPolicy policy, size_t count, double const* degrees, double* sin_result, double* cos_result)
+    {
+      sincosDegreesKernel<DoubleAvx512>(policy, count, degrees, sin_result, cos_result);
+    }
+  }  // namespace detail
+}  // namespace cpp_math
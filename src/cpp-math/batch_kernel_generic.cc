@@ -0,0 +1,19 @@
+#include "batch_kernel_impl.h"
+
+namespace cpp_math
+{
+  namespace detail
+  {
+    using DoubleGeneric = double __attribute__((vector_size(8)));
+
+    void calculatePointsGeneric(PointsBatch const& batch)
+    {
+      calculatePointsKernel<DoubleGeneric>(batch);
+    }
+
+    void sincosDegreesGeneric(TrigPolicy policy, size_t count, double const* degrees, double* sin_result, double* cos_result)
+    {
+      sincosDegreesKernel<DoubleGeneric>(policy, count, degrees, sin_result, cos_result);
+    }
+  }  // namespace detail
+}  // namespace cpp_math
@@ -0,0 +1,166 @@
+#pragma once
+
+// Closed form of calculatePointByDistanceAndAngles written with GCC vector extensions.
+// This header is included by translation units compiled with different instruction sets.
+// Everything here has internal linkage so the linker never mixes up code for different CPUs,
+// and only builtins are used for the same reason
+
+#include "batch_kernels.h"
+#include "sincos_impl.h"
+
+namespace cpp_math
+{
+  namespace detail
+  {
+    namespace
+    {
+      // epsilon * 100, the same threshold close_to_zero uses
+      constexpr double zero_threshold = 2.220446049250313080847e-14;
+
+      template <class V>
+      V load(double const* data)
+      {
+        V result;
+        __builtin_memcpy(&result, data, sizeof(V));
+        return result;
+      }
+
+      template <class V>
+      void store(double* data, V value)
+      {
+        __builtin_memcpy(data, &value, sizeof(V));
+      }
+
+      /**
+       * @brief Rotates X axis the way rotateVector does
+       * @return Mask of lanes which hit a corner case of rotation order selection, they must be recalculated
+       */
+      template <class V>
+      auto boresightDirection(V yaw, V pitch, V roll, V& x, V& y, V& z)
+      {
+        V sin_yaw, cos_yaw, sin_pitch, cos_pitch, sin_roll, cos_roll;
+        sincosDegrees<TrigPolicy::Ulp1>(yaw, sin_yaw, cos_yaw);
+        sincosDegrees<TrigPolicy::Ulp1>(pitch, sin_pitch, cos_pitch);
+        sincosDegrees<TrigPolicy::Ulp1>(roll, sin_roll, cos_roll);
+
+        auto no_yaw = absolute(yaw) < zero_threshold;
+        auto no_pitch = absolute(pitch) < zero_threshold;
+        auto no_roll = absolute(roll) < zero_threshold;
+
+        // No roll: pitch then yaw
+        auto x_pitch_yaw = cos_yaw * cos_pitch;
+        auto y_pitch_yaw = sin_yaw * cos_pitch;
+        auto z_pitch_yaw = -sin_pitch;
+
+        // Roll and yaw: roll only makes sense after yaw, so yaw, roll, pitch
+        auto rolled_z = sin_yaw * sin_roll;
+        auto x_yaw_roll_pitch = cos_pitch * cos_yaw + sin_pitch * rolled_z;
+        auto y_yaw_roll_pitch = sin_yaw * cos_roll;
+        auto z_yaw_roll_pitch = cos_pitch * rolled_z - sin_pitch * cos_yaw;
+
+        // Roll without yaw: pitch then roll
+        auto x_pitch_roll = cos_pitch;
+        auto y_pitch_roll = sin_roll * sin_pitch;
+        auto z_pitch_roll = -cos_roll * sin_pitch;
+
+        auto yaw_after_pitch_fails = !no_yaw && !no_pitch && absolute(cos_pitch) < zero_threshold;
+        auto roll_after_yaw_fails = absolute(sin_yaw) < zero_threshold
+                                 || (!no_pitch && absolute(cos_yaw) < zero_threshold
+                                     && absolute(rolled_z) < zero_threshold);
+        auto roll_after_pitch_fails = !no_pitch && absolute(sin_pitch) < zero_threshold;
+
+        x = no_roll ? x_pitch_yaw : (no_yaw ? x_pitch_roll : x_yaw_roll_pitch);
+        y = no_roll ? y_pitch_yaw : (no_yaw ? y_pitch_roll : y_yaw_roll_pitch);
+        z = no_roll ? z_pitch_yaw : (no_yaw ? z_pitch_roll : z_yaw_roll_pitch);
+
+        return no_roll ? yaw_after_pitch_fails
+                       : (no_yaw ? roll_after_pitch_fails : roll_after_yaw_fails);
+      }
+
+      template <class V>
+      void calculatePointsBlock(PointsBatch const& batch, size_t offset)
+      {
+        auto const& angles = batch.angles;
+        auto const& camera_angles = batch.camera_angles;
+        auto const& positions = batch.initial_positions;
+
+        auto yaw = load<V>(angles.yaw + offset) + load<V>(camera_angles.yaw + offset);
+        auto pitch = load<V>(angles.pitch + offset) + load<V>(camera_angles.pitch + offset);
+        auto roll = load<V>(angles.roll + offset);
+
+        V x, y, z;
+        auto corner_case = boresightDirection(yaw, pitch, roll, x, y, z);
+
+        auto distance = load<V>(batch.distances + offset);
+        store(batch.result.x + offset, load<V>(positions.x + offset) + x * distance);
+        store(batch.result.y + offset, load<V>(positions.y + offset) + y * distance);
+        store(batch.result.z + offset, load<V>(positions.z + offset) + z * distance);
+
+        for(size_t lane = 0; lane < Lanes<V>::width; ++lane) {
+          if(corner_case[lane]) {
+            auto i = offset + lane;
+            auto point = calculatePointByDistanceAndAngles(
+              batch.distances[i],
+              Vector3d{positions.x[i], positions.y[i], positions.z[i]},
+              HeliAngles{angles.yaw[i], angles.pitch[i], angles.roll[i]},
+              CameraAngles{camera_angles.yaw[i], camera_angles.pitch[i]}
+            );
+            batch.result.x[i] = point.x;
+            batch.result.y[i] = point.y;
+            batch.result.z[i] = point.z;
+          }
+        }
+      }
+
+      /// @brief Copies the tail into zero padded buffers so the block code can be reused
+      template <class V>
+      void calculatePointsTail(PointsBatch const& batch, size_t offset)
+      {
+        constexpr size_t width = Lanes<V>::width;
+        double buffers[12][width] = {};
+        auto count = batch.count - offset;
+        double const* sources[9] = {
+          batch.distances + offset,
+          batch.initial_positions.x + offset,
+          batch.initial_positions.y + offset,
+          batch.initial_positions.z + offset,
+          batch.angles.yaw + offset,
+          batch.angles.pitch + offset,
+          batch.angles.roll + offset,
+          batch.camera_angles.yaw + offset,
+          batch.camera_angles.pitch + offset,
+        };
+        for(size_t array = 0; array < 9; ++array) {
+          __builtin_memcpy(buffers[array], sources[array], count * sizeof(double));
+        }
+
+        auto tail = PointsBatch{
+          width,
+          buffers[0],
+          ConstVector3dArrays{buffers[1], buffers[2], buffers[3]},
+          HeliAnglesArrays{buffers[4], buffers[5], buffers[6]},
+          CameraAnglesArrays{buffers[7], buffers[8]},
+          Vector3dArrays{buffers[9], buffers[10], buffers[11]}
+        };
+        calculatePointsBlock<V>(tail, 0);
+
+        __builtin_memcpy(batch.result.x + offset, buffers[9], count * sizeof(double));
+        __builtin_memcpy(batch.result.y + offset, buffers[10], count * sizeof(double));
+        __builtin_memcpy(batch.result.z + offset, buffers[11], count * sizeof(double));
+      }
+
+      template <class V>
+      void calculatePointsKernel(PointsBatch const& batch)
+      {
+        constexpr size_t width = Lanes<V>::width;
+        size_t offset = 0;
+        for(; offset + width <= batch.count; offset += width) {
+          calculatePointsBlock<V>(batch, offset);
+        }
+        if(offset < batch.count) {
+          calculatePointsTail<V>(batch, offset);
+        }
+      }
+    }  // namespace
+  }  // namespace detail
+}  // namespace cpp_math
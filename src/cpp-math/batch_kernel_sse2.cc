@@ -0,0 +1,19 @@
+#include "batch_kernel_impl.h"
+
+namespace cpp_math
+{
+  namespace detail
+  {
+    using DoubleSse2 = double __attribute__((vector_size(16)));
+
+    void calculatePointsSse2(PointsBatch const& batch)
+    {
+      calculatePointsKernel<DoubleSse2>(batch);
+    }
+
+    void sincosDegreesSse2(TrigPolicy policy, size_t count, double const* degrees, double* sin_result, double* cos_result)
+    {
+      sincosDegreesKernel<DoubleSse2>(policy, count, degrees, sin_result, cos_result);
+    }
+  }  // namespace detail
+}  // namespace cpp_math
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cpp-math/batch.h>
+
+#include <cstddef>
+
+namespace cpp_math
+{
+  namespace detail
+  {
+    struct PointsBatch
+    {
+      size_t count;
+      double const* distances;
+      ConstVector3dArrays initial_positions;
+      HeliAnglesArrays angles;
+      CameraAnglesArrays camera_angles;
+      Vector3dArrays result;
+    };
+
+    // Every kernel lives in its own translation unit compiled for its instruction set.
+    // They must only be called after checking the CPU supports it
+    void calculatePointsGeneric(PointsBatch const& batch);
+    void calculatePointsSse2(PointsBatch const& batch);
+    void calculatePointsAvx2(PointsBatch const& batch);
+    void calculatePointsAvx512(PointsBatch const& batch);
+
+    void sincosDegreesGeneric(TrigPolicy policy, size_t count, double const* degrees, double* sin_result, double* cos_result);
+    void sincosDegreesSse2(TrigPolicy policy, size_t count, double const* degrees, double* sin_result, double* cos_result);
+    void sincosDegreesAvx2(TrigPolicy policy, size_t count, double const* degrees, double* sin_result, double* cos_result);
+    void sincosDegreesAvx512(TrigPolicy policy, size_t count, double const* degrees, double* sin_result, double* cos_result);
+  }  // namespace detail
+}  // namespace cpp_math
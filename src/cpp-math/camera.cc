@@ -0,0 +1,138 @@
+#include <cpp-math/camera.h>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+  using namespace cpp_math;
+
+  // 4096 pixels are 96 KiB of input and output rays, small enough to stay in L2
+  constexpr size_t tile_size = default_chunk_size;
+  constexpr int undistortion_iterations = 20;
+
+  /// @brief Inverts Brown-Conrady distortion of normalized image coordinates by fixed point iteration
+  void undistort(CameraIntrinsics const& intrinsics, double& x, double& y)
+  {
+    auto const distorted_x = x;
+    auto const distorted_y = y;
+    for(int i = 0; i < undistortion_iterations; ++i) {
+      auto r2 = x * x + y * y;
+      auto radial = 1 + r2 * (intrinsics.k1 + r2 * (intrinsics.k2 + r2 * intrinsics.k3));
+      auto dx = 2 * intrinsics.p1 * x * y + intrinsics.p2 * (r2 + 2 * x * x);
+      auto dy = intrinsics.p1 * (r2 + 2 * y * y) + 2 * intrinsics.p2 * x * y;
+      x = (distorted_x - dx) / radial;
+      y = (distorted_y - dy) / radial;
+    }
+  }
+}  // namespace
+
+namespace cpp_math
+{
+  PixelRayGrid::PixelRayGrid(CameraIntrinsics const& intrinsics) :
+    intrinsics_(intrinsics)
+  {
+    if(intrinsics.fx <= 0 || intrinsics.fy <= 0) {
+      throw std::runtime_error("Focal lengths must be positive");
+    }
+
+    auto const distorted = intrinsics.k1 != 0 || intrinsics.k2 != 0 || intrinsics.k3 != 0
+                        || intrinsics.p1 != 0 || intrinsics.p2 != 0;
+    auto count = intrinsics.width * intrinsics.height;
+    x_.resize(count);
+    y_.resize(count);
+    z_.resize(count);
+    for(size_t row = 0; row < intrinsics.height; ++row) {
+      for(size_t column = 0; column < intrinsics.width; ++column) {
+        auto x = (static_cast<double>(column) - intrinsics.cx) / intrinsics.fx;
+        auto y = (static_cast<double>(row) - intrinsics.cy) / intrinsics.fy;
+        if(distorted) {
+          undistort(intrinsics, x, y);
+        }
+        auto norm = std::sqrt(1 + x * x + y * y);
+        auto i = index(column, row);
+        x_[i] = 1 / norm;
+        y_[i] = -x / norm;
+        z_[i] = -y / norm;
+      }
+    }
+  }
+
+  Vector3d PixelRayGrid::ray(size_t column, size_t row) const noexcept
+  {
+    auto i = index(column, row);
+    return Vector3d{x_[i], y_[i], z_[i]};
+  }
+
+  void PixelRayGrid::calculateRays(HeliAttitude const& attitude, Vector3dArrays result) const
+  {
+    calculateRays(attitude, result, sequentialExecutor(), tile_size);
+  }
+
+  void PixelRayGrid::calculateRays(
+    HeliAttitude const& attitude,
+    Vector3dArrays result,
+    Executor& executor,
+    size_t chunk_size
+  ) const
+  {
+    auto const m = attitude.matrix();
+    double const* __restrict x = x_.data();
+    double const* __restrict y = y_.data();
+    double const* __restrict z = z_.data();
+    executor.parallelFor(size(), chunk_size, [&](size_t begin, size_t end) {
+      double* __restrict result_x = result.x;
+      double* __restrict result_y = result.y;
+      double* __restrict result_z = result.z;
+      for(auto i = begin; i < end; ++i) {
+        result_x[i] = m[0][0] * x[i] + m[0][1] * y[i] + m[0][2] * z[i];
+        result_y[i] = m[1][0] * x[i] + m[1][1] * y[i] + m[1][2] * z[i];
+        result_z[i] = m[2][0] * x[i] + m[2][1] * y[i] + m[2][2] * z[i];
+      }
+    });
+  }
+
+  void PixelRayGrid::calculateGroundPoints(
+    HeliAttitude const& attitude,
+    Vector3d const& initial_position,
+    double ground_z,
+    Vector3dArrays result
+  ) const
+  {
+    calculateGroundPoints(attitude, initial_position, ground_z, result, sequentialExecutor(), tile_size);
+  }
+
+  void PixelRayGrid::calculateGroundPoints(
+    HeliAttitude const& attitude,
+    Vector3d const& initial_position,
+    double ground_z,
+    Vector3dArrays result,
+    Executor& executor,
+    size_t chunk_size
+  ) const
+  {
+    auto const m = attitude.matrix();
+    auto const height = ground_z - initial_position.z;
+    auto const nan = std::numeric_limits<double>::quiet_NaN();
+    double const* __restrict x = x_.data();
+    double const* __restrict y = y_.data();
+    double const* __restrict z = z_.data();
+    executor.parallelFor(size(), chunk_size, [&](size_t begin, size_t end) {
+      double* __restrict result_x = result.x;
+      double* __restrict result_y = result.y;
+      double* __restrict result_z = result.z;
+      for(auto i = begin; i < end; ++i) {
+        auto ray_x = m[0][0] * x[i] + m[0][1] * y[i] + m[0][2] * z[i];
+        auto ray_y = m[1][0] * x[i] + m[1][1] * y[i] + m[1][2] * z[i];
+        auto ray_z = m[2][0] * x[i] + m[2][1] * y[i] + m[2][2] * z[i];
+        auto distance = height / ray_z;
+        distance = distance > 0 ? distance : nan;
+        result_x[i] = initial_position.x + ray_x * distance;
+        result_y[i] = initial_position.y + ray_y * distance;
+        result_z[i] = initial_position.z + ray_z * distance;
+      }
+    });
+  }
+
+}  // namespace cpp_math
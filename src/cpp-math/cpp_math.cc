@@ -1,145 +1,264 @@
 #include <cpp-math/cpp_math.h>
+#include <cpp-math/trigonometry.h>
+#include <cpp-math/vector_expression.h>
+
+#include "instrumentation_hooks.h"
+#include "rotation_order.h"
 
 // #include <iostream>
-#include <memory>
+#include <algorithm>
+#include <array>
 #include <limits>
 #include <stdexcept>
 #include <cstdio>  // For size_t
 #include <cmath>
 
+namespace cpp_math
+{
+  namespace detail
+  {
+    template<typename T>
+    T getAngle(BasicHeliAngles<T> const& angles, HeliAngle angle) noexcept
+    {
+      switch(angle) {
+        case HeliAngle::Yaw: return angles.yaw;
+        case HeliAngle::Pitch: return angles.pitch;
+        case HeliAngle::Roll: return angles.roll;
+      }
+      return 0;
+    }
+
+    template<typename T>
+    bool close_to_zero(T value) noexcept
+    {
+      return std::abs(value) < std::numeric_limits<T>::epsilon() * 100;
+    }
+
+    template<typename T>
+    bool can_rotate(Vector3<T> const& v, HeliAngle const& angle) noexcept
+    {
+      switch(angle) {
+        case HeliAngle::Yaw: return not close_to_zero(v.x) or not close_to_zero(v.y);
+        case HeliAngle::Pitch: return not close_to_zero(v.x) or not close_to_zero(v.z);
+        case HeliAngle::Roll: return not close_to_zero(v.z) or not close_to_zero(v.y);
+      }
+      return false;
+    }
+
+    template float getAngle(HeliAnglesf const&, HeliAngle) noexcept;
+    template double getAngle(HeliAngles const&, HeliAngle) noexcept;
+    template bool close_to_zero(float) noexcept;
+    template bool close_to_zero(double) noexcept;
+    template bool can_rotate(Vector3f const&, HeliAngle const&) noexcept;
+    template bool can_rotate(Vector3d const&, HeliAngle const&) noexcept;
+  }  // namespace detail
+}  // namespace cpp_math
+
 namespace
 {
   using namespace cpp_math;
+  using detail::can_rotate;
+  using detail::close_to_zero;
+  using detail::getAngle;
 
-  double getAngle(HeliAngles const& angles, HeliAngle angle)
+  template<typename T>
+  BasicMat3<T> rotationMatrix(Axis axis, T s, T c) noexcept
   {
-    switch(angle) {
-      case HeliAngle::Yaw: return angles.yaw;
-      case HeliAngle::Pitch: return angles.pitch;
-      case HeliAngle::Roll: return angles.roll;
+    // clang-format off
+    switch(axis) {
+      case Axis::Z:
+        return BasicMat3<T>{{
+                {c,            -s,            0             },
+                {s,             c,            0             },
+                {0,             0,            1             }
+               }};
+      case Axis::X:
+        return BasicMat3<T>{{
+                {1,             0,             0            }, 
+                {0,             c,            -s            }, 
+                {0,             s,             c            }
+               }};
+      case Axis::Y:
+        return BasicMat3<T>{{
+                {c,             0,             s            }, 
+                {0,             1,             0            }, 
+                {-s,            0,             c            }
+               }};
     }
-    throw std::runtime_error("Unknown heli angle: " + std::to_string(static_cast<int>(angle)));
+    // clang-format on
+    return identityMatrix<T>();
   }
 
-  std::string angleToString(HeliAngle angle)
+  template<typename T>
+  BasicMat3<T> rotationMatrixFromDegrees(Axis axis, T degrees, TrigPolicy policy) noexcept
   {
-    switch(angle) {
-      case HeliAngle::Yaw: return "yaw";
-      case HeliAngle::Pitch: return "pitch";
-      case HeliAngle::Roll: return "roll";
+    if(policy == TrigPolicy::Standard) {
+      auto radians = degreesToRadians<T>(degrees);
+      return rotationMatrix<T>(axis, std::sin(radians), std::cos(radians));
     }
-    throw std::runtime_error("Unknown heli angle: " + std::to_string(static_cast<int>(angle)));
+    double s, c;
+    sincosDeg(degrees, s, c, policy);
+    return rotationMatrix<T>(axis, static_cast<T>(s), static_cast<T>(c));
   }
 
-  [[maybe_unused]] std::string anglesToString(std::vector<HeliAngle> const& angles)
+  Axis rotationAxis(HeliAngle angle) noexcept
   {
-    std::string result = "{";
-    for(auto angle : angles) {
-      result += angleToString(angle) + ", ";
+    switch(angle) {
+      case HeliAngle::Roll: return Axis::X;
+      case HeliAngle::Pitch: return Axis::Y;
+      case HeliAngle::Yaw: return Axis::Z;
     }
-    result += "}";
-    return result;
+    return Axis::X;
   }
 
-  bool close_to_zero(double value)
+  /// @brief Rotation by one heli angle, the matrix is calculated once and only if some order gets to it
+  template<typename T>
+  struct AngleRotation
   {
-    return std::abs(value) < std::numeric_limits<double>::epsilon() * 100;
+    HeliAngle angle;
+    T degrees;
+    bool is_zero;
+    bool has_matrix;
+    BasicMat3<T> matrix;
+  };
+
+  template<typename T>
+  using AngleRotations = std::array<AngleRotation<T>, 3>;
+
+  template<typename T>
+  AngleRotation<T>& findRotation(AngleRotations<T>& rotations, HeliAngle angle) noexcept
+  {
+    return rotations[static_cast<size_t>(angle)];
   }
 
-  bool can_rotate(Vector3d const& v, HeliAngle const& angle)
+  /// @brief Orders which differ only by positions of zero angles do the same rotations, they get the same key
+  template<typename T>
+  unsigned effectiveOrderKey(std::array<HeliAngle, 3> const& order, AngleRotations<T>& rotations) noexcept
   {
-    if(angle == HeliAngle::Yaw) {
-      return not close_to_zero(v.x) or not close_to_zero(v.y);
-    }
-    else if(angle == HeliAngle::Pitch) {
-      return not close_to_zero(v.x) or not close_to_zero(v.z);
-    }
-    else if(angle == HeliAngle::Roll) {
-      return not close_to_zero(v.z) or not close_to_zero(v.y);
+    unsigned key = 0;
+    for(auto angle : order) {
+      if(not findRotation(rotations, angle).is_zero) {
+        key = key * 4 + static_cast<unsigned>(angle) + 1;
+      }
     }
-    throw std::runtime_error("Unknown heli angle: " + std::to_string(static_cast<int>(angle)));
+    return key;
   }
 
-  std::unique_ptr<Vector3d> try_to_rotate(
-    Vector3d const& v,
-    HeliAngles const& angles,
-    std::vector<HeliAngle> const& angles_to_rotate
-  )
+  /// @return false if the order can not be applied, result is unspecified then
+  template<typename T>
+  bool try_to_rotate(
+    Vector3<T> const& v,
+    std::array<HeliAngle, 3> const& order,
+    AngleRotations<T>& rotations,
+    TrigPolicy policy,
+    Vector3<T>& result
+  ) noexcept
   {
-    auto result = v;
-    // std::cout << "Trying rotation: " << anglesToString(angles_to_rotate) << std::endl;
-
-    for(auto angle : angles_to_rotate) {
-      if (close_to_zero(getAngle(angles, angle))) {
+    result = v;
+    for(auto angle : order) {
+      auto& rotation = findRotation(rotations, angle);
+      if(rotation.is_zero) {
         continue;
       }
       if(not can_rotate(result, angle)) {
-        // std::cout << "Can't rotate " << angleToString(angle) << std::endl;
-        return {};
+        return false;
       }
-      result = rotateVector(result, heliAngleToRotationAxis(angle), getAngle(angles, angle));
+      if(not rotation.has_matrix) {
+        rotation.matrix = rotationMatrixFromDegrees(rotationAxis(angle), rotation.degrees, policy);
+        rotation.has_matrix = true;
+      }
+      result = multiplyMatrixByVector(rotation.matrix, result);
     }
-
-    return std::make_unique<Vector3d>(result);
+    return true;
   }
 
-
-  std::vector<std::vector<HeliAngle>> get_angles_permutations()
+  /**
+   * @brief Tries orders from detail::angles_permutations until one can be applied
+   * @note Does not allocate: orders come from a static table and failed orders are remembered
+   *       on the stack, so an order which does the same rotations as a failed one is skipped
+   */
+  template<typename T>
+  bool try_to_rotate(Vector3<T> const& v, BasicHeliAngles<T> const& angles, TrigPolicy policy, Vector3<T>& result) noexcept
   {
-    return {
-      {HeliAngle::Roll, HeliAngle::Pitch, HeliAngle::Yaw},
-      {HeliAngle::Roll, HeliAngle::Yaw, HeliAngle::Pitch},
-      {HeliAngle::Yaw, HeliAngle::Roll, HeliAngle::Pitch},
-      {HeliAngle::Yaw, HeliAngle::Pitch, HeliAngle::Roll},
-      {HeliAngle::Pitch, HeliAngle::Roll, HeliAngle::Yaw},
-      {HeliAngle::Pitch, HeliAngle::Yaw, HeliAngle::Roll},
-    };
-  } 
-
-  std::unique_ptr<Vector3d> try_to_rotate(Vector3d const& v, HeliAngles const& angles)
-  {
-    for (auto angles_triplet : get_angles_permutations()) {
-      auto result = try_to_rotate(v, angles, angles_triplet);
-      if(result) {
-        return result;
-      }
+    AngleRotations<T> rotations;
+    for(auto angle : {HeliAngle::Roll, HeliAngle::Pitch, HeliAngle::Yaw}) {
+      auto degrees = getAngle(angles, angle);
+      findRotation(rotations, angle) = AngleRotation<T>{angle, degrees, close_to_zero(degrees), false, BasicMat3<T>{}};
     }
 
-    return {};
+    std::array<unsigned, detail::angles_permutations_count> failed_keys;
+    size_t failed_count = 0;
+    for(size_t index = 0; index < detail::angles_permutations_count; ++index) {
+      auto const& order = detail::angles_permutations[index];
+      auto key = effectiveOrderKey(order, rotations);
+      auto failed_end = failed_keys.begin() + failed_count;
+      if(std::find(failed_keys.begin(), failed_end, key) != failed_end) {
+        continue;
+      }
+      detail::countOrderTried();
+      if(try_to_rotate(v, order, rotations, policy, result)) {
+        detail::countRotationOrder(index);
+        return true;
+      }
+      failed_keys[failed_count++] = key;
+    }
+    return false;
   }
 
 }  // namespace
 
 namespace cpp_math
 {
-  Vector3d calculatePointByDistanceAndAngles(
-    double distance,
-    Vector3d initial_position,
-    HeliAngles angles,
-    CameraAngles camera_angles
-  )
+  template<typename T>
+  Vector3<T> calculatePointByDistanceAndAngles(
+    NonDeduced<T> distance,
+    Vector3<T> initial_position,
+    BasicHeliAngles<T> angles,
+    BasicCameraAngles<T> camera_angles
+  ) noexcept
+  {
+    return calculatePointByDistanceAndAngles<T>(distance, initial_position, angles, camera_angles, TrigPolicy::Standard);
+  }
+
+  template<typename T>
+  Vector3<T> calculatePointByDistanceAndAngles(
+    NonDeduced<T> distance,
+    Vector3<T> initial_position,
+    BasicHeliAngles<T> angles,
+    BasicCameraAngles<T> camera_angles,
+    TrigPolicy policy
+  ) noexcept
   {
-    Vector3d normalizedVector = Vector3d{1, 0, 0};
+    detail::ScopedCall call(InstrumentedFunction::CalculatePointByDistanceAndAngles);
+    Vector3<T> normalizedVector = Vector3<T>{1, 0, 0};
     angles.pitch += camera_angles.pitch;
     angles.yaw += camera_angles.yaw;
-    // std::cout << "Result heli angles: " << angles << std::endl;
-    auto result = rotateVector(normalizedVector, angles);
+    auto result = rotateVector(normalizedVector, angles, policy);
     normalizedVector = result;
-    // std::cout << "Normalized vector: " << normalizedVector << std::endl;
 
-    return addVectors(initial_position, multiplyVectorByScalar(normalizedVector, distance));
+    return initial_position + distance * normalizedVector;
+  }
+
+  template<typename T>
+  Vector3<T> rotateVector(Vector3<T> const& v, BasicHeliAngles<T> const& angles) noexcept
+  {
+    return rotateVector(v, angles, TrigPolicy::Standard);
   }
 
-  Vector3d rotateVector(Vector3d const& v, HeliAngles const& angles)
+  template<typename T>
+  Vector3<T> rotateVector(Vector3<T> const& v, BasicHeliAngles<T> const& angles, TrigPolicy policy) noexcept
   {
+    detail::ScopedCall call(InstrumentedFunction::RotateVector);
     if(angles.roll == 0 && angles.pitch == 0 && angles.yaw == 0) {
+      detail::countZeroAngles();
       return v;
     }
-    auto result = try_to_rotate(v, angles);
-    if(not result) {
+    Vector3<T> result;
+    if(not try_to_rotate(v, angles, policy, result)) {
+      detail::countFallback();
       return v;
     }
-    return *result;
+    return result;
   }
 
   Axis heliAngleToRotationAxis(HeliAngle angle)
@@ -152,55 +271,59 @@ namespace cpp_math
     throw std::runtime_error("Unknown heli angle: " + std::to_string(static_cast<int>(angle)));
   }
 
-  Vector3d rotateVector(Vector3d const& v, Axis axis, double angle)
+  template<typename T>
+  Vector3<T> rotateVector(Vector3<T> const& v, Axis axis, NonDeduced<T> angle)
+  {
+    return rotateVector(v, axis, angle, TrigPolicy::Standard);
+  }
+
+  template<typename T>
+  Vector3<T> rotateVector(Vector3<T> const& v, Axis axis, NonDeduced<T> angle, TrigPolicy policy)
   {
-    auto radians = degreesToRadians(angle);
-    auto rotation_matrix = calculateRotationMatrix(axis, radians);
+    auto rotation_matrix = calculateRotationMatrixFromDegrees<T>(axis, angle, policy);
     return multiplyMatrixByVector(rotation_matrix, v);
   }
 
-  Matrix3d calculateRotationMatrix(Axis axis, double radians)
+  template<typename T>
+  BasicMat3<T> calculateRotationMatrix(Axis axis, NonDeduced<T> radians)
   {
-    // clang-format off
-    switch(axis) {
-      case Axis::Z:
-        return {
-                {cos(radians), -sin(radians), 0             },
-                {sin(radians),  cos(radians), 0             },
-                {0,             0,            1             }
-               };
-      case Axis::X:
-        return {
-                {1,             0,             0            }, 
-                {0,             cos(radians), -sin(radians) }, 
-                {0,             sin(radians),  cos(radians) }
-               };
-      case Axis::Y:
-        return {
-                {cos(radians),  0,             sin(radians) }, 
-                {0,             1,             0            }, 
-                {-sin(radians), 0,             cos(radians) }
-               };
+    if(axis != Axis::X and axis != Axis::Y and axis != Axis::Z) {
+      throw std::runtime_error("Invalid axis");
     }
-    // clang-format on
-    throw std::runtime_error("Invalid axis");
+    return rotationMatrix<T>(axis, std::sin(radians), std::cos(radians));
+  }
+
+  template<typename T>
+  BasicMat3<T> calculateRotationMatrixFromDegrees(Axis axis, NonDeduced<T> degrees, TrigPolicy policy)
+  {
+    if(axis != Axis::X and axis != Axis::Y and axis != Axis::Z) {
+      throw std::runtime_error("Invalid axis");
+    }
+    return rotationMatrixFromDegrees<T>(axis, degrees, policy);
   }
 
-  double degreesToRadians(double degrees) { return degrees * M_PI / 180.0; }
+  template<typename T>
+  T degreesToRadians(NonDeduced<T> degrees) noexcept
+  {
+    return degrees * static_cast<T>(M_PI) / static_cast<T>(180.0);
+  }
 
-  Vector3d addVectors(Vector3d const& v1, Vector3d const& v2)
+  template<typename T>
+  Vector3<T> addVectors(Vector3<T> const& v1, Vector3<T> const& v2) noexcept
   {
-    return Vector3d{v1.x + v2.x, v1.y + v2.y, v1.z + v2.z};
+    return Vector3<T>{v1.x + v2.x, v1.y + v2.y, v1.z + v2.z};
   }
 
-  Vector3d subtractVectors(Vector3d const& v1, Vector3d const& v2)
+  template<typename T>
+  Vector3<T> subtractVectors(Vector3<T> const& v1, Vector3<T> const& v2) noexcept
   {
-    return Vector3d{v1.x - v2.x, v1.y - v2.y, v1.z - v2.z};
+    return Vector3<T>{v1.x - v2.x, v1.y - v2.y, v1.z - v2.z};
   }
 
-  Vector3d multiplyVectorByScalar(Vector3d const& v, double scalar)
+  template<typename T>
+  Vector3<T> multiplyVectorByScalar(Vector3<T> const& v, NonDeduced<T> scalar) noexcept
   {
-    return Vector3d{v.x * scalar, v.y * scalar, v.z * scalar};
+    return Vector3<T>{v.x * scalar, v.y * scalar, v.z * scalar};
   }
 
   Vector3d multiplyMatrixByVector(Matrix3d const& matrix, Vector3d const& v)
@@ -244,7 +367,25 @@ namespace cpp_math
     return result;
   }
 
-  std::ostream& operator<<(std::ostream& os, Vector3d const& v)
+  Mat3 toMat3(Matrix3d const& matrix)
+  {
+    if(matrix.size() != 3 || matrix[0].size() != 3 || matrix[1].size() != 3
+       || matrix[2].size() != 3)
+    {
+      throw std::runtime_error("Matrix must be 3x3");
+    }
+
+    Mat3 result{};
+    for(size_t row = 0; row < 3; ++row) {
+      for(size_t col = 0; col < 3; ++col) {
+        result[row][col] = matrix[row][col];
+      }
+    }
+    return result;
+  }
+
+  template<typename T>
+  std::ostream& operator<<(std::ostream& os, Vector3<T> const& v)
   {
     return os << "(" << v.x << ", " << v.y << ", " << v.z << ")";
   }
@@ -258,14 +399,53 @@ namespace cpp_math
     return os;
   }
 
-  std::ostream& operator<<(std::ostream& os, HeliAngles const& angles)
+  template<typename T>
+  std::ostream& operator<<(std::ostream& os, BasicMat3<T> const& matrix)
+  {
+    for(size_t row = 0; row < 3; ++row) {
+      os << "(" << matrix[row][0] << ", " << matrix[row][1] << ", " << matrix[row][2] << ")"
+         << std::endl;
+    }
+    return os;
+  }
+
+  template<typename T>
+  std::ostream& operator<<(std::ostream& os, BasicHeliAngles<T> const& angles)
   {
     return os << "Roll: " << angles.roll << ", Pitch: " << angles.pitch << ", Yaw: " << angles.yaw;
   }
 
-  std::ostream& operator<<(std::ostream& os, CameraAngles const& angles)
+  template<typename T>
+  std::ostream& operator<<(std::ostream& os, BasicCameraAngles<T> const& angles)
   {
     return os << "Pitch: " << angles.pitch << ", Yaw: " << angles.yaw;
   }
 
+#define CPP_MATH_INSTANTIATE(T)                                                                                    \
+  template Vector3<T> calculatePointByDistanceAndAngles(                                                           \
+    NonDeduced<T>, Vector3<T>, BasicHeliAngles<T>, BasicCameraAngles<T>                                            \
+  ) noexcept;                                                                                                      \
+  template Vector3<T> calculatePointByDistanceAndAngles(                                                           \
+    NonDeduced<T>, Vector3<T>, BasicHeliAngles<T>, BasicCameraAngles<T>, TrigPolicy                                \
+  ) noexcept;                                                                                                      \
+  template Vector3<T> rotateVector(Vector3<T> const&, BasicHeliAngles<T> const&) noexcept;                         \
+  template Vector3<T> rotateVector(Vector3<T> const&, BasicHeliAngles<T> const&, TrigPolicy) noexcept;             \
+  template Vector3<T> rotateVector(Vector3<T> const&, Axis, NonDeduced<T>);                                        \
+  template Vector3<T> rotateVector(Vector3<T> const&, Axis, NonDeduced<T>, TrigPolicy);                            \
+  template BasicMat3<T> calculateRotationMatrix<T>(Axis, NonDeduced<T>);                                           \
+  template BasicMat3<T> calculateRotationMatrixFromDegrees<T>(Axis, NonDeduced<T>, TrigPolicy);                    \
+  template T degreesToRadians<T>(NonDeduced<T>) noexcept;                                                          \
+  template Vector3<T> addVectors(Vector3<T> const&, Vector3<T> const&) noexcept;                                   \
+  template Vector3<T> subtractVectors(Vector3<T> const&, Vector3<T> const&) noexcept;                              \
+  template Vector3<T> multiplyVectorByScalar(Vector3<T> const&, NonDeduced<T>) noexcept;                           \
+  template std::ostream& operator<<(std::ostream&, Vector3<T> const&);                                             \
+  template std::ostream& operator<<(std::ostream&, BasicMat3<T> const&);                                           \
+  template std::ostream& operator<<(std::ostream&, BasicHeliAngles<T> const&);                                     \
+  template std::ostream& operator<<(std::ostream&, BasicCameraAngles<T> const&);
+
+  CPP_MATH_INSTANTIATE(float)
+  CPP_MATH_INSTANTIATE(double)
+
+#undef CPP_MATH_INSTANTIATE
+
 }  // namespace cpp_math
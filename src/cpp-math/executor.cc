@@ -0,0 +1,280 @@
+#include <cpp-math/executor.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+  using namespace cpp_math;
+
+  // Pool whose chunk runs on this thread, nested batches of the same pool run on the thread itself
+  thread_local ThreadPoolExecutor const* current_pool = nullptr;
+
+  constexpr uint64_t packRange(uint64_t front, uint64_t back) noexcept
+  {
+    return front << 32 | back;
+  }
+
+  constexpr uint64_t rangeFront(uint64_t range) noexcept
+  {
+    return range >> 32;
+  }
+
+  constexpr uint64_t rangeBack(uint64_t range) noexcept
+  {
+    return range & 0xffffffffu;
+  }
+
+  /// @brief An exception of a chunk leaves the loop, so the remaining chunks are skipped
+  void runSequentially(Executor::ChunkTask const& task)
+  {
+    auto chunks_count = task.chunksCount();
+    for(size_t chunk = 0; chunk < chunks_count; ++chunk) {
+      task.runChunk(chunk);
+    }
+  }
+
+#if defined(__linux__)
+  /// @brief Parses cpulist of sysfs, for example 0-3,8-11
+  std::vector<int> parseCpuList(std::string const& list)
+  {
+    std::vector<int> result;
+    std::stringstream stream(list);
+    std::string item;
+    while(std::getline(stream, item, ',')) {
+      auto dash = item.find('-');
+      auto first = std::stoi(item.substr(0, dash));
+      auto last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+      for(auto cpu = first; cpu <= last; ++cpu) {
+        result.push_back(cpu);
+      }
+    }
+    return result;
+  }
+
+  /// @return CPUs this process may run on, node by node
+  std::vector<int> cpusByNumaNode()
+  {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+      return {};
+    }
+    std::vector<int> result;
+    for(int node = 0;; ++node) {
+      std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      std::string list;
+      if(not std::getline(file, list)) {
+        break;
+      }
+      for(auto cpu : parseCpuList(list)) {
+        if(cpu < CPU_SETSIZE and CPU_ISSET(cpu, &allowed)) {
+          result.push_back(cpu);
+        }
+      }
+    }
+    if(result.empty()) {
+      // No NUMA information, CPUs in their order
+      for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if(CPU_ISSET(cpu, &allowed)) {
+          result.push_back(cpu);
+        }
+      }
+    }
+    return result;
+  }
+
+  void pinThread(std::thread& thread, int cpu)
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    // Pinning is a hint, the pool works without it
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+  }
+#endif
+}  // namespace
+
+namespace cpp_math
+{
+  void SequentialExecutor::run(ChunkTask const& task)
+  {
+    runSequentially(task);
+  }
+
+  SequentialExecutor& sequentialExecutor() noexcept
+  {
+    static SequentialExecutor executor;
+    return executor;
+  }
+
+  ThreadPoolExecutor::ThreadPoolExecutor(size_t threads, CpuPinning pinning) :
+    threads_count_(threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads),
+    ranges_(new Range[threads_count_]),
+    threads_(),
+    generation_(0),
+    stop_(false),
+    task_(nullptr),
+    error_(),
+    failed_(false),
+    remaining_(0),
+    active_(0),
+    steals_(0)
+  {
+    for(size_t i = 0; i < threads_count_; ++i) {
+      ranges_[i].value.store(0, std::memory_order_relaxed);
+    }
+#if defined(__linux__)
+    auto cpus = pinning == CpuPinning::NumaCompact ? cpusByNumaNode() : std::vector<int>();
+#else
+    (void)pinning;
+#endif
+    for(size_t i = 1; i < threads_count_; ++i) {
+      threads_.emplace_back([this, i]() { workerLoop(i); });
+#if defined(__linux__)
+      if(not cpus.empty()) {
+        pinThread(threads_.back(), cpus[i % cpus.size()]);
+      }
+#endif
+    }
+  }
+
+  ThreadPoolExecutor::~ThreadPoolExecutor()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for(auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  void ThreadPoolExecutor::run(ChunkTask const& task)
+  {
+    auto chunks_count = task.chunksCount();
+    if(threads_count_ == 1 or chunks_count == 1 or current_pool == this
+       or chunks_count > std::numeric_limits<uint32_t>::max())
+    {
+      runSequentially(task);
+      return;
+    }
+
+    std::lock_guard<std::mutex> batch_lock(batch_mutex_);
+    // Every thread starts with a contiguous part, so neighbouring chunks stay on one thread
+    for(size_t i = 0; i < threads_count_; ++i) {
+      ranges_[i].value.store(
+        packRange(chunks_count * i / threads_count_, chunks_count * (i + 1) / threads_count_), std::memory_order_relaxed
+      );
+    }
+    task_ = &task;
+    failed_.store(false, std::memory_order_relaxed);
+    remaining_.store(chunks_count, std::memory_order_relaxed);
+    active_.store(threads_count_ - 1, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++generation_;
+    }
+    wake_.notify_all();
+
+    auto outer_pool = current_pool;
+    current_pool = this;
+    work(0);
+    current_pool = outer_pool;
+    // Workers may still look for chunks to steal, the task must outlive them
+    while(active_.load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+    task_ = nullptr;
+
+    std::exception_ptr error;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::swap(error, error_);
+    }
+    if(error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  void ThreadPoolExecutor::work(size_t index)
+  {
+    auto& own = ranges_[index].value;
+    while(remaining_.load(std::memory_order_acquire) != 0) {
+      size_t chunk = 0;
+      auto found = false;
+      auto range = own.load(std::memory_order_acquire);
+      while(rangeFront(range) < rangeBack(range)) {
+        if(own.compare_exchange_weak(range, packRange(rangeFront(range) + 1, rangeBack(range)), std::memory_order_acq_rel)) {
+          chunk = rangeFront(range);
+          found = true;
+          break;
+        }
+      }
+
+      // Own range is empty and stays so, only its owner makes ranges longer
+      for(size_t i = 1; i < threads_count_ and not found; ++i) {
+        auto& victim = ranges_[(index + i) % threads_count_].value;
+        auto victim_range = victim.load(std::memory_order_acquire);
+        while(rangeFront(victim_range) < rangeBack(victim_range)) {
+          auto back = rangeBack(victim_range);
+          auto taken = (back - rangeFront(victim_range) + 1) / 2;
+          if(victim.compare_exchange_weak(victim_range, packRange(rangeFront(victim_range), back - taken), std::memory_order_acq_rel)) {
+            chunk = back - taken;
+            own.store(packRange(back - taken + 1, back), std::memory_order_release);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            found = true;
+            break;
+          }
+        }
+      }
+
+      if(not found) {
+        // The last chunks are running on other threads
+        std::this_thread::yield();
+        continue;
+      }
+      // After a failure chunks are still taken, so the ranges run out, but they are not run
+      if(not failed_.load(std::memory_order_relaxed)) {
+        try {
+          task_->runChunk(chunk);
+        } catch(...) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if(not error_) {
+            error_ = std::current_exception();
+          }
+          failed_.store(true, std::memory_order_relaxed);
+        }
+      }
+      remaining_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  }
+
+  void ThreadPoolExecutor::workerLoop(size_t index)
+  {
+    current_pool = this;
+    uint64_t seen_generation = 0;
+    while(true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&]() { return stop_ or generation_ != seen_generation; });
+        if(stop_) {
+          return;
+        }
+        seen_generation = generation_;
+      }
+      work(index);
+      active_.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+}  // namespace cpp_math
@@ -0,0 +1,213 @@
+#include <cpp-math/geodetic.h>
+#include <cpp-math/trigonometry.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  using namespace cpp_math;
+
+  constexpr double radians_to_degrees = 180 / 3.14159265358979323846;
+
+  constexpr double a = wgs84::semi_major_axis;
+  constexpr double b = wgs84::semi_minor_axis;
+  constexpr double e2 = wgs84::eccentricity2;
+  // Square of the second eccentricity
+  constexpr double ep2 = (a * a - b * b) / (b * b);
+
+  // Chunk of batch conversions which keeps sin and cos on the stack
+  constexpr size_t chunk_size = 256;
+
+  Vector3d geodeticToEcef(double sin_latitude, double cos_latitude, double sin_longitude, double cos_longitude, double altitude)
+    noexcept
+  {
+    // Radius of curvature in the prime vertical
+    auto n = a / std::sqrt(1 - e2 * sin_latitude * sin_latitude);
+    auto horizontal = (n + altitude) * cos_latitude;
+    return {horizontal * cos_longitude, horizontal * sin_longitude, (n * (1 - e2) + altitude) * sin_latitude};
+  }
+
+  Mat3 calculateEcefToEnuMatrix(Geodetic const& origin) noexcept
+  {
+    double sin_latitude, cos_latitude, sin_longitude, cos_longitude;
+    sincosDeg(origin.latitude, sin_latitude, cos_latitude);
+    sincosDeg(origin.longitude, sin_longitude, cos_longitude);
+    return Mat3{{
+      {-sin_longitude, cos_longitude, 0},
+      {-sin_latitude * cos_longitude, -sin_latitude * sin_longitude, cos_latitude},
+      {cos_latitude * cos_longitude, cos_latitude * sin_longitude, sin_latitude}
+    }};
+  }
+
+  Mat3 transpose(Mat3 const& m) noexcept
+  {
+    return Mat3{{{m[0][0], m[1][0], m[2][0]}, {m[0][1], m[1][1], m[2][1]}, {m[0][2], m[1][2], m[2][2]}}};
+  }
+
+  /// @brief Frame of the last origin used by the thread
+  LocalTangentFrame const& frameOf(Geodetic const& origin) noexcept
+  {
+    thread_local LocalTangentFrame frame(Geodetic{0, 0, 0});
+    auto const& cached = frame.origin();
+    if(cached.latitude != origin.latitude or cached.longitude != origin.longitude or cached.altitude != origin.altitude) {
+      frame = LocalTangentFrame(origin);
+    }
+    return frame;
+  }
+}  // namespace
+
+namespace cpp_math
+{
+  Vector3d geodeticToEcef(Geodetic const& point) noexcept
+  {
+    double sin_latitude, cos_latitude, sin_longitude, cos_longitude;
+    sincosDeg(point.latitude, sin_latitude, cos_latitude);
+    sincosDeg(point.longitude, sin_longitude, cos_longitude);
+    return ::geodeticToEcef(sin_latitude, cos_latitude, sin_longitude, cos_longitude, point.altitude);
+  }
+
+  Geodetic ecefToGeodetic(Vector3d const& ecef) noexcept
+  {
+    // J. Zhu, "Conversion of Earth-centered Earth-fixed coordinates to geodetic coordinates", 1994,
+    // the closed form of Heikkinen
+    auto z2 = ecef.z * ecef.z;
+    auto p2 = ecef.x * ecef.x + ecef.y * ecef.y;
+    auto p = std::sqrt(p2);
+    auto f = 54 * b * b * z2;
+    auto g = p2 + (1 - e2) * z2 - e2 * (a * a - b * b);
+    auto c = e2 * e2 * f * p2 / (g * g * g);
+    auto s = std::cbrt(1 + c + std::sqrt(c * c + 2 * c));
+    auto k = s + 1 + 1 / s;
+    auto big_p = f / (3 * k * k * g * g);
+    auto q = std::sqrt(1 + 2 * e2 * e2 * big_p);
+    auto r0 = -(big_p * e2 * p) / (1 + q)
+            + std::sqrt(std::max(0.0, 0.5 * a * a * (1 + 1 / q) - big_p * (1 - e2) * z2 / (q * (1 + q)) - 0.5 * big_p * p2));
+    auto t = p - e2 * r0;
+    auto u = std::sqrt(t * t + z2);
+    auto v = std::sqrt(t * t + (1 - e2) * z2);
+    auto z0 = b * b * ecef.z / (a * v);
+    return {
+      std::atan2(ecef.z + ep2 * z0, p) * radians_to_degrees,
+      std::atan2(ecef.y, ecef.x) * radians_to_degrees,
+      u * (1 - b * b / (a * v))
+    };
+  }
+
+  void geodeticToEcef(size_t count, GeodeticArrays points, Vector3dArrays result)
+  {
+    double sin_latitude[chunk_size], cos_latitude[chunk_size], sin_longitude[chunk_size], cos_longitude[chunk_size];
+    for(size_t begin = 0; begin < count; begin += chunk_size) {
+      auto size = std::min(chunk_size, count - begin);
+      sincosDeg(size, points.latitude + begin, sin_latitude, cos_latitude);
+      sincosDeg(size, points.longitude + begin, sin_longitude, cos_longitude);
+      for(size_t i = 0; i < size; ++i) {
+        auto ecef = ::geodeticToEcef(
+          sin_latitude[i], cos_latitude[i], sin_longitude[i], cos_longitude[i], points.altitude[begin + i]
+        );
+        result.x[begin + i] = ecef.x;
+        result.y[begin + i] = ecef.y;
+        result.z[begin + i] = ecef.z;
+      }
+    }
+  }
+
+  void ecefToGeodetic(size_t count, ConstVector3dArrays ecef, GeodeticResultArrays result) noexcept
+  {
+    for(size_t i = 0; i < count; ++i) {
+      auto point = ecefToGeodetic(Vector3d{ecef.x[i], ecef.y[i], ecef.z[i]});
+      result.latitude[i] = point.latitude;
+      result.longitude[i] = point.longitude;
+      result.altitude[i] = point.altitude;
+    }
+  }
+
+  LocalTangentFrame::LocalTangentFrame(Geodetic const& origin) noexcept :
+    origin_(origin),
+    origin_ecef_(geodeticToEcef(origin)),
+    ecef_to_enu_(calculateEcefToEnuMatrix(origin)),
+    enu_to_ecef_(transpose(ecef_to_enu_))
+  {}
+
+  Vector3d LocalTangentFrame::ecefToEnu(Vector3d const& ecef) const noexcept
+  {
+    return multiplyMatrixByVector(ecef_to_enu_, subtractVectors(ecef, origin_ecef_));
+  }
+
+  Vector3d LocalTangentFrame::enuToEcef(Vector3d const& enu) const noexcept
+  {
+    return addVectors(origin_ecef_, multiplyMatrixByVector(enu_to_ecef_, enu));
+  }
+
+  Vector3d LocalTangentFrame::geodeticToEnu(Geodetic const& point) const noexcept
+  {
+    return ecefToEnu(geodeticToEcef(point));
+  }
+
+  Geodetic LocalTangentFrame::enuToGeodetic(Vector3d const& enu) const noexcept
+  {
+    return ecefToGeodetic(enuToEcef(enu));
+  }
+
+  void LocalTangentFrame::ecefToEnu(size_t count, ConstVector3dArrays ecef, Vector3dArrays enu) const noexcept
+  {
+    auto const& m = ecef_to_enu_;
+    auto const origin = origin_ecef_;
+    for(size_t i = 0; i < count; ++i) {
+      auto x = ecef.x[i] - origin.x;
+      auto y = ecef.y[i] - origin.y;
+      auto z = ecef.z[i] - origin.z;
+      enu.x[i] = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+      enu.y[i] = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+      enu.z[i] = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+    }
+  }
+
+  void LocalTangentFrame::enuToEcef(size_t count, ConstVector3dArrays enu, Vector3dArrays ecef) const noexcept
+  {
+    auto const& m = enu_to_ecef_;
+    auto const origin = origin_ecef_;
+    for(size_t i = 0; i < count; ++i) {
+      auto x = enu.x[i];
+      auto y = enu.y[i];
+      auto z = enu.z[i];
+      ecef.x[i] = origin.x + (m[0][0] * x + m[0][1] * y + m[0][2] * z);
+      ecef.y[i] = origin.y + (m[1][0] * x + m[1][1] * y + m[1][2] * z);
+      ecef.z[i] = origin.z + (m[2][0] * x + m[2][1] * y + m[2][2] * z);
+    }
+  }
+
+  void LocalTangentFrame::geodeticToEnu(size_t count, GeodeticArrays points, Vector3dArrays enu) const
+  {
+    geodeticToEcef(count, points, enu);
+    ecefToEnu(count, {enu.x, enu.y, enu.z}, enu);
+  }
+
+  void LocalTangentFrame::enuToGeodetic(size_t count, ConstVector3dArrays enu, GeodeticResultArrays result) const noexcept
+  {
+    double x[chunk_size], y[chunk_size], z[chunk_size];
+    for(size_t begin = 0; begin < count; begin += chunk_size) {
+      auto size = std::min(chunk_size, count - begin);
+      enuToEcef(size, {enu.x + begin, enu.y + begin, enu.z + begin}, {x, y, z});
+      ecefToGeodetic(
+        size, {x, y, z}, {result.latitude + begin, result.longitude + begin, result.altitude + begin}
+      );
+    }
+  }
+
+  Vector3d geodeticToEnu(Geodetic const& point, Geodetic const& origin) noexcept
+  {
+    return frameOf(origin).geodeticToEnu(point);
+  }
+
+  Geodetic enuToGeodetic(Vector3d const& enu, Geodetic const& origin) noexcept
+  {
+    return frameOf(origin).enuToGeodetic(enu);
+  }
+
+  std::ostream& operator<<(std::ostream& os, Geodetic const& point)
+  {
+    return os << "Latitude: " << point.latitude << ", Longitude: " << point.longitude << ", Altitude: " << point.altitude;
+  }
+
+}  // namespace cpp_math
@@ -0,0 +1,169 @@
+#include <cpp-math/heli_attitude.h>
+
+#include "rotation_order.h"
+
+namespace
+{
+  using namespace cpp_math;
+
+  constexpr size_t no_order = detail::angles_permutations_count;
+
+  double dot(Vector3d const& v1, Vector3d const& v2)
+  {
+    return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+  }
+
+  Vector3d matrixRow(Mat3 const& matrix, size_t row)
+  {
+    return Vector3d{matrix[row][0], matrix[row][1], matrix[row][2]};
+  }
+
+  /// @return Indices of vector components can_rotate looks at for the given angle
+  std::array<size_t, 2> checkedComponents(HeliAngle angle)
+  {
+    switch(angle) {
+      case HeliAngle::Yaw: return {{0, 1}};
+      case HeliAngle::Pitch: return {{0, 2}};
+      case HeliAngle::Roll: return {{2, 1}};
+    }
+    return {{0, 1}};
+  }
+
+  /// @brief Rotations of every angle, trigonometry is done once per angle. Zero angles are left empty
+  std::array<Mat3, 3> angleRotations(HeliAngles const& angles, TrigPolicy policy)
+  {
+    std::array<Mat3, 3> rotations;
+    for(auto angle : {HeliAngle::Roll, HeliAngle::Pitch, HeliAngle::Yaw}) {
+      auto value = detail::getAngle(angles, angle);
+      if(not detail::close_to_zero(value)) {
+        rotations[static_cast<size_t>(angle)] = calculateRotationMatrixFromDegrees(heliAngleToRotationAxis(angle), value, policy);
+      }
+    }
+    return rotations;
+  }
+
+  /// @brief Checked components of the X axis rotated so far, the same ones can_rotate looks at
+  bool canRotateX(Mat3 const& composed, HeliAngle angle) noexcept
+  {
+    auto nonzero = [&](size_t row) { return not detail::close_to_zero(composed[row][0]); };
+    switch(angle) {
+      case HeliAngle::Yaw: return nonzero(0) or nonzero(1);
+      case HeliAngle::Pitch: return nonzero(0) or nonzero(2);
+      case HeliAngle::Roll: return nonzero(2) or nonzero(1);
+    }
+    return false;
+  }
+
+  /// @brief Composes only the first order which rotateVector can apply to the X axis
+  Mat3 resolveDirectionMatrix(HeliAngles const& angles, std::array<Mat3, 3> const& rotations)
+  {
+    for(auto const& order : detail::angles_permutations) {
+      auto composed = identityMatrix();
+      bool applied = true;
+      for(auto angle : order) {
+        if(detail::close_to_zero(detail::getAngle(angles, angle))) {
+          continue;
+        }
+        if(not canRotateX(composed, angle)) {
+          applied = false;
+          break;
+        }
+        composed = composeRotations(composed, rotations[static_cast<size_t>(angle)]);
+      }
+      if(applied) {
+        return composed;
+      }
+    }
+    return identityMatrix();
+  }
+
+  HeliAngles addCameraAngles(HeliAngles angles, CameraAngles const& camera_angles)
+  {
+    angles.pitch += camera_angles.pitch;
+    angles.yaw += camera_angles.yaw;
+    return angles;
+  }
+}  // namespace
+
+namespace cpp_math
+{
+  HeliAttitude::HeliAttitude(HeliAngles const& angles, TrigPolicy policy) :
+    angles_(angles),
+    is_zero_(angles.roll == 0 && angles.pitch == 0 && angles.yaw == 0),
+    orders_(),
+    direction_matrix_(identityMatrix()),
+    direction_()
+  {
+    // Every order uses the same three rotations
+    auto const rotations = angleRotations(angles_, policy);
+    for(size_t i = 0; i < orders_.size(); ++i) {
+      auto& order = orders_[i];
+      order.steps_count = 0;
+      order.composed = identityMatrix();
+      for(auto angle : detail::angles_permutations[i]) {
+        auto value = detail::getAngle(angles_, angle);
+        if(detail::close_to_zero(value)) {
+          continue;
+        }
+        auto components = checkedComponents(angle);
+        order.check_rows[order.steps_count] = {
+          {matrixRow(order.composed, components[0]), matrixRow(order.composed, components[1])}
+        };
+        order.composed = composeRotations(order.composed, rotations[static_cast<size_t>(angle)]);
+        ++order.steps_count;
+      }
+    }
+
+    direction_ = apply(Vector3d{1, 0, 0});
+    if(not is_zero_) {
+      direction_matrix_ = resolveDirectionMatrix(angles_, rotations);
+    }
+  }
+
+  Mat3 HeliAttitude::directionMatrix(HeliAngles const& angles, TrigPolicy policy)
+  {
+    if(angles.roll == 0 && angles.pitch == 0 && angles.yaw == 0) {
+      return identityMatrix();
+    }
+    return resolveDirectionMatrix(angles, angleRotations(angles, policy));
+  }
+
+  HeliAttitude::HeliAttitude(HeliAngles const& angles, CameraAngles const& camera_angles, TrigPolicy policy) :
+    HeliAttitude(addCameraAngles(angles, camera_angles), policy)
+  {}
+
+  size_t HeliAttitude::findOrder(Vector3d const& v) const noexcept
+  {
+    for(size_t i = 0; i < orders_.size(); ++i) {
+      auto const& order = orders_[i];
+      bool can_rotate = true;
+      for(size_t step = 0; step < order.steps_count && can_rotate; ++step) {
+        auto const& rows = order.check_rows[step];
+        can_rotate = not detail::close_to_zero(dot(rows[0], v))
+                  or not detail::close_to_zero(dot(rows[1], v));
+      }
+      if(can_rotate) {
+        return i;
+      }
+    }
+    return no_order;
+  }
+
+  Vector3d HeliAttitude::apply(Vector3d const& v) const noexcept
+  {
+    if(is_zero_) {
+      return v;
+    }
+    auto order = findOrder(v);
+    if(order == no_order) {
+      return v;
+    }
+    return multiplyMatrixByVector(orders_[order].composed, v);
+  }
+
+  Vector3d HeliAttitude::calculatePoint(double distance, Vector3d const& initial_position) const noexcept
+  {
+    return addVectors(initial_position, multiplyVectorByScalar(direction_, distance));
+  }
+
+}  // namespace cpp_math
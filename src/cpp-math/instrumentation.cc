@@ -0,0 +1,201 @@
+#include <cpp-math/instrumentation.h>
+
+#include "instrumentation_hooks.h"
+#include "rotation_order.h"
+
+#include <mutex>
+#include <ostream>
+
+#if defined(CPP_MATH_INSTRUMENTATION)
+namespace cpp_math
+{
+  namespace detail
+  {
+    namespace
+    {
+      /**
+       * @brief Counters of live threads and the sum of exited ones
+       * @note Never destroyed, threads may exit after static destructors have run
+       */
+      struct Registry
+      {
+        std::mutex mutex;
+        ThreadCounters* live = nullptr;
+        InstrumentationSnapshot exited;
+      };
+
+      Registry& registry()
+      {
+        static auto* const result = new Registry();
+        return *result;
+      }
+
+      void addCounters(ThreadCounters const& counters, InstrumentationSnapshot& snapshot) noexcept
+      {
+        for(size_t function = 0; function < instrumented_functions_count; ++function) {
+          snapshot.functions[function].calls += counters.calls[function].load(std::memory_order_relaxed);
+          for(size_t bucket = 0; bucket < latency_buckets_count; ++bucket) {
+            snapshot.functions[function].latency_ns[bucket] += counters.latency_ns[function][bucket].load(std::memory_order_relaxed);
+          }
+        }
+        for(size_t order = 0; order < rotation_orders_count; ++order) {
+          snapshot.rotation_orders[order] += counters.rotation_orders[order].load(std::memory_order_relaxed);
+        }
+        snapshot.orders_tried += counters.orders_tried.load(std::memory_order_relaxed);
+        snapshot.zero_angles += counters.zero_angles.load(std::memory_order_relaxed);
+        snapshot.fallbacks += counters.fallbacks.load(std::memory_order_relaxed);
+        snapshot.threads += 1;
+      }
+
+      void zeroCounters(ThreadCounters& counters) noexcept
+      {
+        for(size_t function = 0; function < instrumented_functions_count; ++function) {
+          counters.calls[function].store(0, std::memory_order_relaxed);
+          for(auto& bucket : counters.latency_ns[function]) {
+            bucket.store(0, std::memory_order_relaxed);
+          }
+        }
+        for(auto& order : counters.rotation_orders) {
+          order.store(0, std::memory_order_relaxed);
+        }
+        counters.orders_tried.store(0, std::memory_order_relaxed);
+        counters.zero_angles.store(0, std::memory_order_relaxed);
+        counters.fallbacks.store(0, std::memory_order_relaxed);
+      }
+
+      /// @brief Links the counters of the thread into the registry for its lifetime
+      class ThreadRegistration
+      {
+      public:
+        ThreadRegistration() noexcept
+        {
+          zeroCounters(counters_);
+          auto& r = registry();
+          std::lock_guard<std::mutex> lock(r.mutex);
+          counters_.previous = nullptr;
+          counters_.next = r.live;
+          if(r.live) {
+            r.live->previous = &counters_;
+          }
+          r.live = &counters_;
+        }
+
+        ~ThreadRegistration()
+        {
+          auto& r = registry();
+          std::lock_guard<std::mutex> lock(r.mutex);
+          addCounters(counters_, r.exited);
+          if(counters_.previous) {
+            counters_.previous->next = counters_.next;
+          } else {
+            r.live = counters_.next;
+          }
+          if(counters_.next) {
+            counters_.next->previous = counters_.previous;
+          }
+        }
+
+        ThreadCounters& counters() noexcept { return counters_; }
+
+      private:
+        ThreadCounters counters_;
+      };
+    }  // namespace
+
+    ThreadCounters& threadCounters() noexcept
+    {
+      thread_local ThreadRegistration registration;
+      return registration.counters();
+    }
+  }  // namespace detail
+}  // namespace cpp_math
+#endif
+
+namespace cpp_math
+{
+
+  bool instrumentationEnabled() noexcept
+  {
+#if defined(CPP_MATH_INSTRUMENTATION)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  InstrumentationSnapshot instrumentationSnapshot()
+  {
+    InstrumentationSnapshot snapshot;
+#if defined(CPP_MATH_INSTRUMENTATION)
+    auto& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    snapshot = r.exited;
+    for(auto* counters = r.live; counters; counters = counters->next) {
+      detail::addCounters(*counters, snapshot);
+    }
+    snapshot.enabled = true;
+#endif
+    return snapshot;
+  }
+
+  void resetInstrumentation()
+  {
+#if defined(CPP_MATH_INSTRUMENTATION)
+    auto& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.exited = InstrumentationSnapshot();
+    for(auto* counters = r.live; counters; counters = counters->next) {
+      detail::zeroCounters(*counters);
+    }
+#endif
+  }
+
+  char const* rotationOrderName(size_t index) noexcept
+  {
+    static char const* const names[] = {
+      "roll, pitch, yaw", "roll, yaw, pitch", "yaw, roll, pitch", "yaw, pitch, roll", "pitch, roll, yaw", "pitch, yaw, roll"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == detail::angles_permutations_count, "Every order needs a name");
+    static_assert(rotation_orders_count == detail::angles_permutations_count, "Counters must cover every order");
+    return index < rotation_orders_count ? names[index] : "unknown";
+  }
+
+  char const* instrumentedFunctionName(InstrumentedFunction function) noexcept
+  {
+    switch(function) {
+      case InstrumentedFunction::RotateVector: return "rotateVector";
+      case InstrumentedFunction::CalculatePointByDistanceAndAngles: return "calculatePointByDistanceAndAngles";
+      case InstrumentedFunction::CalculatePointsByDistanceAndAngles: return "calculatePointsByDistanceAndAngles";
+    }
+    return "unknown";
+  }
+
+  void writeInstrumentationJson(InstrumentationSnapshot const& snapshot, std::ostream& output)
+  {
+    output << "{\n";
+    output << "  \"enabled\": " << (snapshot.enabled ? "true" : "false") << ",\n";
+    output << "  \"threads\": " << snapshot.threads << ",\n";
+    output << "  \"functions\": {\n";
+    for(size_t function = 0; function < instrumented_functions_count; ++function) {
+      auto const& counters = snapshot.functions[function];
+      output << "    \"" << instrumentedFunctionName(static_cast<InstrumentedFunction>(function)) << "\": {\"calls\": "
+             << counters.calls << ", \"latency_ns_log2_buckets\": [";
+      for(size_t bucket = 0; bucket < latency_buckets_count; ++bucket) {
+        output << (bucket == 0 ? "" : ", ") << counters.latency_ns[bucket];
+      }
+      output << "]}" << (function + 1 < instrumented_functions_count ? ",\n" : "\n");
+    }
+    output << "  },\n";
+    output << "  \"rotation_orders\": [\n";
+    for(size_t order = 0; order < rotation_orders_count; ++order) {
+      output << "    {\"order\": \"" << rotationOrderName(order) << "\", \"applied\": " << snapshot.rotation_orders[order]
+             << "}" << (order + 1 < rotation_orders_count ? ",\n" : "\n");
+    }
+    output << "  ],\n";
+    output << "  \"orders_tried\": " << snapshot.orders_tried << ",\n";
+    output << "  \"zero_angles\": " << snapshot.zero_angles << ",\n";
+    output << "  \"fallbacks\": " << snapshot.fallbacks << "\n";
+    output << "}\n";
+  }
+
+}  // namespace cpp_math
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cpp-math/instrumentation.h>
+
+#include <cstddef>
+
+#if defined(CPP_MATH_INSTRUMENTATION)
+#include <atomic>
+#include <chrono>
+#endif
+
+namespace cpp_math
+{
+  namespace detail
+  {
+#if defined(CPP_MATH_INSTRUMENTATION)
+    /**
+     * @brief Counters of one thread
+     * @note Only the owning thread writes them, with load and store instead of fetch_add, so counting is
+     *       as cheap as for plain integers. Atomics only keep snapshots from other threads well defined
+     */
+    struct ThreadCounters
+    {
+      std::atomic<uint64_t> calls[instrumented_functions_count];
+      std::atomic<uint64_t> latency_ns[instrumented_functions_count][latency_buckets_count];
+      std::atomic<uint64_t> rotation_orders[rotation_orders_count];
+      std::atomic<uint64_t> orders_tried;
+      std::atomic<uint64_t> zero_angles;
+      std::atomic<uint64_t> fallbacks;
+      // Intrusive list of live threads, so registering a thread does not allocate
+      ThreadCounters* previous;
+      ThreadCounters* next;
+    };
+
+    /// @return Counters of the calling thread, registered on the first call
+    ThreadCounters& threadCounters() noexcept;
+
+    inline void increment(std::atomic<uint64_t>& counter, uint64_t value = 1) noexcept
+    {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    inline size_t latencyBucket(uint64_t ns) noexcept
+    {
+      size_t bucket = 0;
+      while(ns > 1 and bucket + 1 < latency_buckets_count) {
+        ns >>= 1;
+        ++bucket;
+      }
+      return bucket;
+    }
+
+    /// @brief Counts the call and its latency when it goes out of scope
+    class ScopedCall
+    {
+    public:
+      explicit ScopedCall(InstrumentedFunction function) noexcept :
+        function_(static_cast<size_t>(function)),
+        start_(std::chrono::steady_clock::now())
+      {}
+
+      ~ScopedCall()
+      {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        auto& counters = threadCounters();
+        increment(counters.calls[function_]);
+        increment(counters.latency_ns[function_][latencyBucket(static_cast<uint64_t>(ns))]);
+      }
+
+      ScopedCall(ScopedCall const&) = delete;
+      ScopedCall& operator=(ScopedCall const&) = delete;
+
+    private:
+      size_t function_;
+      std::chrono::steady_clock::time_point start_;
+    };
+
+    inline void countRotationOrder(size_t index) noexcept { increment(threadCounters().rotation_orders[index]); }
+    inline void countOrderTried() noexcept { increment(threadCounters().orders_tried); }
+    inline void countZeroAngles() noexcept { increment(threadCounters().zero_angles); }
+    inline void countFallback() noexcept { increment(threadCounters().fallbacks); }
+#else
+    // Without instrumentation the hooks are empty and vanish after inlining
+    class ScopedCall
+    {
+    public:
+      explicit ScopedCall(InstrumentedFunction) noexcept {}
+    };
+
+    inline void countRotationOrder(size_t) noexcept {}
+    inline void countOrderTried() noexcept {}
+    inline void countZeroAngles() noexcept {}
+    inline void countFallback() noexcept {}
+#endif
+  }  // namespace detail
+}  // namespace cpp_math
@@ -0,0 +1,220 @@
+#include <cpp-math/lidar_scan.h>
+
+#include <cpp-math/trigonometry.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+  using namespace cpp_math;
+
+  // Points of a chunk are processed in blocks of this size, so interpolated poses fit on the stack
+  constexpr size_t block_size = 256;
+
+  /**
+   * @brief Finds samples segment and segment + 1 around the timestamp, tries the segment of the
+   *        previous point and the next one before the binary search
+   * @return false outside of the samples
+   */
+  bool findSegment(std::vector<double> const& timestamps, double timestamp, size_t& segment, double& weight) noexcept
+  {
+    auto const size = timestamps.size();
+    // Also rejects NaN
+    if(size == 0 || not(timestamp >= timestamps.front() && timestamp <= timestamps.back())) {
+      return false;
+    }
+    if(size == 1) {
+      segment = 0;
+      weight = 0;
+      return true;
+    }
+    auto contains = [&](size_t s) { return s + 1 < size && timestamps[s] <= timestamp && timestamp <= timestamps[s + 1]; };
+    if(not contains(segment)) {
+      if(contains(segment + 1)) {
+        ++segment;
+      }
+      else {
+        auto after = static_cast<size_t>(std::upper_bound(timestamps.begin(), timestamps.end(), timestamp) - timestamps.begin());
+        segment = after == size ? size - 2 : after - 1;
+      }
+    }
+    weight = (timestamp - timestamps[segment]) / (timestamps[segment + 1] - timestamps[segment]);
+    return true;
+  }
+}  // namespace
+
+namespace cpp_math
+{
+  void PoseTrack::push(double timestamp, Pose const& pose)
+  {
+    if(not timestamps_.empty() && not(timestamp > timestamps_.back())) {
+      throw std::runtime_error(
+        "Timestamp " + std::to_string(timestamp) + " is not after the last one " + std::to_string(timestamps_.back())
+      );
+    }
+    auto q = normalizeQuaternion(pose.attitude);
+    if(not qw_.empty() && q.w * qw_.back() + q.x * qx_.back() + q.y * qy_.back() + q.z * qz_.back() < 0) {
+      q = Quaternion{-q.w, -q.x, -q.y, -q.z};
+    }
+    timestamps_.push_back(timestamp);
+    x_.push_back(pose.position.x);
+    y_.push_back(pose.position.y);
+    z_.push_back(pose.position.z);
+    qw_.push_back(q.w);
+    qx_.push_back(q.x);
+    qy_.push_back(q.y);
+    qz_.push_back(q.z);
+  }
+
+  void PoseTrack::push(double timestamp, Vector3d const& position, HeliAngles const& angles)
+  {
+    push(timestamp, Pose{position, quaternionFromHeliAngles(angles)});
+  }
+
+  void PoseTrack::clear() noexcept
+  {
+    for(auto* values : {&timestamps_, &x_, &y_, &z_, &qw_, &qx_, &qy_, &qz_}) {
+      values->clear();
+    }
+  }
+
+  bool PoseTrack::poseAt(double timestamp, Pose& result) const noexcept
+  {
+    size_t segment = 0;
+    double weight = 0;
+    if(not findSegment(timestamps_, timestamp, segment, weight)) {
+      return false;
+    }
+    auto next = std::min(segment + 1, size() - 1);
+    result.position = Vector3d{
+      x_[segment] + (x_[next] - x_[segment]) * weight,
+      y_[segment] + (y_[next] - y_[segment]) * weight,
+      z_[segment] + (z_[next] - z_[segment]) * weight
+    };
+    result.attitude = nlerp(
+      Quaternion{qw_[segment], qx_[segment], qy_[segment], qz_[segment]}, Quaternion{qw_[next], qx_[next], qy_[next], qz_[next]}, weight
+    );
+    return true;
+  }
+
+  LidarScanPattern::LidarScanPattern(std::vector<CameraAngles> const& beams, SensorMount const& mount, TrigPolicy policy) :
+    mount_(mount)
+  {
+    std::vector<double> yaw, pitch;
+    for(auto const& beam : beams) {
+      yaw.push_back(beam.yaw);
+      pitch.push_back(beam.pitch);
+    }
+    std::vector<double> sin_yaw(beams.size()), cos_yaw(beams.size()), sin_pitch(beams.size()), cos_pitch(beams.size());
+    sincosDeg(beams.size(), yaw.data(), sin_yaw.data(), cos_yaw.data(), policy);
+    sincosDeg(beams.size(), pitch.data(), sin_pitch.data(), cos_pitch.data(), policy);
+    for(size_t i = 0; i < beams.size(); ++i) {
+      auto direction = multiplyMatrixByVector(
+        mount.rotation, Vector3d{cos_yaw[i] * cos_pitch[i], sin_yaw[i] * cos_pitch[i], -sin_pitch[i]}
+      );
+      x_.push_back(direction.x);
+      y_.push_back(direction.y);
+      z_.push_back(direction.z);
+    }
+  }
+
+  LidarScanPattern LidarScanPattern::spinning(
+    std::vector<double> const& laser_pitches,
+    size_t azimuth_steps,
+    SensorMount const& mount,
+    TrigPolicy policy
+  )
+  {
+    std::vector<CameraAngles> beams;
+    for(size_t azimuth = 0; azimuth < azimuth_steps; ++azimuth) {
+      auto yaw = 360.0 * static_cast<double>(azimuth) / static_cast<double>(azimuth_steps);
+      for(auto pitch : laser_pitches) {
+        beams.push_back(CameraAngles{yaw, pitch});
+      }
+    }
+    return LidarScanPattern(beams, mount, policy);
+  }
+
+  size_t LidarScanPattern::projectSweep(
+    PoseTrack const& track,
+    size_t count,
+    uint32_t const* beams,
+    double const* ranges,
+    double const* timestamps,
+    Vector3dArrays result,
+    Executor& executor,
+    size_t chunk_size
+  ) const
+  {
+    auto const wrong_beam = std::find_if(beams, beams + count, [&](uint32_t beam) { return beam >= size(); });
+    if(wrong_beam != beams + count) {
+      throw std::runtime_error(
+        "Beam " + std::to_string(*wrong_beam) + " of point " + std::to_string(wrong_beam - beams) + " is not in the pattern of " +
+        std::to_string(size()) + " beams"
+      );
+    }
+
+    auto const& track_timestamps = track.timestamps();
+    auto const positions = track.positions();
+    auto const attitudes = track.attitudes();
+    auto const lever_arm = mount_.lever_arm;
+    auto const nan = std::numeric_limits<double>::quiet_NaN();
+    std::atomic<size_t> projected(0);
+
+    executor.parallelFor(count, chunk_size, [&](size_t begin, size_t end) {
+      double qw[block_size], qx[block_size], qy[block_size], qz[block_size];
+      double px[block_size], py[block_size], pz[block_size];
+      double vx[block_size], vy[block_size], vz[block_size];
+      size_t segment = 0;
+      size_t inside = 0;
+      for(size_t block = begin; block < end; block += block_size) {
+        auto const n = std::min(block_size, end - block);
+        // Pose of every point and its measured vector in the heli frame
+        for(size_t i = 0; i < n; ++i) {
+          auto const point = block + i;
+          auto const beam = beams[point];
+          vx[i] = lever_arm.x + ranges[point] * x_[beam];
+          vy[i] = lever_arm.y + ranges[point] * y_[beam];
+          vz[i] = lever_arm.z + ranges[point] * z_[beam];
+          double weight = 0;
+          if(not findSegment(track_timestamps, timestamps[point], segment, weight)) {
+            // NaN position makes the point NaN without a branch in the loop below
+            qw[i] = 1;
+            qx[i] = qy[i] = qz[i] = 0;
+            px[i] = py[i] = pz[i] = nan;
+            continue;
+          }
+          ++inside;
+          auto const next = std::min(segment + 1, track_timestamps.size() - 1);
+          auto const keep = 1 - weight;
+          qw[i] = attitudes.w[segment] * keep + attitudes.w[next] * weight;
+          qx[i] = attitudes.x[segment] * keep + attitudes.x[next] * weight;
+          qy[i] = attitudes.y[segment] * keep + attitudes.y[next] * weight;
+          qz[i] = attitudes.z[segment] * keep + attitudes.z[next] * weight;
+          px[i] = positions.x[segment] + (positions.x[next] - positions.x[segment]) * weight;
+          py[i] = positions.y[segment] + (positions.y[next] - positions.y[segment]) * weight;
+          pz[i] = positions.z[segment] + (positions.z[next] - positions.z[segment]) * weight;
+        }
+        // No calls in the loop, it is vectorized across points. The weighted sum of quaternions is not
+        // normalized, the matrix divides by its squared norm instead (matrixFromQuaternion of the nlerp result)
+        for(size_t i = 0; i < n; ++i) {
+          auto const s = 2 / (qw[i] * qw[i] + qx[i] * qx[i] + qy[i] * qy[i] + qz[i] * qz[i]);
+          auto const xx = s * qx[i] * qx[i], yy = s * qy[i] * qy[i], zz = s * qz[i] * qz[i];
+          auto const xy = s * qx[i] * qy[i], xz = s * qx[i] * qz[i], yz = s * qy[i] * qz[i];
+          auto const wx = s * qw[i] * qx[i], wy = s * qw[i] * qy[i], wz = s * qw[i] * qz[i];
+          auto const point = block + i;
+          result.x[point] = px[i] + (1 - (yy + zz)) * vx[i] + (xy - wz) * vy[i] + (xz + wy) * vz[i];
+          result.y[point] = py[i] + (xy + wz) * vx[i] + (1 - (xx + zz)) * vy[i] + (yz - wx) * vz[i];
+          result.z[point] = pz[i] + (xz - wy) * vx[i] + (yz + wx) * vy[i] + (1 - (xx + yy)) * vz[i];
+        }
+      }
+      projected.fetch_add(inside, std::memory_order_relaxed);
+    });
+    return projected.load(std::memory_order_relaxed);
+  }
+
+}  // namespace cpp_math
@@ -0,0 +1,293 @@
+#include <cpp-math/packed.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+  using namespace cpp_math;
+
+  constexpr char packed_magic[4] = {'C', 'P', 'M', 'B'};
+  constexpr size_t angle_kinds_count = 5;
+  constexpr size_t max_varint_size = 10;
+  // Fixed point values of one chunk are converted on the stack and copied into the block at once,
+  // blocks follow varints and may be unaligned
+  constexpr size_t chunk_size = 256;
+
+  static_assert(sizeof(PackedBlockHeader) == 48, "PackedBlockHeader must not have padding");
+
+  size_t angleSize(AnglePrecision precision) noexcept
+  {
+    return precision == AnglePrecision::MicroDegrees ? sizeof(int32_t) : sizeof(int16_t);
+  }
+
+  double angleScale(AnglePrecision precision) noexcept
+  {
+    return precision == AnglePrecision::MicroDegrees ? 1e6 : 100;
+  }
+
+  /// @brief Wraps into [-180, 180] and rounds to the fixed point, the loop has no calls, so it is vectorized
+  template<typename Int>
+  uint8_t* quantizeAngles(size_t count, double const* degrees, double scale, uint8_t* out) noexcept
+  {
+    Int values[chunk_size];
+    for(size_t begin = 0; begin < count; begin += chunk_size) {
+      auto n = std::min(chunk_size, count - begin);
+      for(size_t i = 0; i < n; ++i) {
+        auto angle = degrees[begin + i];
+        auto turns = static_cast<double>(static_cast<int32_t>(angle * (1.0 / 360) + (angle >= 0 ? 0.5 : -0.5)));
+        auto fixed = (angle - 360 * turns) * scale;
+        values[i] = static_cast<Int>(fixed + (fixed >= 0 ? 0.5 : -0.5));
+      }
+      std::memcpy(out, values, n * sizeof(Int));
+      out += n * sizeof(Int);
+    }
+    return out;
+  }
+
+  template<typename Int>
+  uint8_t const* dequantizeAngles(size_t count, uint8_t const* in, double scale, double* degrees) noexcept
+  {
+    Int values[chunk_size];
+    for(size_t begin = 0; begin < count; begin += chunk_size) {
+      auto n = std::min(chunk_size, count - begin);
+      std::memcpy(values, in, n * sizeof(Int));
+      in += n * sizeof(Int);
+      for(size_t i = 0; i < n; ++i) {
+        degrees[begin + i] = static_cast<double>(values[i]) / scale;
+      }
+    }
+    return in;
+  }
+
+  uint8_t* quantizeAngles(size_t count, double const* degrees, AnglePrecision precision, uint8_t* out) noexcept
+  {
+    if(precision == AnglePrecision::MicroDegrees) {
+      return quantizeAngles<int32_t>(count, degrees, angleScale(precision), out);
+    }
+    return quantizeAngles<int16_t>(count, degrees, angleScale(precision), out);
+  }
+
+  uint8_t const* dequantizeAngles(size_t count, uint8_t const* in, AnglePrecision precision, double* degrees) noexcept
+  {
+    if(precision == AnglePrecision::MicroDegrees) {
+      return dequantizeAngles<int32_t>(count, in, angleScale(precision), degrees);
+    }
+    return dequantizeAngles<int16_t>(count, in, angleScale(precision), degrees);
+  }
+
+  uint64_t zigzag(int64_t value) noexcept
+  {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+  }
+
+  int64_t unzigzag(uint64_t value) noexcept
+  {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+  uint8_t* writeVarint(uint8_t* out, uint64_t value) noexcept
+  {
+    while(value >= 0x80) {
+      *out++ = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+  }
+
+  /// @return false if the varint does not end before end
+  bool readVarint(uint8_t const*& in, uint8_t const* end, uint64_t& value) noexcept
+  {
+    value = 0;
+    for(unsigned shift = 0; shift < 64 and in != end; shift += 7) {
+      auto byte = *in++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int64_t toTicks(double coordinate, double resolution) noexcept
+  {
+    return std::llround(coordinate / resolution);
+  }
+
+  uint8_t* packPositions(size_t count, ConstVector3dArrays positions, double resolution, int64_t const* origin, uint8_t* out) noexcept
+  {
+    int64_t previous[3] = {origin[0], origin[1], origin[2]};
+    double const* axes[3] = {positions.x, positions.y, positions.z};
+    for(size_t i = 0; i < count; ++i) {
+      for(size_t axis = 0; axis < 3; ++axis) {
+        auto ticks = toTicks(axes[axis][i], resolution);
+        out = writeVarint(out, zigzag(ticks - previous[axis]));
+        previous[axis] = ticks;
+      }
+    }
+    return out;
+  }
+
+  /// @return false if the positions do not end exactly at end
+  bool unpackPositions(
+    size_t count,
+    uint8_t const* in,
+    uint8_t const* end,
+    double resolution,
+    int64_t const* origin,
+    Vector3dArrays positions
+  ) noexcept
+  {
+    int64_t ticks[3] = {origin[0], origin[1], origin[2]};
+    double* axes[3] = {positions.x, positions.y, positions.z};
+    for(size_t i = 0; i < count; ++i) {
+      for(size_t axis = 0; axis < 3; ++axis) {
+        uint64_t delta;
+        if(not readVarint(in, end, delta)) {
+          return false;
+        }
+        ticks[axis] += unzigzag(delta);
+        axes[axis][i] = static_cast<double>(ticks[axis]) * resolution;
+      }
+    }
+    return in == end;
+  }
+
+  /**
+   * @brief Appends the block, angles are written by packAngles which gets the place for them
+   * @note The buffer is grown to the biggest possible block and shrunk back to the written one
+   */
+  template<class PackAngles>
+  void packBlock(
+    PackedBlockKind kind,
+    size_t count,
+    ConstVector3dArrays positions,
+    std::vector<uint8_t>& buffer,
+    PackingOptions const& options,
+    PackAngles const& pack_angles
+  )
+  {
+    if(not(options.position_resolution > 0)) {
+      throw std::runtime_error("Position resolution must be positive");
+    }
+    auto header = PackedBlockHeader{};
+    std::memcpy(header.magic, packed_magic, sizeof(packed_magic));
+    header.kind = kind;
+    header.angle_precision = options.angle_precision;
+    header.position_resolution = options.position_resolution;
+    if(count != 0) {
+      header.origin[0] = toTicks(positions.x[0], options.position_resolution);
+      header.origin[1] = toTicks(positions.y[0], options.position_resolution);
+      header.origin[2] = toTicks(positions.z[0], options.position_resolution);
+    }
+
+    auto const start = buffer.size();
+    auto angles_size = kind == PackedBlockKind::Poses ? angle_kinds_count * count * angleSize(options.angle_precision) : 0;
+    buffer.resize(start + sizeof(PackedBlockHeader) + angles_size + 3 * max_varint_size * count);
+    auto* block = buffer.data() + start;
+    auto* out = pack_angles(block + sizeof(PackedBlockHeader));
+    out = packPositions(count, positions, options.position_resolution, header.origin, out);
+
+    auto size = static_cast<size_t>(out - block);
+    if(size > std::numeric_limits<uint32_t>::max() or count > std::numeric_limits<uint32_t>::max()) {
+      buffer.resize(start);
+      throw std::runtime_error("Packed block must be smaller than 4 GiB, pack fewer records at once");
+    }
+    header.count = static_cast<uint32_t>(count);
+    header.size = static_cast<uint32_t>(size);
+    std::memcpy(block, &header, sizeof(header));
+    buffer.resize(start + size);
+  }
+
+  PackedBlockHeader readHeader(uint8_t const* data, size_t size, PackedBlockKind kind)
+  {
+    auto header = readPackedBlockHeader(data, size);
+    if(header.kind != kind) {
+      throw std::runtime_error(
+        kind == PackedBlockKind::Poses ? "Packed block does not hold poses" : "Packed block does not hold points"
+      );
+    }
+    return header;
+  }
+}  // namespace
+
+namespace cpp_math
+{
+
+  void packPoses(
+    size_t count,
+    ConstVector3dArrays positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    std::vector<uint8_t>& buffer,
+    PackingOptions const& options
+  )
+  {
+    packBlock(PackedBlockKind::Poses, count, positions, buffer, options, [&](uint8_t* out) {
+      for(auto degrees : {angles.yaw, angles.pitch, angles.roll, camera_angles.yaw, camera_angles.pitch}) {
+        out = quantizeAngles(count, degrees, options.angle_precision, out);
+      }
+      return out;
+    });
+  }
+
+  void packPoints(size_t count, ConstVector3dArrays points, std::vector<uint8_t>& buffer, PackingOptions const& options)
+  {
+    packBlock(PackedBlockKind::Points, count, points, buffer, options, [](uint8_t* out) { return out; });
+  }
+
+  PackedBlockHeader readPackedBlockHeader(uint8_t const* data, size_t size)
+  {
+    PackedBlockHeader header;
+    if(size < sizeof(header)) {
+      throw std::runtime_error("Packed block is truncated");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if(std::memcmp(header.magic, packed_magic, sizeof(packed_magic)) != 0
+       or (header.kind != PackedBlockKind::Poses and header.kind != PackedBlockKind::Points)
+       or (header.angle_precision != AnglePrecision::MicroDegrees and header.angle_precision != AnglePrecision::CentiDegrees)
+       or not(header.position_resolution > 0))
+    {
+      throw std::runtime_error("Data is not a packed block");
+    }
+    auto angles_size = header.kind == PackedBlockKind::Poses
+                       ? angle_kinds_count * header.count * angleSize(header.angle_precision) : 0;
+    if(header.size > size or header.size < sizeof(header) + angles_size + 3 * size_t(header.count)) {
+      throw std::runtime_error("Packed block is truncated");
+    }
+    return header;
+  }
+
+  size_t unpackPoses(
+    uint8_t const* data,
+    size_t size,
+    Vector3dArrays positions,
+    HeliAnglesResultArrays angles,
+    CameraAnglesResultArrays camera_angles
+  )
+  {
+    auto header = readHeader(data, size, PackedBlockKind::Poses);
+    auto const* in = data + sizeof(header);
+    for(auto degrees : {angles.yaw, angles.pitch, angles.roll, camera_angles.yaw, camera_angles.pitch}) {
+      in = dequantizeAngles(header.count, in, header.angle_precision, degrees);
+    }
+    if(not unpackPositions(header.count, in, data + header.size, header.position_resolution, header.origin, positions)) {
+      throw std::runtime_error("Positions of packed block are corrupted");
+    }
+    return header.size;
+  }
+
+  size_t unpackPoints(uint8_t const* data, size_t size, Vector3dArrays points)
+  {
+    auto header = readHeader(data, size, PackedBlockKind::Points);
+    if(not unpackPositions(header.count, data + sizeof(header), data + header.size, header.position_resolution, header.origin, points)) {
+      throw std::runtime_error("Positions of packed block are corrupted");
+    }
+    return header.size;
+  }
+
+}  // namespace cpp_math
@@ -0,0 +1,122 @@
+#include <cpp-math/pointing.h>
+
+#include "rotation_order.h"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  using namespace cpp_math;
+
+  constexpr double radians_to_degrees = 180 / 3.14159265358979323846;
+
+  // Directions which need sin(yaw) below this are moved away from the plane where rotateVector changes the order
+  constexpr double min_yaw_sin = 1e-12;
+
+  // Rounding of the direction which is still accepted as reachable
+  constexpr double reach_tolerance = 1e-12;
+
+  constexpr double not_a_number = std::numeric_limits<double>::quiet_NaN();
+
+  /**
+   * @brief Angle in degrees within [-180, 180]
+   * @note Subtraction of the nearest multiple of 360 is exact (Sterbenz lemma), so the heli angle
+   *       plus the camera angle gives back the total angle up to a turn. Faster than std::remainder
+   */
+  double wrapDegrees(double degrees) noexcept
+  {
+    return degrees - 360 * std::floor(degrees / 360 + 0.5);
+  }
+
+  struct TotalAngles
+  {
+    double yaw, pitch;
+  };
+
+  /// @brief Yaw and pitch of the heli and camera together for the order roll, pitch, yaw with roll skipped
+  TotalAngles solveWithoutRoll(Vector3d const& direction) noexcept
+  {
+    // Ry(pitch) * X = (cos, 0, -sin), then Rz(yaw) turns it around Z
+    auto horizontal = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+    auto pitch = -std::atan2(direction.z, horizontal);
+    // Straight up or down yaw is skipped, otherwise rotateVector would not be able to apply it after pitch
+    auto yaw = detail::close_to_zero(horizontal) ? 0.0 : std::atan2(direction.y, direction.x);
+    return {yaw, pitch};
+  }
+
+  /**
+   * @brief Yaw and pitch for the order yaw, roll, pitch which rotateVector uses for X with a nonzero roll
+   * @note Ry(pitch) * Rx(roll) * Rz(yaw) * X = Ry(pitch) * (cos(yaw), sin(yaw) cos(roll), sin(yaw) sin(roll)),
+   *       pitch keeps y, so sin(yaw) comes from y and pitch turns the rest in the XZ plane
+   */
+  TotalAngles solveWithRoll(Vector3d const& direction, double roll_sin, double roll_cos) noexcept
+  {
+    if(std::abs(direction.y) > std::abs(roll_cos) + reach_tolerance) {
+      return {not_a_number, not_a_number};
+    }
+    auto yaw_sin = std::abs(direction.y) < std::abs(roll_cos) ? direction.y / roll_cos : std::copysign(1.0, direction.y * roll_cos);
+    if(std::abs(yaw_sin) < min_yaw_sin) {
+      yaw_sin = std::copysign(min_yaw_sin, yaw_sin);
+    }
+    // Both signs of cos(yaw) have a solution. Pitch is smaller for the one with larger cos(pitch),
+    // which is proportional to cos(yaw) x + z z, so cos(yaw) takes the sign of x
+    auto yaw_cos = std::copysign(std::sqrt(1 - yaw_sin * yaw_sin), direction.x);
+    auto z = yaw_sin * roll_sin;
+    // Ry(pitch) turns (a, b) of XZ plane into (cos a + sin b, -sin a + cos b)
+    auto pitch = std::atan2(z * direction.x - yaw_cos * direction.z, yaw_cos * direction.x + z * direction.z);
+    return {std::atan2(yaw_sin, yaw_cos), pitch};
+  }
+}  // namespace
+
+namespace cpp_math
+{
+  PointingSolver::PointingSolver(Vector3d const& initial_position, HeliAngles const& angles) noexcept :
+    initial_position_(initial_position),
+    angles_(angles),
+    roll_is_applied_(not detail::close_to_zero(angles.roll)),
+    roll_sin_(std::sin(degreesToRadians(angles.roll))),
+    roll_cos_(std::cos(degreesToRadians(angles.roll)))
+  {}
+
+  CameraPointing PointingSolver::solve(Vector3d const& target) const noexcept
+  {
+    auto offset = subtractVectors(target, initial_position_);
+    auto distance = std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+    if(distance == 0) {
+      // Any angles give the target
+      return {{0, 0}, 0};
+    }
+    auto direction = multiplyVectorByScalar(offset, 1 / distance);
+    auto total = roll_is_applied_ ? solveWithRoll(direction, roll_sin_, roll_cos_) : solveWithoutRoll(direction);
+    return {
+      {wrapDegrees(total.yaw * radians_to_degrees - angles_.yaw), wrapDegrees(total.pitch * radians_to_degrees - angles_.pitch)},
+      distance
+    };
+  }
+
+  void PointingSolver::solve(
+    size_t count,
+    ConstVector3dArrays targets,
+    CameraAnglesResultArrays result,
+    double* distances
+  ) const noexcept
+  {
+    for(size_t i = 0; i < count; ++i) {
+      auto pointing = solve(Vector3d{targets.x[i], targets.y[i], targets.z[i]});
+      result.yaw[i] = pointing.camera_angles.yaw;
+      result.pitch[i] = pointing.camera_angles.pitch;
+      distances[i] = pointing.distance;
+    }
+  }
+
+  CameraPointing calculateCameraAnglesToPoint(
+    Vector3d const& initial_position,
+    HeliAngles const& angles,
+    Vector3d const& target
+  ) noexcept
+  {
+    return PointingSolver(initial_position, angles).solve(target);
+  }
+
+}  // namespace cpp_math
@@ -0,0 +1,173 @@
+#include <cpp-math/pose_buffer.h>
+
+namespace
+{
+  using namespace cpp_math;
+
+  // poseAt gives up if the writer overwrites the samples it looks at this many times in a row
+  constexpr int read_attempts = 16;
+
+  size_t roundUpToPowerOfTwo(size_t value)
+  {
+    size_t result = 1;
+    while(result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  Vector3d interpolate(Vector3d const& v1, Vector3d const& v2, double t)
+  {
+    return addVectors(v1, multiplyVectorByScalar(subtractVectors(v2, v1), t));
+  }
+}  // namespace
+
+namespace cpp_math
+{
+  PoseBuffer::PoseBuffer(size_t capacity) :
+    mask_(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity) - 1),
+    slots_(new Slot[mask_ + 1]),
+    head_(0)
+  {
+    for(size_t i = 0; i <= mask_; ++i) {
+      slots_[i].sequence.store(0, std::memory_order_relaxed);
+      slots_[i].index.store(0, std::memory_order_relaxed);
+      for(auto& value : slots_[i].values) {
+        value.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void PoseBuffer::push(double timestamp, Pose const& pose) noexcept
+  {
+    auto index = head_.load(std::memory_order_relaxed);
+    auto& slot = slots_[index & mask_];
+
+    // Odd sequence tells readers the slot is being written
+    auto sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    double const values[values_count] = {
+      timestamp,
+      pose.position.x,
+      pose.position.y,
+      pose.position.z,
+      pose.attitude.w,
+      pose.attitude.x,
+      pose.attitude.y,
+      pose.attitude.z,
+    };
+    slot.index.store(index, std::memory_order_relaxed);
+    for(size_t i = 0; i < values_count; ++i) {
+      slot.values[i].store(values[i], std::memory_order_relaxed);
+    }
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    head_.store(index + 1, std::memory_order_release);
+  }
+
+  void PoseBuffer::push(double timestamp, Vector3d const& position, HeliAngles const& angles)
+  {
+    push(timestamp, Pose{position, quaternionFromHeliAngles(angles)});
+  }
+
+  bool PoseBuffer::read(uint64_t index, Sample& sample) const noexcept
+  {
+    auto const& slot = slots_[index & mask_];
+    double values[values_count];
+    uint64_t sequence;
+    do {
+      sequence = slot.sequence.load(std::memory_order_acquire);
+      if(sequence & 1) {
+        continue;
+      }
+      if(slot.index.load(std::memory_order_relaxed) != index) {
+        return false;
+      }
+      for(size_t i = 0; i < values_count; ++i) {
+        values[i] = slot.values[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while((sequence & 1) || slot.sequence.load(std::memory_order_relaxed) != sequence);
+
+    sample.timestamp = values[0];
+    sample.pose.position = Vector3d{values[1], values[2], values[3]};
+    sample.pose.attitude = Quaternion{values[4], values[5], values[6], values[7]};
+    return true;
+  }
+
+  bool PoseBuffer::poseAt(double timestamp, Pose& result) const noexcept
+  {
+    for(int attempt = 0; attempt < read_attempts; ++attempt) {
+      auto head = head_.load(std::memory_order_acquire);
+      if(head == 0) {
+        return false;
+      }
+      // The oldest slot is skipped, it is the next one the writer overwrites
+      auto first = head > mask_ ? head - mask_ : 0;
+      auto last = head - 1;
+
+      Sample newest;
+      Sample oldest;
+      if(not read(last, newest) or not read(first, oldest)) {
+        continue;
+      }
+      if(timestamp > newest.timestamp || timestamp < oldest.timestamp) {
+        return false;
+      }
+      if(timestamp == newest.timestamp || first == last) {
+        result = newest.pose;
+        return true;
+      }
+
+      // Find the first sample after the timestamp, oldest <= timestamp < newest
+      auto before = oldest;
+      auto after = newest;
+      bool overwritten = false;
+      while(last - first > 1) {
+        auto middle = first + (last - first) / 2;
+        Sample sample;
+        if(not read(middle, sample)) {
+          overwritten = true;
+          break;
+        }
+        if(sample.timestamp <= timestamp) {
+          first = middle;
+          before = sample;
+        }
+        else {
+          last = middle;
+          after = sample;
+        }
+      }
+      if(overwritten) {
+        continue;
+      }
+
+      auto t = (timestamp - before.timestamp) / (after.timestamp - before.timestamp);
+      result.position = interpolate(before.pose.position, after.pose.position, t);
+      result.attitude = slerp(before.pose.attitude, after.pose.attitude, t);
+      return true;
+    }
+    return false;
+  }
+
+  bool PoseBuffer::latest(double& timestamp, Pose& result) const noexcept
+  {
+    for(int attempt = 0; attempt < read_attempts; ++attempt) {
+      auto head = head_.load(std::memory_order_acquire);
+      if(head == 0) {
+        return false;
+      }
+      Sample sample;
+      if(read(head - 1, sample)) {
+        timestamp = sample.timestamp;
+        result = sample.pose;
+        return true;
+      }
+    }
+    return false;
+  }
+
+}  // namespace cpp_math
@@ -0,0 +1,109 @@
+#include <cpp-math/pose_context.h>
+
+#include <cpp-math/vector_expression.h>
+
+#include "rotation_order.h"
+
+namespace
+{
+  using namespace cpp_math;
+
+  bool sameAngles(HeliAngles const& a, HeliAngles const& b) noexcept
+  {
+    return a.yaw == b.yaw and a.pitch == b.pitch and a.roll == b.roll;
+  }
+}  // namespace
+
+namespace cpp_math
+{
+  PoseContext::PoseContext(TrigPolicy policy) noexcept :
+    policy_(policy),
+    rotations_(),
+    has_direction_(false),
+    direction_angles_(),
+    direction_(),
+    stats_()
+  {}
+
+  void PoseContext::invalidate() noexcept
+  {
+    for(auto& rotation : rotations_) {
+      rotation.valid = false;
+    }
+    has_direction_ = false;
+  }
+
+  Mat3 const& PoseContext::rotation(HeliAngle angle, double degrees) noexcept
+  {
+    auto& cached = rotations_[static_cast<size_t>(angle)];
+    if(not cached.valid or cached.degrees != degrees) {
+      // The same matrix rotateVector builds for the angle
+      cached.matrix = calculateRotationMatrixFromDegrees<double>(heliAngleToRotationAxis(angle), degrees, policy_);
+      cached.degrees = degrees;
+      cached.valid = true;
+      ++stats_.rotation_misses;
+    }
+    else {
+      ++stats_.rotation_hits;
+    }
+    return cached.matrix;
+  }
+
+  Vector3d const& PoseContext::direction(HeliAngles const& angles, CameraAngles const& camera_angles) noexcept
+  {
+    auto combined = angles;
+    combined.pitch += camera_angles.pitch;
+    combined.yaw += camera_angles.yaw;
+    if(has_direction_ and sameAngles(combined, direction_angles_)) {
+      ++stats_.direction_hits;
+      return direction_;
+    }
+    ++stats_.direction_misses;
+    has_direction_ = true;
+    direction_angles_ = combined;
+
+    auto const x_axis = Vector3d{1, 0, 0};
+    direction_ = x_axis;
+    if(combined.roll == 0 && combined.pitch == 0 && combined.yaw == 0) {
+      return direction_;
+    }
+    // Same search as rotateVector. Matrices of an order which failed stay in the cache for the next order,
+    // so every angle is counted once per call
+    std::array<Mat3 const*, 3> matrices{};
+    for(auto const& order : detail::angles_permutations) {
+      auto result = x_axis;
+      bool applied = true;
+      for(auto angle : order) {
+        auto degrees = detail::getAngle(combined, angle);
+        if(detail::close_to_zero(degrees)) {
+          continue;
+        }
+        if(not detail::can_rotate(result, angle)) {
+          applied = false;
+          break;
+        }
+        auto& matrix = matrices[static_cast<size_t>(angle)];
+        if(matrix == nullptr) {
+          matrix = &rotation(angle, degrees);
+        }
+        result = multiplyMatrixByVector(*matrix, result);
+      }
+      if(applied) {
+        direction_ = result;
+        break;
+      }
+    }
+    return direction_;
+  }
+
+  Vector3d PoseContext::calculatePoint(
+    double distance,
+    Vector3d const& initial_position,
+    HeliAngles const& angles,
+    CameraAngles const& camera_angles
+  ) noexcept
+  {
+    return initial_position + distance * direction(angles, camera_angles);
+  }
+
+}  // namespace cpp_math
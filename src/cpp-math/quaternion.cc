@@ -0,0 +1,206 @@
+#include <cpp-math/quaternion.h>
+
+#include <cpp-math/heli_attitude.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  using namespace cpp_math;
+
+  // Above this cosine of half angle slerp falls back to nlerp, sin(angle) would lose precision
+  constexpr double slerp_threshold = 0.9995;
+
+  double radiansToDegrees(double radians) { return radians * 180.0 / M_PI; }
+
+  Quaternion axisRotation(double x, double y, double z, double degrees)
+  {
+    auto half = degreesToRadians(degrees) / 2;
+    auto s = std::sin(half);
+    return Quaternion{std::cos(half), x * s, y * s, z * s};
+  }
+
+  double dot(Quaternion const& q1, Quaternion const& q2)
+  {
+    return q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
+  }
+
+  Quaternion weightedSum(Quaternion const& q1, double a, Quaternion const& q2, double b)
+  {
+    return Quaternion{
+      q1.w * a + q2.w * b,
+      q1.x * a + q2.x * b,
+      q1.y * a + q2.y * b,
+      q1.z * a + q2.z * b
+    };
+  }
+
+  Quaternion element(ConstQuaternionArrays const& arrays, size_t i)
+  {
+    return Quaternion{arrays.w[i], arrays.x[i], arrays.y[i], arrays.z[i]};
+  }
+}  // namespace
+
+namespace cpp_math
+{
+  Quaternion quaternionFromHeliAngles(HeliAngles const& angles)
+  {
+    return quaternionFromMatrix(HeliAttitude::directionMatrix(angles));
+  }
+
+  Quaternion quaternionFromRollPitchYaw(HeliAngles const& angles)
+  {
+    auto roll = axisRotation(1, 0, 0, angles.roll);
+    auto pitch = axisRotation(0, 1, 0, angles.pitch);
+    auto yaw = axisRotation(0, 0, 1, angles.yaw);
+    return multiplyQuaternions(yaw, multiplyQuaternions(pitch, roll));
+  }
+
+  HeliAngles rollPitchYawFromQuaternion(Quaternion const& q)
+  {
+    auto sin_pitch = std::max(-1.0, std::min(1.0, 2 * (q.w * q.y - q.x * q.z)));
+    return HeliAngles{
+      radiansToDegrees(std::atan2(2 * (q.w * q.z + q.x * q.y), 1 - 2 * (q.y * q.y + q.z * q.z))),
+      radiansToDegrees(std::asin(sin_pitch)),
+      radiansToDegrees(std::atan2(2 * (q.w * q.x + q.y * q.z), 1 - 2 * (q.x * q.x + q.y * q.y)))
+    };
+  }
+
+  Quaternion quaternionFromMatrix(Mat3 const& m)
+  {
+    // Shepperd's method: divide by the largest of the four possible denominators
+    auto trace = m[0][0] + m[1][1] + m[2][2];
+    Quaternion q;
+    if(trace > 0) {
+      auto s = 2 * std::sqrt(1 + trace);
+      q = Quaternion{s / 4, (m[2][1] - m[1][2]) / s, (m[0][2] - m[2][0]) / s, (m[1][0] - m[0][1]) / s};
+    }
+    else if(m[0][0] > m[1][1] && m[0][0] > m[2][2]) {
+      auto s = 2 * std::sqrt(1 + m[0][0] - m[1][1] - m[2][2]);
+      q = Quaternion{(m[2][1] - m[1][2]) / s, s / 4, (m[0][1] + m[1][0]) / s, (m[0][2] + m[2][0]) / s};
+    }
+    else if(m[1][1] > m[2][2]) {
+      auto s = 2 * std::sqrt(1 + m[1][1] - m[0][0] - m[2][2]);
+      q = Quaternion{(m[0][2] - m[2][0]) / s, (m[0][1] + m[1][0]) / s, s / 4, (m[1][2] + m[2][1]) / s};
+    }
+    else {
+      auto s = 2 * std::sqrt(1 + m[2][2] - m[0][0] - m[1][1]);
+      q = Quaternion{(m[1][0] - m[0][1]) / s, (m[0][2] + m[2][0]) / s, (m[1][2] + m[2][1]) / s, s / 4};
+    }
+    return normalizeQuaternion(q);
+  }
+
+  Mat3 matrixFromQuaternion(Quaternion const& q) noexcept
+  {
+    auto xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    auto xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    auto wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+    // clang-format off
+    return Mat3{{
+      {1 - 2 * (yy + zz), 2 * (xy - wz),     2 * (xz + wy)    },
+      {2 * (xy + wz),     1 - 2 * (xx + zz), 2 * (yz - wx)    },
+      {2 * (xz - wy),     2 * (yz + wx),     1 - 2 * (xx + yy)}
+    }};
+    // clang-format on
+  }
+
+  Vector3d rotateVector(Vector3d const& v, Quaternion const& q) noexcept
+  {
+    // v' = v + w * t + u x t, where t = 2 * (u x v) and u is the vector part of q
+    auto tx = 2 * (q.y * v.z - q.z * v.y);
+    auto ty = 2 * (q.z * v.x - q.x * v.z);
+    auto tz = 2 * (q.x * v.y - q.y * v.x);
+    return Vector3d{
+      v.x + q.w * tx + (q.y * tz - q.z * ty),
+      v.y + q.w * ty + (q.z * tx - q.x * tz),
+      v.z + q.w * tz + (q.x * ty - q.y * tx)
+    };
+  }
+
+  Quaternion multiplyQuaternions(Quaternion const& q1, Quaternion const& q2) noexcept
+  {
+    return Quaternion{
+      q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z,
+      q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y,
+      q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x,
+      q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w
+    };
+  }
+
+  Quaternion composeRotations(Quaternion const& first, Quaternion const& second) noexcept
+  {
+    return multiplyQuaternions(second, first);
+  }
+
+  Quaternion conjugateQuaternion(Quaternion const& q) noexcept
+  {
+    return Quaternion{q.w, -q.x, -q.y, -q.z};
+  }
+
+  Quaternion normalizeQuaternion(Quaternion const& q) noexcept
+  {
+    auto norm = std::sqrt(dot(q, q));
+    return Quaternion{q.w / norm, q.x / norm, q.y / norm, q.z / norm};
+  }
+
+  Quaternion slerp(Quaternion const& q1, Quaternion const& q2, double t) noexcept
+  {
+    auto cos_angle = dot(q1, q2);
+    auto sign = cos_angle < 0 ? -1.0 : 1.0;
+    cos_angle *= sign;
+    if(cos_angle > slerp_threshold) {
+      return normalizeQuaternion(weightedSum(q1, 1 - t, q2, sign * t));
+    }
+    auto angle = std::acos(cos_angle);
+    auto sin_angle = std::sin(angle);
+    return weightedSum(
+      q1,
+      std::sin((1 - t) * angle) / sin_angle,
+      q2,
+      sign * std::sin(t * angle) / sin_angle
+    );
+  }
+
+  Quaternion nlerp(Quaternion const& q1, Quaternion const& q2, double t) noexcept
+  {
+    auto sign = dot(q1, q2) < 0 ? -1.0 : 1.0;
+    return normalizeQuaternion(weightedSum(q1, 1 - t, q2, sign * t));
+  }
+
+  void slerp(size_t count, ConstQuaternionArrays q1, ConstQuaternionArrays q2, double const* t, QuaternionArrays result)
+  {
+    for(size_t i = 0; i < count; ++i) {
+      auto q = slerp(element(q1, i), element(q2, i), t[i]);
+      result.w[i] = q.w;
+      result.x[i] = q.x;
+      result.y[i] = q.y;
+      result.z[i] = q.z;
+    }
+  }
+
+  void nlerp(size_t count, ConstQuaternionArrays q1, ConstQuaternionArrays q2, double const* t, QuaternionArrays result)
+  {
+    // Written without calls so the compiler can vectorize it
+    for(size_t i = 0; i < count; ++i) {
+      auto cos_angle = q1.w[i] * q2.w[i] + q1.x[i] * q2.x[i] + q1.y[i] * q2.y[i] + q1.z[i] * q2.z[i];
+      auto a = 1 - t[i];
+      auto b = cos_angle < 0 ? -t[i] : t[i];
+      auto w = q1.w[i] * a + q2.w[i] * b;
+      auto x = q1.x[i] * a + q2.x[i] * b;
+      auto y = q1.y[i] * a + q2.y[i] * b;
+      auto z = q1.z[i] * a + q2.z[i] * b;
+      auto norm = std::sqrt(w * w + x * x + y * y + z * z);
+      result.w[i] = w / norm;
+      result.x[i] = x / norm;
+      result.y[i] = y / norm;
+      result.z[i] = z / norm;
+    }
+  }
+
+  std::ostream& operator<<(std::ostream& os, Quaternion const& q)
+  {
+    return os << "(" << q.w << ", " << q.x << ", " << q.y << ", " << q.z << ")";
+  }
+
+}  // namespace cpp_math
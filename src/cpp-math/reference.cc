@@ -0,0 +1,175 @@
+#include <cpp-math/reference.h>
+
+#include "rotation_order.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  using namespace cpp_math;
+  using reference::LongVector3;
+
+  constexpr long double pi = 3.141592653589793238462643383279502884L;
+
+  /// @brief close_to_zero of double, the reference must skip the same angles and orders
+  bool closeToZero(long double value) noexcept
+  {
+    return std::abs(value) < static_cast<long double>(std::numeric_limits<double>::epsilon() * 100);
+  }
+
+  bool canRotate(LongVector3 const& v, HeliAngle angle) noexcept
+  {
+    switch(angle) {
+      case HeliAngle::Yaw: return not closeToZero(v.x) or not closeToZero(v.y);
+      case HeliAngle::Pitch: return not closeToZero(v.x) or not closeToZero(v.z);
+      case HeliAngle::Roll: return not closeToZero(v.z) or not closeToZero(v.y);
+    }
+    return false;
+  }
+
+  long double getAngle(BasicHeliAngles<long double> const& angles, HeliAngle angle) noexcept
+  {
+    switch(angle) {
+      case HeliAngle::Yaw: return angles.yaw;
+      case HeliAngle::Pitch: return angles.pitch;
+      case HeliAngle::Roll: return angles.roll;
+    }
+    return 0;
+  }
+
+  LongVector3 rotate(LongVector3 const& v, HeliAngle angle, long double degrees) noexcept
+  {
+    long double s, c;
+    reference::sincosDegrees(degrees, s, c);
+    switch(angle) {
+      case HeliAngle::Roll: return {v.x, c * v.y - s * v.z, s * v.y + c * v.z};
+      case HeliAngle::Pitch: return {c * v.x + s * v.z, v.y, -s * v.x + c * v.z};
+      case HeliAngle::Yaw: return {c * v.x - s * v.y, s * v.x + c * v.y, v.z};
+    }
+    return v;
+  }
+
+  LongVector3 rotateVector(LongVector3 const& v, BasicHeliAngles<long double> const& angles) noexcept
+  {
+    if(angles.roll == 0 && angles.pitch == 0 && angles.yaw == 0) {
+      return v;
+    }
+    for(auto const& order : detail::angles_permutations) {
+      auto result = v;
+      bool applied = true;
+      for(auto angle : order) {
+        auto degrees = getAngle(angles, angle);
+        if(closeToZero(degrees)) {
+          continue;
+        }
+        if(not canRotate(result, angle)) {
+          applied = false;
+          break;
+        }
+        result = rotate(result, angle, degrees);
+      }
+      if(applied) {
+        return result;
+      }
+    }
+    return v;
+  }
+
+  long double largestComponent(LongVector3 const& v) noexcept
+  {
+    return std::max({std::abs(v.x), std::abs(v.y), std::abs(v.z)});
+  }
+
+  template<typename T>
+  double ulpError(Vector3<T> const& result, LongVector3 const& reference) noexcept
+  {
+    auto largest = static_cast<T>(largestComponent(reference));
+    auto ulp = static_cast<long double>(std::nextafter(largest, std::numeric_limits<T>::infinity()) - largest);
+    auto error = std::max({
+      std::abs(static_cast<long double>(result.x) - reference.x),
+      std::abs(static_cast<long double>(result.y) - reference.y),
+      std::abs(static_cast<long double>(result.z) - reference.z)
+    });
+    return static_cast<double>(error / ulp);
+  }
+
+  template<typename T>
+  long double absoluteError(Vector3<T> const& result, LongVector3 const& reference) noexcept
+  {
+    auto dx = static_cast<long double>(result.x) - reference.x;
+    auto dy = static_cast<long double>(result.y) - reference.y;
+    auto dz = static_cast<long double>(result.z) - reference.z;
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+  }
+}  // namespace
+
+namespace cpp_math
+{
+  namespace reference
+  {
+    void sincosDegrees(long double degrees, long double& sin_result, long double& cos_result) noexcept
+    {
+      // Both steps are exact: fmod always is, and the quadrant is an integer on the grid of the remainder
+      auto turns = std::fmod(degrees, 360.0L);
+      auto quadrant = std::nearbyint(turns / 90);
+      auto radians = (turns - 90 * quadrant) * (pi / 180);
+      auto s = std::sin(radians);
+      auto c = std::cos(radians);
+      switch(((static_cast<int>(quadrant) % 4) + 4) % 4) {
+        case 0: sin_result = s; cos_result = c; break;
+        case 1: sin_result = c; cos_result = -s; break;
+        case 2: sin_result = -s; cos_result = -c; break;
+        default: sin_result = -c; cos_result = s; break;
+      }
+    }
+
+    LongVector3 rotateVector(Vector3d const& v, HeliAngles const& angles) noexcept
+    {
+      return ::rotateVector(
+        LongVector3{v.x, v.y, v.z}, BasicHeliAngles<long double>{angles.yaw, angles.pitch, angles.roll}
+      );
+    }
+
+    LongVector3 calculatePointByDistanceAndAngles(
+      double distance,
+      Vector3d const& initial_position,
+      HeliAngles const& angles,
+      CameraAngles const& camera_angles
+    ) noexcept
+    {
+      auto combined = BasicHeliAngles<long double>{
+        static_cast<long double>(angles.yaw) + camera_angles.yaw,
+        static_cast<long double>(angles.pitch) + camera_angles.pitch,
+        angles.roll
+      };
+      auto direction = ::rotateVector(LongVector3{1, 0, 0}, combined);
+      return {
+        initial_position.x + distance * direction.x,
+        initial_position.y + distance * direction.y,
+        initial_position.z + distance * direction.z
+      };
+    }
+
+    long double absoluteError(Vector3d const& result, LongVector3 const& reference) noexcept
+    {
+      return ::absoluteError(result, reference);
+    }
+
+    long double absoluteError(Vector3f const& result, LongVector3 const& reference) noexcept
+    {
+      return ::absoluteError(result, reference);
+    }
+
+    double ulpError(Vector3d const& result, LongVector3 const& reference) noexcept
+    {
+      return ::ulpError(result, reference);
+    }
+
+    double ulpError(Vector3f const& result, LongVector3 const& reference) noexcept
+    {
+      return ::ulpError(result, reference);
+    }
+  }  // namespace reference
+}  // namespace cpp_math
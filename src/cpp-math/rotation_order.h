@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cpp-math/cpp_math.h>
+
+#include <array>
+#include <cstddef>
+
+namespace cpp_math
+{
+  namespace detail
+  {
+    constexpr size_t angles_permutations_count = 6;
+
+    /// @brief Orders in which rotateVector tries to apply heli angles, the first one that can be applied wins
+    constexpr std::array<std::array<HeliAngle, 3>, angles_permutations_count> angles_permutations = {{
+      {{HeliAngle::Roll, HeliAngle::Pitch, HeliAngle::Yaw}},
+      {{HeliAngle::Roll, HeliAngle::Yaw, HeliAngle::Pitch}},
+      {{HeliAngle::Yaw, HeliAngle::Roll, HeliAngle::Pitch}},
+      {{HeliAngle::Yaw, HeliAngle::Pitch, HeliAngle::Roll}},
+      {{HeliAngle::Pitch, HeliAngle::Roll, HeliAngle::Yaw}},
+      {{HeliAngle::Pitch, HeliAngle::Yaw, HeliAngle::Roll}},
+    }};
+
+    /// @return Zero for unknown angle, so it is skipped like any other zero angle
+    template<typename T>
+    T getAngle(BasicHeliAngles<T> const& angles, HeliAngle angle) noexcept;
+
+    /// @brief Threshold is relative to the precision of T
+    template<typename T>
+    bool close_to_zero(T value) noexcept;
+
+    /// @return false if v lies on the rotation axis of angle, so rotating it would change nothing
+    template<typename T>
+    bool can_rotate(Vector3<T> const& v, HeliAngle const& angle) noexcept;
+  }  // namespace detail
+}  // namespace cpp_math
@@ -0,0 +1,93 @@
+#include <cpp-math/sensor_rig.h>
+
+#include <cpp-math/heli_attitude.h>
+#include <cpp-math/trigonometry.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+  using namespace cpp_math;
+
+  // Sensors are processed in chunks of this size, so trigonometry of camera angles fits on the stack
+  constexpr size_t chunk_size = 64;
+}  // namespace
+
+namespace cpp_math
+{
+  SensorRig::SensorRig(std::vector<SensorMount> const& mounts)
+  {
+    for(auto const& mount : mounts) {
+      addSensor(mount);
+    }
+  }
+
+  size_t SensorRig::addSensor(SensorMount const& mount)
+  {
+    for(size_t row = 0; row < 3; ++row) {
+      for(size_t column = 0; column < 3; ++column) {
+        mount_[row][column].push_back(mount.rotation[row][column]);
+      }
+    }
+    lever_x_.push_back(mount.lever_arm.x);
+    lever_y_.push_back(mount.lever_arm.y);
+    lever_z_.push_back(mount.lever_arm.z);
+    return size() - 1;
+  }
+
+  SensorMount SensorRig::mount(size_t sensor) const
+  {
+    if(sensor >= size()) {
+      throw std::runtime_error("No sensor " + std::to_string(sensor) + " in rig of " + std::to_string(size()));
+    }
+    SensorMount result{};
+    for(size_t row = 0; row < 3; ++row) {
+      for(size_t column = 0; column < 3; ++column) {
+        result.rotation[row][column] = mount_[row][column][sensor];
+      }
+    }
+    result.lever_arm = {lever_x_[sensor], lever_y_[sensor], lever_z_[sensor]};
+    return result;
+  }
+
+  void SensorRig::calculatePoints(
+    Vector3d const& initial_position,
+    HeliAngles const& angles,
+    CameraAnglesArrays camera_angles,
+    double const* distances,
+    Vector3dArrays result,
+    TrigPolicy policy
+  ) const
+  {
+    // Heli rotation in the order rotateVector resolves for the X axis, the same one as for single points
+    auto const h = HeliAttitude::directionMatrix(angles, policy);
+    double sin_yaw[chunk_size], cos_yaw[chunk_size], sin_pitch[chunk_size], cos_pitch[chunk_size];
+    for(size_t begin = 0; begin < size(); begin += chunk_size) {
+      auto count = std::min(chunk_size, size() - begin);
+      sincosDeg(count, camera_angles.yaw + begin, sin_yaw, cos_yaw, policy);
+      sincosDeg(count, camera_angles.pitch + begin, sin_pitch, cos_pitch, policy);
+      // No calls in the loop, it is vectorized across sensors
+      for(size_t i = 0; i < count; ++i) {
+        auto s = begin + i;
+        // Camera direction in the sensor frame: X rotated by pitch and then yaw
+        auto cx = cos_yaw[i] * cos_pitch[i];
+        auto cy = sin_yaw[i] * cos_pitch[i];
+        auto cz = -sin_pitch[i];
+        // Into the heli frame
+        auto bx = mount_[0][0][s] * cx + mount_[0][1][s] * cy + mount_[0][2][s] * cz;
+        auto by = mount_[1][0][s] * cx + mount_[1][1][s] * cy + mount_[1][2][s] * cz;
+        auto bz = mount_[2][0][s] * cx + mount_[2][1][s] * cy + mount_[2][2][s] * cz;
+        // Lever arm plus distance along the direction, both rotated by the heli at once
+        auto vx = lever_x_[s] + distances[s] * bx;
+        auto vy = lever_y_[s] + distances[s] * by;
+        auto vz = lever_z_[s] + distances[s] * bz;
+        result.x[s] = initial_position.x + h[0][0] * vx + h[0][1] * vy + h[0][2] * vz;
+        result.y[s] = initial_position.y + h[1][0] * vx + h[1][1] * vy + h[1][2] * vz;
+        result.z[s] = initial_position.z + h[2][0] * vx + h[2][1] * vy + h[2][2] * vz;
+      }
+    }
+  }
+
+}  // namespace cpp_math
@@ -0,0 +1,211 @@
+#pragma once
+
+// Degree-native sincos written for plain doubles and GCC vector extensions.
+// Like batch_kernel_impl.h it is included by translation units compiled with different
+// instruction sets, so everything has internal linkage and only builtins are called
+
+#include <cpp-math/cpp_math.h>
+
+#include <cstddef>
+
+namespace cpp_math
+{
+  namespace detail
+  {
+    namespace
+    {
+      constexpr double round_magic = 6755399441055744.0;  // 1.5 * 2^52
+      // pi / 180 = radians_in_degree + radians_in_degree_tail, radians_in_degree = high + low with 26 bit high part
+      constexpr double radians_in_degree = 0.017453292519943295;
+      constexpr double radians_in_degree_tail = 2.9486522708701687e-19;
+      constexpr double radians_in_degree_high = 0.01745329238474369;
+      constexpr double radians_in_degree_low = 1.3519960498364902e-10;
+      // Below it quadrant * 90 and degrees - quadrant * 90 are exact, above it fmod is used
+      constexpr double fast_reduction_limit = 4503599627370496.0;  // 2^52
+
+      template <class V>
+      struct Lanes
+      {
+        static constexpr size_t width = sizeof(V) / sizeof(double);
+      };
+
+      template <class V>
+      V absolute(V value)
+      {
+        return value < 0 ? -value : value;
+      }
+
+      template <class V>
+      V roundToInteger(V value)
+      {
+        return (value + round_magic) - round_magic;
+      }
+
+      inline void reduceLargeAngles(double& degrees)
+      {
+        if(absolute(degrees) >= fast_reduction_limit) {
+          degrees = __builtin_fmod(degrees, 360.0);
+        }
+      }
+
+      /// @brief fmod is exact but slow, so it is only used for lanes which need it
+      template <class V>
+      void reduceLargeAngles(V& degrees)
+      {
+        auto large = absolute(degrees) >= fast_reduction_limit;
+        bool any = false;
+        for(size_t i = 0; i < Lanes<V>::width; ++i) {
+          any = any || large[i];
+        }
+        if(any) {
+          for(size_t i = 0; i < Lanes<V>::width; ++i) {
+            if(large[i]) {
+              degrees[i] = __builtin_fmod(degrees[i], 360.0);
+            }
+          }
+        }
+      }
+
+      /**
+       * @brief Converts degrees to radians as unevaluated sum high + low
+       * @note Dekker's product, so it does not need FMA instructions
+       */
+      template <class V>
+      void degreesToRadiansExtended(V degrees, V& high, V& low)
+      {
+        auto split = degrees * 134217729.0;  // 2^27 + 1
+        auto degrees_high = split - (split - degrees);
+        auto degrees_low = degrees - degrees_high;
+        high = degrees * radians_in_degree;
+        low = ((degrees_high * radians_in_degree_high - high) + degrees_high * radians_in_degree_low
+               + degrees_low * radians_in_degree_high)
+            + degrees_low * radians_in_degree_low + degrees * radians_in_degree_tail;
+      }
+
+      /// @brief Polynomials for [-pi/4, pi/4], sin(x) = x + x * z * sinPolynomial(z) and cos(x) = 1 - z / 2 + z * z * cosPolynomial(z), z = x * x
+      template <TrigPolicy policy>
+      struct Polynomials;
+
+      // Cephes minimax coefficients, about 1 ULP
+      template <>
+      struct Polynomials<TrigPolicy::Ulp1>
+      {
+        template <class V>
+        static V sinPolynomial(V z)
+        {
+          return ((((1.58962301576546568060e-10 * z - 2.50507477628578072866e-8) * z
+                    + 2.75573136213857245213e-6) * z - 1.98412698295895385996e-4) * z
+                  + 8.33333333332211858878e-3) * z - 1.66666666666666307295e-1;
+        }
+
+        template <class V>
+        static V cosPolynomial(V z)
+        {
+          return ((((-1.13585365213876817300e-11 * z + 2.08757008419747316778e-9) * z
+                    - 2.75573141792967388112e-7) * z + 2.48015872888517045348e-5) * z
+                  - 1.38888888888730564116e-3) * z + 4.16666666666665929218e-2;
+        }
+      };
+
+      // Taylor series up to x^11 and x^10, truncation error below 1.2e-10
+      template <>
+      struct Polynomials<TrigPolicy::AbsError1e9>
+      {
+        template <class V>
+        static V sinPolynomial(V z)
+        {
+          return (((-1.0 / 39916800 * z + 1.0 / 362880) * z - 1.0 / 5040) * z + 1.0 / 120) * z - 1.0 / 6;
+        }
+
+        template <class V>
+        static V cosPolynomial(V z)
+        {
+          return ((-1.0 / 3628800 * z + 1.0 / 40320) * z - 1.0 / 720) * z + 1.0 / 24;
+        }
+      };
+
+      // Taylor series up to x^7 and x^8, truncation error below 3.2e-7
+      template <>
+      struct Polynomials<TrigPolicy::AbsError1e6>
+      {
+        template <class V>
+        static V sinPolynomial(V z)
+        {
+          return (-1.0 / 5040 * z + 1.0 / 120) * z - 1.0 / 6;
+        }
+
+        template <class V>
+        static V cosPolynomial(V z)
+        {
+          return (1.0 / 40320 * z - 1.0 / 720) * z + 1.0 / 24;
+        }
+      };
+
+      /**
+       * @brief sin and cos of angle in degrees
+       * @note Reduction to [-45, 45] degrees is exact for every finite input,
+       *       so multiples of 90 degrees give exact zeros and ones
+       */
+      template <TrigPolicy policy, class V>
+      void sincosDegrees(V degrees, V& sin_result, V& cos_result)
+      {
+        reduceLargeAngles(degrees);
+        auto quadrant = roundToInteger(degrees * (1.0 / 90.0));
+        V radians, radians_low;
+        degreesToRadiansExtended(degrees - quadrant * 90.0, radians, radians_low);
+        auto z = radians * radians;
+
+        // sin(x + low) = sin(x) + low * cos(x), cos(x + low) = cos(x) - low * sin(x)
+        auto sin_value = radians + (radians * z * Polynomials<policy>::sinPolynomial(z) + radians_low * (1.0 - 0.5 * z));
+        // 1 - z / 2 is rounded, its rounding error is added back like fdlibm does
+        auto half_z = 0.5 * z;
+        auto cos_head = 1.0 - half_z;
+        auto cos_value = cos_head + (((1.0 - cos_head) - half_z)
+                                     + (z * z * Polynomials<policy>::cosPolynomial(z) - radians_low * radians));
+
+        // Fraction of quadrant / 4 tells the quadrant: 0 -> 0, 0.25 -> 1, +-0.5 -> 2, -0.25 -> 3
+        auto quarter = quadrant * 0.25;
+        auto fraction = quarter - roundToInteger(quarter);
+        auto swap = absolute(fraction) == 0.25;
+        auto negate_sin = fraction < 0 || fraction == 0.5;
+        auto negate_cos = fraction == 0.25 || absolute(fraction) == 0.5;
+
+        auto s = swap ? cos_value : sin_value;
+        auto c = swap ? sin_value : cos_value;
+        sin_result = negate_sin ? -s : s;
+        cos_result = negate_cos ? -c : c;
+      }
+
+      template <TrigPolicy policy, class V>
+      void sincosDegreesKernel(size_t count, double const* degrees, double* sin_result, double* cos_result)
+      {
+        constexpr size_t width = Lanes<V>::width;
+        size_t offset = 0;
+        for(; offset + width <= count; offset += width) {
+          V value, s, c;
+          __builtin_memcpy(&value, degrees + offset, sizeof(V));
+          sincosDegrees<policy>(value, s, c);
+          __builtin_memcpy(sin_result + offset, &s, sizeof(V));
+          __builtin_memcpy(cos_result + offset, &c, sizeof(V));
+        }
+        for(; offset < count; ++offset) {
+          sincosDegrees<policy>(degrees[offset], sin_result[offset], cos_result[offset]);
+        }
+      }
+
+      template <class V>
+      void sincosDegreesKernel(TrigPolicy policy, size_t count, double const* degrees, double* sin_result, double* cos_result)
+      {
+        switch(policy) {
+          case TrigPolicy::Standard:
+          case TrigPolicy::Ulp1:
+            return sincosDegreesKernel<TrigPolicy::Ulp1, V>(count, degrees, sin_result, cos_result);
+          case TrigPolicy::AbsError1e9:
+            return sincosDegreesKernel<TrigPolicy::AbsError1e9, V>(count, degrees, sin_result, cos_result);
+          case TrigPolicy::AbsError1e6:
+            return sincosDegreesKernel<TrigPolicy::AbsError1e6, V>(count, degrees, sin_result, cos_result);
+        }
+      }
+    }  // namespace
+  }  // namespace detail
+}  // namespace cpp_math
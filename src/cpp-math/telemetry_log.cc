@@ -0,0 +1,174 @@
+#include <cpp-math/telemetry_log.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+  using namespace cpp_math;
+
+  constexpr size_t arrays_count = 12;
+
+  /// @brief Start of the page which holds byte offset, pages before it are whole
+  size_t pageFloor(size_t offset) noexcept
+  {
+    static auto const page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return offset / page_size * page_size;
+  }
+}  // namespace
+
+namespace cpp_math
+{
+
+  void writeTelemetryLog(std::string const& path, std::vector<TelemetryRecord> const& records)
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<char const*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(TelemetryRecord)));
+    if(not file) {
+      throw std::runtime_error("Can not write telemetry log " + path);
+    }
+  }
+
+  TelemetryLog::TelemetryLog(std::string const& path) : mapping_(nullptr), size_(0), records_(nullptr)
+  {
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+      throw std::runtime_error("Can not open telemetry log " + path + ": " + std::strerror(errno));
+    }
+    struct stat status;
+    if(::fstat(fd, &status) != 0 or static_cast<size_t>(status.st_size) % sizeof(TelemetryRecord) != 0) {
+      ::close(fd);
+      throw std::runtime_error("Size of " + path + " is not a whole number of telemetry records");
+    }
+    size_ = static_cast<size_t>(status.st_size) / sizeof(TelemetryRecord);
+    if(size_ == 0) {
+      ::close(fd);
+      return;
+    }
+    mapping_ = ::mmap(nullptr, size_ * sizeof(TelemetryRecord), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(mapping_ == MAP_FAILED) {
+      mapping_ = nullptr;
+      throw std::runtime_error("Can not map telemetry log " + path + ": " + std::strerror(errno));
+    }
+    // Records are read once front to back, the kernel reads ahead more and drops pages behind sooner
+    ::madvise(mapping_, size_ * sizeof(TelemetryRecord), MADV_SEQUENTIAL);
+    records_ = static_cast<TelemetryRecord const*>(mapping_);
+  }
+
+  TelemetryLog::~TelemetryLog()
+  {
+    if(mapping_ != nullptr) {
+      ::munmap(mapping_, size_ * sizeof(TelemetryRecord));
+    }
+  }
+
+  void TelemetryLog::release(size_t end) noexcept
+  {
+    auto bytes = pageFloor(std::min(end, size_) * sizeof(TelemetryRecord));
+    if(bytes != 0) {
+      ::madvise(mapping_, bytes, MADV_DONTNEED);
+    }
+  }
+
+  GeoreferencedLogWriter::GeoreferencedLogWriter(std::string const& path, size_t count) :
+    mapping_(nullptr),
+    size_(count),
+    records_(nullptr)
+  {
+    auto fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0) {
+      throw std::runtime_error("Can not create " + path + ": " + std::strerror(errno));
+    }
+    if(count == 0) {
+      ::close(fd);
+      return;
+    }
+    // Blocks are allocated up front: a sparse file would run out of space on a page fault, which is SIGBUS
+    auto bytes = count * sizeof(GeoreferencedRecord);
+    auto error = ::posix_fallocate(fd, 0, static_cast<off_t>(bytes));
+    if(error != 0) {
+      ::close(fd);
+      throw std::runtime_error("Can not allocate " + std::to_string(bytes) + " bytes for " + path + ": " + std::strerror(error));
+    }
+    mapping_ = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(mapping_ == MAP_FAILED) {
+      mapping_ = nullptr;
+      throw std::runtime_error("Can not map " + path + ": " + std::strerror(errno));
+    }
+    records_ = static_cast<GeoreferencedRecord*>(mapping_);
+  }
+
+  GeoreferencedLogWriter::~GeoreferencedLogWriter()
+  {
+    if(mapping_ != nullptr) {
+      ::munmap(mapping_, size_ * sizeof(GeoreferencedRecord));
+    }
+  }
+
+  void GeoreferencedLogWriter::release(size_t end) noexcept
+  {
+    auto bytes = pageFloor(std::min(end, size_) * sizeof(GeoreferencedRecord));
+    if(bytes != 0) {
+      // Dirty pages stay in the page cache of the shared file, the mapping just stops holding them
+      ::msync(mapping_, bytes, MS_ASYNC);
+      ::madvise(mapping_, bytes, MADV_DONTNEED);
+    }
+  }
+
+  Georeferencer::Georeferencer(size_t chunk_size, BatchMode mode) :
+    chunk_size_(std::max<size_t>(chunk_size, 1)),
+    mode_(mode),
+    arrays_(arrays_count * chunk_size_)
+  {}
+
+  void Georeferencer::process(TelemetryRecord const* records, size_t count, GeoreferencedRecord* result)
+  {
+    for(size_t begin = 0; begin < count; begin += chunk_size_) {
+      processChunk(records + begin, std::min(chunk_size_, count - begin), result + begin);
+    }
+  }
+
+  void Georeferencer::processChunk(TelemetryRecord const* records, size_t count, GeoreferencedRecord* result)
+  {
+    double* arrays[arrays_count];
+    for(size_t i = 0; i < arrays_count; ++i) {
+      arrays[i] = arrays_.data() + i * chunk_size_;
+    }
+    for(size_t i = 0; i < count; ++i) {
+      auto const& record = records[i];
+      arrays[0][i] = record.distance;
+      arrays[1][i] = record.position.x;
+      arrays[2][i] = record.position.y;
+      arrays[3][i] = record.position.z;
+      arrays[4][i] = record.angles.yaw;
+      arrays[5][i] = record.angles.pitch;
+      arrays[6][i] = record.angles.roll;
+      arrays[7][i] = record.camera_angles.yaw;
+      arrays[8][i] = record.camera_angles.pitch;
+    }
+    calculatePointsByDistanceAndAngles(
+      count,
+      arrays[0],
+      {arrays[1], arrays[2], arrays[3]},
+      {arrays[4], arrays[5], arrays[6]},
+      {arrays[7], arrays[8]},
+      {arrays[9], arrays[10], arrays[11]},
+      mode_
+    );
+    for(size_t i = 0; i < count; ++i) {
+      result[i] = GeoreferencedRecord{records[i].timestamp, {arrays[9][i], arrays[10][i], arrays[11][i]}};
+    }
+  }
+
+}  // namespace cpp_math
@@ -0,0 +1,577 @@
+#include <cpp-math/terrain.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+  using namespace cpp_math;
+
+  constexpr char dem_magic[8] = {'C', 'P', 'P', 'M', 'D', 'E', 'M', '1'};
+
+  constexpr double not_a_number = std::numeric_limits<double>::quiet_NaN();
+  constexpr double infinity = std::numeric_limits<double>::infinity();
+
+  static_assert(sizeof(DemTileHeader) == 40, "Tile header is a file format, it must not get padding");
+
+  /**
+   * @brief Clips [begin, end] of the ray o + d * t to the slab lo <= o + d * t <= hi
+   * @return false if nothing is left
+   */
+  bool clipToSlab(double o, double d, double lo, double hi, double& begin, double& end) noexcept
+  {
+    if(d == 0) {
+      return o >= lo and o <= hi and begin <= end;
+    }
+    auto t0 = (lo - o) / d;
+    auto t1 = (hi - o) / d;
+    if(d < 0) {
+      std::swap(t0, t1);
+    }
+    begin = std::max(begin, t0);
+    end = std::min(end, t1);
+    return begin <= end;
+  }
+
+  /**
+   * @brief Parses names of tile files like 12_-3.dem
+   * @return false for other files
+   */
+  bool parseTileName(char const* name, int64_t& column, int64_t& row) noexcept
+  {
+    auto parse = [](char const*& text, int64_t& value) {
+      if(not(std::isdigit(static_cast<unsigned char>(text[0])) or (text[0] == '-' and std::isdigit(static_cast<unsigned char>(text[1]))))) {
+        return false;
+      }
+      errno = 0;
+      char* end = nullptr;
+      auto parsed = std::strtoll(text, &end, 10);
+      if(errno != 0) {
+        return false;
+      }
+      value = static_cast<int64_t>(parsed);
+      text = end;
+      return true;
+    };
+    return parse(name, column) and *name++ == '_' and parse(name, row) and std::strcmp(name, ".dem") == 0;
+  }
+
+  /// @brief Keeps the last used tile, so rays of a batch do not lock the cache on every tile
+  class TileLookup
+  {
+  public:
+    explicit TileLookup(DemTileCache& cache) : cache_(cache), column_(0), row_(0), tile_(), valid_(false) {}
+
+    DemTile const* get(int64_t column, int64_t row)
+    {
+      if(not valid_ or column != column_ or row != row_) {
+        tile_ = cache_.tile(column, row);
+        column_ = column;
+        row_ = row;
+        valid_ = true;
+      }
+      return tile_.get();
+    }
+
+  private:
+    DemTileCache& cache_;
+    int64_t column_, row_;
+    DemTileCache::TilePointer tile_;
+    bool valid_;
+  };
+
+  /// @brief Walks over tiles which the ray crosses, like a 2D DDA over the tile grid
+  TerrainHit intersect(TileLookup& lookup, DemTileCache const& cache, Vector3d const& origin, Vector3d direction, double max_distance)
+  {
+    TerrainHit const none{{not_a_number, not_a_number, not_a_number}, not_a_number};
+    auto length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+    if(not(length > 0) or not(max_distance >= 0) or std::isinf(max_distance)) {
+      return none;
+    }
+    direction = multiplyVectorByScalar(direction, 1 / length);
+
+    // Only the part of the ray over tiles on disk is walked
+    auto const tile_size = cache.tileSize();
+    int64_t min_column, min_row, max_column, max_row;
+    double begin = 0;
+    auto limit = max_distance;
+    if(not cache.tileExtent(min_column, min_row, max_column, max_row)
+       or not clipToSlab(
+         origin.x, direction.x, static_cast<double>(min_column) * tile_size, static_cast<double>(max_column + 1) * tile_size, begin, limit
+       )
+       or not clipToSlab(
+         origin.y, direction.y, static_cast<double>(min_row) * tile_size, static_cast<double>(max_row + 1) * tile_size, begin, limit
+       ))
+    {
+      return none;
+    }
+
+    auto column = static_cast<int64_t>(std::floor((origin.x + direction.x * begin) / tile_size));
+    auto row = static_cast<int64_t>(std::floor((origin.y + direction.y * begin) / tile_size));
+    auto boundary = [&](double o, double d, int64_t index) {
+      if(d > 0) {
+        return ((static_cast<double>(index) + 1) * tile_size - o) / d;
+      }
+      if(d < 0) {
+        return (static_cast<double>(index) * tile_size - o) / d;
+      }
+      return infinity;
+    };
+    auto next_x = boundary(origin.x, direction.x, column);
+    auto next_y = boundary(origin.y, direction.y, row);
+    auto step_x = direction.x == 0 ? infinity : tile_size / std::abs(direction.x);
+    auto step_y = direction.y == 0 ? infinity : tile_size / std::abs(direction.y);
+
+    while(true) {
+      if(direction.z >= 0 and origin.z + direction.z * begin > cache.maxHeight()) {
+        // Above every tile and not descending, nothing is hit further
+        break;
+      }
+      auto end = std::min({next_x, next_y, limit});
+      double distance;
+      auto const* tile = lookup.get(column, row);
+      if(tile and tile->intersect(origin, direction, begin, end, distance)) {
+        return {addVectors(origin, multiplyVectorByScalar(direction, distance)), distance};
+      }
+      if(end >= limit) {
+        break;
+      }
+      begin = end;
+      if(next_x < next_y) {
+        column += direction.x > 0 ? 1 : -1;
+        next_x += step_x;
+      }
+      else {
+        row += direction.y > 0 ? 1 : -1;
+        next_y += step_y;
+      }
+    }
+    return none;
+  }
+}  // namespace
+
+namespace cpp_math
+{
+  DemTileHeader makeDemTileHeader(uint32_t width, uint32_t height, double origin_x, double origin_y, double cell_size)
+  {
+    DemTileHeader header;
+    std::memcpy(header.magic, dem_magic, sizeof(dem_magic));
+    header.width = width;
+    header.height = height;
+    header.origin_x = origin_x;
+    header.origin_y = origin_y;
+    header.cell_size = cell_size;
+    return header;
+  }
+
+  void writeDemTile(std::string const& path, DemTileHeader const& header, std::vector<float> const& heights)
+  {
+    if(heights.size() != static_cast<size_t>(header.width) * header.height) {
+      throw std::runtime_error("Number of heights does not match the tile size");
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    file.write(reinterpret_cast<char const*>(heights.data()), static_cast<std::streamsize>(heights.size() * sizeof(float)));
+    if(not file) {
+      throw std::runtime_error("Can not write tile " + path);
+    }
+  }
+
+  /// @brief Ray in cell coordinates of the tile, z stays in world units. Parameter is the distance
+  struct DemTile::Ray
+  {
+    double x, y, z;
+    double dx, dy, dz;
+  };
+
+  DemTile::DemTile(std::string const& path) : mapping_(nullptr), mapping_size_(0), header_(nullptr), heights_(nullptr)
+  {
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+      throw std::runtime_error("Can not open tile " + path + ": " + std::strerror(errno));
+    }
+    struct stat status;
+    if(::fstat(fd, &status) != 0 or static_cast<size_t>(status.st_size) < sizeof(DemTileHeader)) {
+      ::close(fd);
+      throw std::runtime_error("Tile " + path + " is too small");
+    }
+    mapping_size_ = static_cast<size_t>(status.st_size);
+    mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(mapping_ == MAP_FAILED) {
+      throw std::runtime_error("Can not map tile " + path + ": " + std::strerror(errno));
+    }
+    header_ = static_cast<DemTileHeader const*>(mapping_);
+    heights_ = reinterpret_cast<float const*>(static_cast<char const*>(mapping_) + sizeof(DemTileHeader));
+    auto samples = static_cast<size_t>(header_->width) * header_->height;
+    if(std::memcmp(header_->magic, dem_magic, sizeof(dem_magic)) != 0 or header_->width < 2 or header_->height < 2
+       or not(header_->cell_size > 0) or mapping_size_ < sizeof(DemTileHeader) + samples * sizeof(float))
+    {
+      ::munmap(mapping_, mapping_size_);
+      throw std::runtime_error("File " + path + " is not a DEM tile");
+    }
+
+    // Level 0 keeps the max of four corners of every cell, every next level the max of 2 x 2 blocks
+    size_t width = header_->width - 1;
+    size_t height = header_->height - 1;
+    std::vector<float> level(width * height);
+    for(size_t row = 0; row < height; ++row) {
+      for(size_t column = 0; column < width; ++column) {
+        level[row * width + column] = std::max(
+          std::max(sample(column, row), sample(column + 1, row)), std::max(sample(column, row + 1), sample(column + 1, row + 1))
+        );
+      }
+    }
+    max_heights_.push_back(std::move(level));
+    level_widths_.push_back(width);
+    level_heights_.push_back(height);
+    while(width > 1 or height > 1) {
+      auto const& previous = max_heights_.back();
+      auto next_width = (width + 1) / 2;
+      auto next_height = (height + 1) / 2;
+      std::vector<float> next(next_width * next_height, -std::numeric_limits<float>::infinity());
+      for(size_t row = 0; row < height; ++row) {
+        for(size_t column = 0; column < width; ++column) {
+          auto& value = next[(row / 2) * next_width + column / 2];
+          value = std::max(value, previous[row * width + column]);
+        }
+      }
+      width = next_width;
+      height = next_height;
+      max_heights_.push_back(std::move(next));
+      level_widths_.push_back(width);
+      level_heights_.push_back(height);
+    }
+  }
+
+  DemTile::~DemTile()
+  {
+    ::munmap(mapping_, mapping_size_);
+  }
+
+  double DemTile::heightAt(double x, double y) const noexcept
+  {
+    auto u = (x - header_->origin_x) / header_->cell_size;
+    auto v = (y - header_->origin_y) / header_->cell_size;
+    if(not(u >= 0 and v >= 0 and u <= header_->width - 1 and v <= header_->height - 1)) {
+      return not_a_number;
+    }
+    auto column = std::min(static_cast<size_t>(u), static_cast<size_t>(header_->width - 2));
+    auto row = std::min(static_cast<size_t>(v), static_cast<size_t>(header_->height - 2));
+    u -= static_cast<double>(column);
+    v -= static_cast<double>(row);
+    double h00 = sample(column, row), h10 = sample(column + 1, row);
+    double h01 = sample(column, row + 1), h11 = sample(column + 1, row + 1);
+    return (h00 * (1 - u) + h10 * u) * (1 - v) + (h01 * (1 - u) + h11 * u) * v;
+  }
+
+  bool DemTile::intersect(Vector3d const& origin, Vector3d const& direction, double begin, double end, double& distance)
+    const noexcept
+  {
+    auto const& header = *header_;
+    Ray ray{
+      (origin.x - header.origin_x) / header.cell_size,
+      (origin.y - header.origin_y) / header.cell_size,
+      origin.z,
+      direction.x / header.cell_size,
+      direction.y / header.cell_size,
+      direction.z
+    };
+    if(not clipToSlab(ray.x, ray.dx, 0, header.width - 1, begin, end)
+       or not clipToSlab(ray.y, ray.dy, 0, header.height - 1, begin, end))
+    {
+      return false;
+    }
+    return traverse(ray, max_heights_.size() - 1, 0, 0, begin, end, distance);
+  }
+
+  bool DemTile::traverse(
+    Ray const& ray,
+    size_t level,
+    size_t column,
+    size_t row,
+    double begin,
+    double end,
+    double& distance
+  ) const noexcept
+  {
+    // The ray is straight, so its lowest point within the block is at one of the ends
+    auto lowest = std::min(ray.z + ray.dz * begin, ray.z + ray.dz * end);
+    if(lowest > max_heights_[level][row * level_widths_[level] + column]) {
+      return false;
+    }
+    if(level == 0) {
+      return intersectCell(ray, column, row, begin, end, distance);
+    }
+
+    // Children the ray crosses, visited by the distance where the ray enters them
+    struct Child
+    {
+      size_t column, row;
+      double begin, end;
+    };
+    Child children[4];
+    size_t count = 0;
+    auto child_level = level - 1;
+    auto child_size = static_cast<double>(size_t(1) << child_level);
+    for(size_t i = 0; i < 4; ++i) {
+      Child child{column * 2 + i % 2, row * 2 + i / 2, begin, end};
+      if(child.column >= level_widths_[child_level] or child.row >= level_heights_[child_level]) {
+        continue;
+      }
+      auto x = static_cast<double>(child.column) * child_size;
+      auto y = static_cast<double>(child.row) * child_size;
+      if(not clipToSlab(ray.x, ray.dx, x, x + child_size, child.begin, child.end)
+         or not clipToSlab(ray.y, ray.dy, y, y + child_size, child.begin, child.end))
+      {
+        continue;
+      }
+      auto position = count++;
+      for(; position > 0 and children[position - 1].begin > child.begin; --position) {
+        children[position] = children[position - 1];
+      }
+      children[position] = child;
+    }
+    for(size_t i = 0; i < count; ++i) {
+      auto const& child = children[i];
+      if(traverse(ray, child_level, child.column, child.row, child.begin, child.end, distance)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool DemTile::intersectCell(Ray const& ray, size_t column, size_t row, double begin, double end, double& distance)
+    const noexcept
+  {
+    double h00 = sample(column, row), h10 = sample(column + 1, row);
+    double h01 = sample(column, row + 1), h11 = sample(column + 1, row + 1);
+    auto a = h10 - h00;
+    auto b = h01 - h00;
+    auto c = h00 - h10 - h01 + h11;
+    // Cell coordinates and height of the ray at begin, t below is counted from begin
+    auto u = ray.x + ray.dx * begin - static_cast<double>(column);
+    auto v = ray.y + ray.dy * begin - static_cast<double>(row);
+    auto z = ray.z + ray.dz * begin;
+    // Height of the ray above the bilinear surface is f(t) = A t^2 + B t + C
+    auto A = -c * ray.dx * ray.dy;
+    auto B = ray.dz - (a * ray.dx + b * ray.dy + c * (u * ray.dy + v * ray.dx));
+    auto C = z - (h00 + a * u + b * v + c * u * v);
+    auto length = end - begin;
+    if(not(C > 0)) {
+      // Starts below the surface, NaN heights never hit
+      if(std::isnan(C)) {
+        return false;
+      }
+      distance = begin;
+      return true;
+    }
+
+    auto t = infinity;
+    auto consider = [&](double root) {
+      if(root >= 0 and root <= length) {
+        t = std::min(t, root);
+      }
+    };
+    if(std::abs(A) * length <= std::abs(B) * 1e-12) {
+      if(B < 0) {
+        consider(-C / B);
+      }
+    }
+    else {
+      auto discriminant = B * B - 4 * A * C;
+      if(discriminant >= 0) {
+        // Stable form, roots are q / A and C / q
+        auto q = -0.5 * (B + std::copysign(std::sqrt(discriminant), B));
+        consider(q / A);
+        if(q != 0) {
+          consider(C / q);
+        }
+      }
+    }
+    if(t == infinity and (A * length + B) * length + C <= 0) {
+      // The root is lost in rounding but the ray is below the surface at the end
+      t = length;
+    }
+    if(t == infinity) {
+      return false;
+    }
+    distance = begin + t;
+    return true;
+  }
+
+  size_t DemTileCache::KeyHash::operator()(Key const& key) const noexcept
+  {
+    return std::hash<int64_t>()(key.first) * 31 + std::hash<int64_t>()(key.second);
+  }
+
+  DemTileCache::DemTileCache(std::string directory, double tile_size, size_t capacity) :
+    directory_(std::move(directory)),
+    tile_size_(tile_size),
+    capacity_(std::max<size_t>(capacity, 1)),
+    min_column_(0),
+    min_row_(0),
+    max_column_(-1),
+    max_row_(-1),
+    measured_max_height_(-infinity),
+    max_height_(-infinity),
+    hits_(0),
+    misses_(0)
+  {
+    if(not(tile_size > 0)) {
+      throw std::runtime_error("Tile size must be positive");
+    }
+
+    // A missing directory is an area without terrain, like missing files
+    auto* listing = ::opendir(directory_.c_str());
+    if(listing == nullptr) {
+      return;
+    }
+    while(auto const* file = ::readdir(listing)) {
+      int64_t column, row;
+      if(parseTileName(file->d_name, column, row)) {
+        files_.emplace(Key(column, row), file->d_name);
+      }
+    }
+    ::closedir(listing);
+    for(auto const& file : files_) {
+      auto const& key = file.first;
+      if(min_column_ > max_column_) {
+        min_column_ = max_column_ = key.first;
+        min_row_ = max_row_ = key.second;
+      }
+      min_column_ = std::min(min_column_, key.first);
+      max_column_ = std::max(max_column_, key.first);
+      min_row_ = std::min(min_row_, key.second);
+      max_row_ = std::max(max_row_, key.second);
+    }
+    if(not files_.empty()) {
+      max_height_.store(infinity, std::memory_order_relaxed);
+    }
+  }
+
+  bool DemTileCache::tileExtent(int64_t& min_column, int64_t& min_row, int64_t& max_column, int64_t& max_row) const noexcept
+  {
+    if(files_.empty()) {
+      return false;
+    }
+    min_column = min_column_;
+    min_row = min_row_;
+    max_column = max_column_;
+    max_row = max_row_;
+    return true;
+  }
+
+  DemTileCache::TilePointer DemTileCache::tile(int64_t column, int64_t row)
+  {
+    auto key = Key(column, row);
+    auto file = files_.find(key);
+    if(file == files_.end()) {
+      return nullptr;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto entry = entries_.find(key);
+      if(entry != entries_.end()) {
+        order_.splice(order_.begin(), order_, entry->second.position);
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return entry->second.tile;
+      }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+
+    // Mapping and building the mipmap take long, other threads keep using the cache meanwhile
+    TilePointer tile = std::make_shared<DemTile const>(directory_ + "/" + file->second);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(measured_.insert(key).second) {
+      measured_max_height_ = std::max<double>(measured_max_height_, tile->maxHeight());
+      if(measured_.size() == files_.size()) {
+        max_height_.store(measured_max_height_, std::memory_order_relaxed);
+      }
+    }
+    auto entry = entries_.find(key);
+    if(entry != entries_.end()) {
+      // Another thread loaded it first
+      order_.splice(order_.begin(), order_, entry->second.position);
+      return entry->second.tile;
+    }
+    order_.push_front(key);
+    entries_.emplace(key, Entry{tile, order_.begin()});
+    while(entries_.size() > capacity_) {
+      entries_.erase(order_.back());
+      order_.pop_back();
+    }
+    return tile;
+  }
+
+  DemTileCache::TilePointer DemTileCache::tileAt(double x, double y)
+  {
+    return tile(static_cast<int64_t>(std::floor(x / tile_size_)), static_cast<int64_t>(std::floor(y / tile_size_)));
+  }
+
+  double DemTileCache::heightAt(double x, double y)
+  {
+    auto found = tileAt(x, y);
+    return found ? found->heightAt(x, y) : not_a_number;
+  }
+
+  TerrainHit intersectTerrain(DemTileCache& cache, Vector3d const& origin, Vector3d const& direction, double max_distance)
+  {
+    TileLookup lookup(cache);
+    return intersect(lookup, cache, origin, direction, max_distance);
+  }
+
+  void intersectTerrain(
+    DemTileCache& cache,
+    size_t count,
+    Vector3d const& origin,
+    ConstVector3dArrays directions,
+    double max_distance,
+    Vector3dArrays points,
+    double* distances
+  )
+  {
+    intersectTerrain(cache, count, origin, directions, max_distance, points, distances, sequentialExecutor(), count);
+  }
+
+  void intersectTerrain(
+    DemTileCache& cache,
+    size_t count,
+    Vector3d const& origin,
+    ConstVector3dArrays directions,
+    double max_distance,
+    Vector3dArrays points,
+    double* distances,
+    Executor& executor,
+    size_t chunk_size
+  )
+  {
+    executor.parallelFor(count, chunk_size, [&](size_t begin, size_t end) {
+      // Neighbouring rays of a chunk mostly hit the same tiles, so every chunk keeps its own last tile
+      TileLookup lookup(cache);
+      for(auto i = begin; i < end; ++i) {
+        auto hit = intersect(lookup, cache, origin, {directions.x[i], directions.y[i], directions.z[i]}, max_distance);
+        points.x[i] = hit.point.x;
+        points.y[i] = hit.point.y;
+        points.z[i] = hit.point.z;
+        distances[i] = hit.distance;
+      }
+    });
+  }
+
+}  // namespace cpp_math
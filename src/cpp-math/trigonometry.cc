@@ -0,0 +1,38 @@
+#include <cpp-math/batch.h>
+#include <cpp-math/trigonometry.h>
+
+#include "batch_kernels.h"
+#include "sincos_impl.h"
+
+namespace cpp_math
+{
+  void sincosDeg(double degrees, double& sin_result, double& cos_result, TrigPolicy policy) noexcept
+  {
+    switch(policy) {
+      case TrigPolicy::Standard:
+      case TrigPolicy::Ulp1:
+        return detail::sincosDegrees<TrigPolicy::Ulp1>(degrees, sin_result, cos_result);
+      case TrigPolicy::AbsError1e9:
+        return detail::sincosDegrees<TrigPolicy::AbsError1e9>(degrees, sin_result, cos_result);
+      case TrigPolicy::AbsError1e6:
+        return detail::sincosDegrees<TrigPolicy::AbsError1e6>(degrees, sin_result, cos_result);
+    }
+  }
+
+  void sincosDeg(size_t count, double const* degrees, double* sin_result, double* cos_result, TrigPolicy policy)
+  {
+    switch(bestSimdLevel()) {
+#if defined(CPP_MATH_X86_KERNELS)
+      case SimdLevel::Avx512: return detail::sincosDegreesAvx512(policy, count, degrees, sin_result, cos_result);
+      case SimdLevel::Avx2: return detail::sincosDegreesAvx2(policy, count, degrees, sin_result, cos_result);
+      case SimdLevel::Sse2: return detail::sincosDegreesSse2(policy, count, degrees, sin_result, cos_result);
+#else
+      case SimdLevel::Avx512:
+      case SimdLevel::Avx2:
+      case SimdLevel::Sse2:
+#endif
+      case SimdLevel::None: return detail::sincosDegreesGeneric(policy, count, degrees, sin_result, cos_result);
+    }
+  }
+
+}  // namespace cpp_math
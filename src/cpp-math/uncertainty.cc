@@ -0,0 +1,302 @@
+#include <cpp-math/uncertainty.h>
+#include <cpp-math/vector_expression.h>
+
+#include "rotation_order.h"
+
+#include <cmath>
+
+namespace
+{
+  using namespace cpp_math;
+
+  constexpr double radians_per_degree = 3.14159265358979323846 / 180;
+
+  /// @brief Rotation by one of the angles, indexed by HeliAngle
+  struct Step
+  {
+    bool is_zero;
+    Mat3 matrix;
+  };
+
+  using Steps = std::array<Step, 3>;
+
+  Step const& findStep(Steps const& steps, HeliAngle angle) noexcept
+  {
+    return steps[static_cast<size_t>(angle)];
+  }
+
+  Vector3d cross(Vector3d const& a, Vector3d const& b) noexcept
+  {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+  }
+
+  /// @return Derivative of the rotation about the axis of angle applied to v by radians, axis x v
+  Vector3d rotationDerivative(HeliAngle angle, Vector3d const& v) noexcept
+  {
+    switch(angle) {
+      case HeliAngle::Roll: return cross({1, 0, 0}, v);
+      case HeliAngle::Pitch: return cross({0, 1, 0}, v);
+      case HeliAngle::Yaw: return cross({0, 0, 1}, v);
+    }
+    return {0, 0, 0};
+  }
+
+  Axis rotationAxis(HeliAngle angle) noexcept
+  {
+    switch(angle) {
+      case HeliAngle::Roll: return Axis::X;
+      case HeliAngle::Pitch: return Axis::Y;
+      case HeliAngle::Yaw: return Axis::Z;
+    }
+    return Axis::X;
+  }
+
+  /**
+   * @brief Finds the order in which rotateVector applies the angles to the X axis
+   * @note Same checks as rotateVector, so the direction is the same bits
+   * @return false if no order can be applied, rotateVector returns the vector itself then
+   */
+  bool resolveOrder(Steps const& steps, std::array<HeliAngle, 3>& order, std::array<Vector3d, 3>& partial) noexcept
+  {
+    for(auto const& candidate : detail::angles_permutations) {
+      auto v = Vector3d{1, 0, 0};
+      auto applied = true;
+      for(size_t i = 0; i < candidate.size() and applied; ++i) {
+        auto const& step = findStep(steps, candidate[i]);
+        if(not step.is_zero) {
+          applied = detail::can_rotate(v, candidate[i]);
+          v = multiplyMatrixByVector(step.matrix, v);
+        }
+        partial[i] = v;
+      }
+      if(applied) {
+        order = candidate;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Vector3d& column(PointJacobian& jacobian, PointInput input) noexcept
+  {
+    return jacobian.columns[static_cast<size_t>(input)];
+  }
+
+  Vector3d& column(PointJacobian& jacobian, HeliAngle angle) noexcept
+  {
+    switch(angle) {
+      case HeliAngle::Roll: return column(jacobian, PointInput::Roll);
+      case HeliAngle::Pitch: return column(jacobian, PointInput::Pitch);
+      case HeliAngle::Yaw: return column(jacobian, PointInput::Yaw);
+    }
+    return column(jacobian, PointInput::Roll);
+  }
+
+  /// @brief Adds variance * column * column^T to the upper triangle xx, xy, xz, yy, yz, zz
+  void addOuterProduct(std::array<double, 6>& covariance, Vector3d const& column, double variance) noexcept
+  {
+    auto x = column.x * variance;
+    auto y = column.y * variance;
+    auto z = column.z * variance;
+    covariance[0] += x * column.x;
+    covariance[1] += x * column.y;
+    covariance[2] += x * column.z;
+    covariance[3] += y * column.y;
+    covariance[4] += y * column.z;
+    covariance[5] += z * column.z;
+  }
+
+  double valueOr(double const* values, size_t i, double fallback) noexcept
+  {
+    return values == nullptr ? fallback : values[i];
+  }
+
+  void store(Vector3d const& point, std::array<double, 6> const& covariance, size_t i, Vector3dArrays points, CovarianceArrays covariances) noexcept
+  {
+    points.x[i] = point.x;
+    points.y[i] = point.y;
+    points.z[i] = point.z;
+    covariances.xx[i] = covariance[0];
+    covariances.xy[i] = covariance[1];
+    covariances.xz[i] = covariance[2];
+    covariances.yy[i] = covariance[3];
+    covariances.yz[i] = covariance[4];
+    covariances.zz[i] = covariance[5];
+  }
+
+  template<class Process>
+  void forEachPoint(
+    size_t count,
+    double const* distances,
+    ConstVector3dArrays initial_positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    Executor& executor,
+    size_t chunk_size,
+    Process const& process
+  )
+  {
+    executor.parallelFor(count, chunk_size, [&](size_t begin, size_t end) {
+      PointJacobian jacobian;
+      for(auto i = begin; i < end; ++i) {
+        auto point = calculatePointWithJacobian(
+          distances[i],
+          {initial_positions.x[i], initial_positions.y[i], initial_positions.z[i]},
+          {angles.yaw[i], angles.pitch[i], angles.roll[i]},
+          {camera_angles.yaw[i], camera_angles.pitch[i]},
+          jacobian
+        );
+        process(i, point, jacobian);
+      }
+    });
+  }
+}  // namespace
+
+namespace cpp_math
+{
+
+  Vector3d calculatePointWithJacobian(
+    double distance,
+    Vector3d const& initial_position,
+    HeliAngles const& angles,
+    CameraAngles const& camera_angles,
+    PointJacobian& jacobian
+  ) noexcept
+  {
+    auto total = angles;
+    total.pitch += camera_angles.pitch;
+    total.yaw += camera_angles.yaw;
+
+    Steps steps;
+    for(auto angle : {HeliAngle::Roll, HeliAngle::Pitch, HeliAngle::Yaw}) {
+      auto degrees = detail::getAngle(total, angle);
+      auto is_zero = detail::close_to_zero(degrees);
+      steps[static_cast<size_t>(angle)] = Step{
+        is_zero,
+        is_zero ? identityMatrix() : calculateRotationMatrixFromDegrees(rotationAxis(angle), degrees, TrigPolicy::Standard)
+      };
+    }
+
+    auto direction = Vector3d{1, 0, 0};
+    for(auto angle : {HeliAngle::Roll, HeliAngle::Pitch, HeliAngle::Yaw}) {
+      column(jacobian, angle) = Vector3d{0, 0, 0};
+    }
+    std::array<HeliAngle, 3> order;
+    std::array<Vector3d, 3> partial;
+    if(resolveOrder(steps, order, partial)) {
+      direction = partial[2];
+      // Rotation applied by step k moves the vector after it by axis x vector, later steps rotate that
+      auto const scale = distance * radians_per_degree;
+      for(size_t k = 0; k < order.size(); ++k) {
+        auto derivative = rotationDerivative(order[k], partial[k]);
+        for(auto later = k + 1; later < order.size(); ++later) {
+          auto const& step = findStep(steps, order[later]);
+          if(not step.is_zero) {
+            derivative = multiplyMatrixByVector(step.matrix, derivative);
+          }
+        }
+        column(jacobian, order[k]) = Vector3d{derivative.x * scale, derivative.y * scale, derivative.z * scale};
+      }
+    }
+
+    column(jacobian, PointInput::Distance) = direction;
+    column(jacobian, PointInput::X) = Vector3d{1, 0, 0};
+    column(jacobian, PointInput::Y) = Vector3d{0, 1, 0};
+    column(jacobian, PointInput::Z) = Vector3d{0, 0, 1};
+    column(jacobian, PointInput::CameraYaw) = jacobian[PointInput::Yaw];
+    column(jacobian, PointInput::CameraPitch) = jacobian[PointInput::Pitch];
+
+    // The same expression as calculatePointByDistanceAndAngles, so the point has the same bits
+    return initial_position + distance * direction;
+  }
+
+  Mat3 propagateCovariance(PointJacobian const& jacobian, PointInputCovariance const& covariance) noexcept
+  {
+    // Rows of jacobian * covariance, 3 x 9
+    std::array<std::array<double, point_inputs_count>, 3> product{};
+    for(size_t i = 0; i < point_inputs_count; ++i) {
+      for(size_t j = 0; j < point_inputs_count; ++j) {
+        auto const& c = jacobian.columns[j];
+        product[0][i] += c.x * covariance[j][i];
+        product[1][i] += c.y * covariance[j][i];
+        product[2][i] += c.z * covariance[j][i];
+      }
+    }
+
+    Mat3 result{};
+    for(size_t row = 0; row < 3; ++row) {
+      for(size_t col = row; col < 3; ++col) {
+        double value = 0;
+        for(size_t i = 0; i < point_inputs_count; ++i) {
+          auto const& c = jacobian.columns[i];
+          value += product[row][i] * (col == 0 ? c.x : col == 1 ? c.y : c.z);
+        }
+        result[row][col] = value;
+        result[col][row] = value;
+      }
+    }
+    return result;
+  }
+
+  void calculatePointsWithCovariance(
+    size_t count,
+    double const* distances,
+    ConstVector3dArrays initial_positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    PointInputSigmas sigmas,
+    Vector3dArrays points,
+    CovarianceArrays covariances,
+    Executor& executor,
+    size_t chunk_size
+  )
+  {
+    auto variance = [](double const* sigma, size_t i) {
+      auto value = valueOr(sigma, i, 0);
+      return value * value;
+    };
+    forEachPoint(
+      count, distances, initial_positions, angles, camera_angles, executor, chunk_size,
+      [&](size_t i, Vector3d const& point, PointJacobian const& jacobian) {
+        // Independent inputs, so the covariance is a sum of variance * column * column^T
+        std::array<double, 6> covariance{
+          variance(sigmas.position.x, i), 0, 0, variance(sigmas.position.y, i), 0, variance(sigmas.position.z, i)
+        };
+        addOuterProduct(covariance, jacobian[PointInput::Distance], variance(sigmas.distance, i));
+        addOuterProduct(
+          covariance, jacobian[PointInput::Yaw], variance(sigmas.angles.yaw, i) + variance(sigmas.camera_angles.yaw, i)
+        );
+        addOuterProduct(
+          covariance,
+          jacobian[PointInput::Pitch],
+          variance(sigmas.angles.pitch, i) + variance(sigmas.camera_angles.pitch, i)
+        );
+        addOuterProduct(covariance, jacobian[PointInput::Roll], variance(sigmas.angles.roll, i));
+        store(point, covariance, i, points, covariances);
+      }
+    );
+  }
+
+  void calculatePointsWithCovariance(
+    size_t count,
+    double const* distances,
+    ConstVector3dArrays initial_positions,
+    HeliAnglesArrays angles,
+    CameraAnglesArrays camera_angles,
+    PointInputCovariance const& covariance,
+    Vector3dArrays points,
+    CovarianceArrays covariances,
+    Executor& executor,
+    size_t chunk_size
+  )
+  {
+    forEachPoint(
+      count, distances, initial_positions, angles, camera_angles, executor, chunk_size,
+      [&](size_t i, Vector3d const& point, PointJacobian const& jacobian) {
+        auto result = propagateCovariance(jacobian, covariance);
+        store(point, {result[0][0], result[0][1], result[0][2], result[1][1], result[1][2], result[2][2]}, i, points, covariances);
+      }
+    );
+  }
+
+}  // namespace cpp_math
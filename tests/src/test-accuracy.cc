@@ -0,0 +1,151 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/reference.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+  constexpr double distance = 1000;
+  cpp_math::Vector3d const position{100, -200, 1500};
+
+  struct Errors
+  {
+    double max_metres = 0;
+    double max_ulp = 0;
+
+    void add(cpp_math::Vector3d const& result, cpp_math::reference::LongVector3 const& expected)
+    {
+      max_metres = std::max(max_metres, static_cast<double>(cpp_math::reference::absoluteError(result, expected)));
+      max_ulp = std::max(max_ulp, cpp_math::reference::ulpError(result, expected));
+    }
+  };
+
+  struct Pose
+  {
+    cpp_math::HeliAngles angles;
+    cpp_math::CameraAngles camera_angles;
+    cpp_math::Vector3d vector;
+  };
+
+  /// @brief Bounds hold with several times of margin over what these samples give
+  void requireAccurate(std::vector<Pose> const& poses, double max_point_error, double max_rotation_ulp)
+  {
+    Errors rotations, rotations_ulp1, points, points_ulp1, batch;
+    std::vector<double> distances(poses.size(), distance), x(poses.size(), position.x), y(poses.size(), position.y),
+      z(poses.size(), position.z), yaw, pitch, roll, camera_yaw, camera_pitch, result_x(poses.size()),
+      result_y(poses.size()), result_z(poses.size());
+    for(auto const& pose : poses) {
+      yaw.push_back(pose.angles.yaw);
+      pitch.push_back(pose.angles.pitch);
+      roll.push_back(pose.angles.roll);
+      camera_yaw.push_back(pose.camera_angles.yaw);
+      camera_pitch.push_back(pose.camera_angles.pitch);
+    }
+    cpp_math::calculatePointsByDistanceAndAngles(
+      poses.size(),
+      distances.data(),
+      {x.data(), y.data(), z.data()},
+      {yaw.data(), pitch.data(), roll.data()},
+      {camera_yaw.data(), camera_pitch.data()},
+      {result_x.data(), result_y.data(), result_z.data()}
+    );
+
+    for(size_t i = 0; i < poses.size(); ++i) {
+      auto const& pose = poses[i];
+      auto rotation = cpp_math::reference::rotateVector(pose.vector, pose.angles);
+      rotations.add(cpp_math::rotateVector(pose.vector, pose.angles), rotation);
+      rotations_ulp1.add(cpp_math::rotateVector(pose.vector, pose.angles, cpp_math::TrigPolicy::Ulp1), rotation);
+
+      auto point = cpp_math::reference::calculatePointByDistanceAndAngles(distance, position, pose.angles, pose.camera_angles);
+      points.add(cpp_math::calculatePointByDistanceAndAngles(distance, position, pose.angles, pose.camera_angles), point);
+      points_ulp1.add(
+        cpp_math::calculatePointByDistanceAndAngles(distance, position, pose.angles, pose.camera_angles, cpp_math::TrigPolicy::Ulp1),
+        point
+      );
+      batch.add({result_x[i], result_y[i], result_z[i]}, point);
+    }
+    REQUIRE(rotations.max_ulp < max_rotation_ulp);
+    REQUIRE(rotations_ulp1.max_ulp < 4);
+    REQUIRE(points.max_metres < max_point_error);
+    REQUIRE(points_ulp1.max_metres < max_point_error);
+    REQUIRE(batch.max_metres < max_point_error);
+  }
+}  // namespace
+
+TEST_CASE("Reference")
+{
+  long double s, c;
+  cpp_math::reference::sincosDegrees(30, s, c);
+  REQUIRE(std::abs(s - 0.5L) < 1e-18L);
+  // Reduction is exact, a quarter turn after 1e12 turns is exactly a quarter turn
+  cpp_math::reference::sincosDegrees(360e12 + 90, s, c);
+  REQUIRE(s == 1);
+  REQUIRE(c == 0);
+
+  auto rotated = cpp_math::reference::rotateVector({1, 0, 0}, {90, 0, 0});
+  REQUIRE(std::abs(rotated.x) < 1e-18L);
+  REQUIRE(rotated.y == 1);
+  // Zero vector can not be rotated, it comes back like from rotateVector
+  auto zero = cpp_math::reference::rotateVector({0, 0, 0}, {30, 20, 10});
+  REQUIRE((zero.x == 0 and zero.y == 0 and zero.z == 0));
+  REQUIRE(cpp_math::reference::ulpError(cpp_math::Vector3d{0.5, 0, 0}, {0.5L + 0x1p-54L, 0, 0}) == Approx(0.5));
+}
+
+TEST_CASE("Accuracy against the long double reference")
+{
+  std::mt19937_64 generator(23);
+  std::uniform_real_distribution<double> angle(-180, 180);
+  std::normal_distribution<double> normal(0, 1);
+  auto vector = [&]() { return cpp_math::Vector3d{normal(generator), normal(generator), normal(generator)}; };
+
+  SECTION("Random angles")
+  {
+    std::vector<Pose> poses;
+    for(size_t i = 0; i < 5000; ++i) {
+      poses.push_back({{angle(generator), angle(generator), angle(generator)}, {angle(generator), angle(generator)}, vector()});
+    }
+    requireAccurate(poses, 1e-11, 64);
+  }
+
+  SECTION("Pitch about +-90 degrees")
+  {
+    std::vector<Pose> poses;
+    double const offsets[] = {0, 1e-15, -1e-13, 1e-9, -1e-6};
+    for(size_t i = 0; i < 5000; ++i) {
+      auto camera_pitch = i % 3 == 0 ? 0.0 : angle(generator);
+      auto pitch = (i % 2 == 0 ? 90 : -90) + offsets[i % 5] - camera_pitch;
+      poses.push_back({{angle(generator), pitch, angle(generator)}, {angle(generator), camera_pitch}, vector()});
+    }
+    requireAccurate(poses, 1e-11, 64);
+  }
+
+  SECTION("Angles and components about the threshold of close_to_zero")
+  {
+    std::vector<Pose> poses;
+    double const tiny[] = {0, 1e-16, 1e-14, 2.2e-14, 3e-14, 1e-12};
+    for(size_t i = 0; i < 5000; ++i) {
+      auto pick = [&](size_t shift) { return (i >> shift) % 3 == 0 ? tiny[(i + shift) % 6] : angle(generator); };
+      poses.push_back({{pick(0), pick(2), pick(4)}, {0, 0}, {1, tiny[i % 6], tiny[(i / 6) % 6]}});
+    }
+    requireAccurate(poses, 1e-11, 64);
+  }
+
+  SECTION("Multi-turn angles")
+  {
+    // Exact reduction keeps Ulp1 rotations as precise as for small angles. Points lose more since
+    // camera angles are added in double, and Standard converts huge degrees to radians with rounding
+    std::uniform_real_distribution<double> turns(-1e6, 1e6);
+    auto big = [&]() { return 360 * std::round(turns(generator)) + angle(generator); };
+    std::vector<Pose> poses;
+    for(size_t i = 0; i < 5000; ++i) {
+      poses.push_back({{big(), big(), big()}, {big(), big()}, vector()});
+    }
+    requireAccurate(poses, 1e-4, 1e9);
+  }
+}
@@ -0,0 +1,155 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <random>
+#include <vector>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  std::atomic<uint64_t> allocations(0);
+
+  /// @brief Straightforward version of rotateVector, which tries every order with Axis rotations
+  cpp_math::Vector3d reference_rotate(cpp_math::Vector3d const& v, cpp_math::HeliAngles const& angles)
+  {
+    using cpp_math::HeliAngle;
+    if(angles.roll == 0 && angles.pitch == 0 && angles.yaw == 0) {
+      return v;
+    }
+    auto close_to_zero = [](double value) { return std::abs(value) < std::numeric_limits<double>::epsilon() * 100; };
+    auto get_angle = [&](HeliAngle angle) {
+      return angle == HeliAngle::Yaw ? angles.yaw : angle == HeliAngle::Pitch ? angles.pitch : angles.roll;
+    };
+    auto can_rotate = [&](cpp_math::Vector3d const& u, HeliAngle angle) {
+      if(angle == HeliAngle::Yaw) {
+        return not close_to_zero(u.x) or not close_to_zero(u.y);
+      }
+      if(angle == HeliAngle::Pitch) {
+        return not close_to_zero(u.x) or not close_to_zero(u.z);
+      }
+      return not close_to_zero(u.z) or not close_to_zero(u.y);
+    };
+    std::vector<std::array<HeliAngle, 3>> const orders = {
+      {HeliAngle::Roll, HeliAngle::Pitch, HeliAngle::Yaw}, {HeliAngle::Roll, HeliAngle::Yaw, HeliAngle::Pitch},
+      {HeliAngle::Yaw, HeliAngle::Roll, HeliAngle::Pitch}, {HeliAngle::Yaw, HeliAngle::Pitch, HeliAngle::Roll},
+      {HeliAngle::Pitch, HeliAngle::Roll, HeliAngle::Yaw}, {HeliAngle::Pitch, HeliAngle::Yaw, HeliAngle::Roll},
+    };
+    for(auto const& order : orders) {
+      auto result = v;
+      auto rotated = true;
+      for(auto angle : order) {
+        if(close_to_zero(get_angle(angle))) {
+          continue;
+        }
+        if(not can_rotate(result, angle)) {
+          rotated = false;
+          break;
+        }
+        result = cpp_math::rotateVector(result, cpp_math::heliAngleToRotationAxis(angle), get_angle(angle));
+      }
+      if(rotated) {
+        return result;
+      }
+    }
+    return v;
+  }
+
+  /// @brief Angles where some of them are zero or the vector lies on a rotation axis
+  std::vector<cpp_math::HeliAngles> test_angles()
+  {
+    std::mt19937_64 generator(5);
+    std::uniform_real_distribution<double> angle(-180, 180);
+    std::vector<cpp_math::HeliAngles> result;
+    for(int i = 0; i < 4000; ++i) {
+      auto angles = cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)};
+      if(i % 2) {
+        angles.yaw = 0;
+      }
+      if(i % 3 == 0) {
+        angles.pitch = i % 4 ? 90 : -90;
+      }
+      if(i % 5 == 0) {
+        angles.roll = 0;
+      }
+      result.push_back(angles);
+    }
+    return result;
+  }
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if(auto result = std::malloc(size == 0 ? 1 : size)) {
+    return result;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+TEST_CASE("Rotations do not allocate")
+{
+  static_assert(noexcept(cpp_math::rotateVector(cpp_math::Vector3d{}, cpp_math::HeliAngles{})), "");
+  static_assert(noexcept(cpp_math::calculatePointByDistanceAndAngles(0, {}, {}, {})), "");
+
+  auto angles = test_angles();
+  std::vector<cpp_math::Vector3d> vectors = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, 2, 3}, {-3, 0, 4}};
+
+  SECTION("rotateVector")
+  {
+    std::vector<cpp_math::Vector3d> results;
+    results.reserve(angles.size() * vectors.size() * 2);
+    auto allocations_before = allocations.load();
+    for(auto const& v : vectors) {
+      for(auto const& heli_angles : angles) {
+        results.push_back(cpp_math::rotateVector(v, heli_angles));
+        results.push_back(cpp_math::rotateVector(v, heli_angles, cpp_math::TrigPolicy::Ulp1));
+      }
+    }
+    REQUIRE(allocations.load() == allocations_before);
+  }
+
+  SECTION("calculatePointByDistanceAndAngles")
+  {
+    double sum = 0;
+    auto allocations_before = allocations.load();
+    for(auto const& heli_angles : angles) {
+      auto point = cpp_math::calculatePointByDistanceAndAngles(100, {1, 2, 3}, heli_angles, {heli_angles.roll, 0});
+      sum += point.x + point.y + point.z;
+    }
+    REQUIRE(allocations.load() == allocations_before);
+    REQUIRE(std::isfinite(sum));
+  }
+
+  SECTION("Results are the same as trying every order")
+  {
+    for(auto const& v : vectors) {
+      for(auto const& heli_angles : angles) {
+        auto expected = reference_rotate(v, heli_angles);
+        auto result = cpp_math::rotateVector(v, heli_angles);
+        INFO("Heli angles are " << heli_angles);
+        INFO("Source vector is " << v);
+        REQUIRE(result.x == expected.x);
+        REQUIRE(result.y == expected.y);
+        REQUIRE(result.z == expected.z);
+      }
+    }
+  }
+}
@@ -0,0 +1,157 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  struct PointsInput
+  {
+    std::vector<double> distances, x, y, z, yaw, pitch, roll, camera_yaw, camera_pitch;
+
+    void add(double distance, cpp_math::Vector3d p, cpp_math::HeliAngles a, cpp_math::CameraAngles c)
+    {
+      distances.push_back(distance);
+      x.push_back(p.x);
+      y.push_back(p.y);
+      z.push_back(p.z);
+      yaw.push_back(a.yaw);
+      pitch.push_back(a.pitch);
+      roll.push_back(a.roll);
+      camera_yaw.push_back(c.yaw);
+      camera_pitch.push_back(c.pitch);
+    }
+
+    size_t size() const { return distances.size(); }
+  };
+
+  struct PointsOutput
+  {
+    std::vector<double> x, y, z;
+
+    explicit PointsOutput(size_t count) :
+      x(count),
+      y(count),
+      z(count)
+    {}
+  };
+
+  template <class Mode>
+  PointsOutput calculate(PointsInput const& input, Mode mode)
+  {
+    auto output = PointsOutput(input.size());
+    cpp_math::calculatePointsByDistanceAndAngles(
+      input.size(),
+      input.distances.data(),
+      cpp_math::ConstVector3dArrays{input.x.data(), input.y.data(), input.z.data()},
+      cpp_math::HeliAnglesArrays{input.yaw.data(), input.pitch.data(), input.roll.data()},
+      cpp_math::CameraAnglesArrays{input.camera_yaw.data(), input.camera_pitch.data()},
+      cpp_math::Vector3dArrays{output.x.data(), output.y.data(), output.z.data()},
+      mode
+    );
+    return output;
+  }
+
+  /// @brief Angles which walk through every branch of rotation order selection
+  PointsInput cornerCases()
+  {
+    auto input = PointsInput();
+    auto values = {0.0, 1e-15, 30.0, 45.0, 90.0, -90.0, 180.0, 270.0, -360.0, 1e5 + 0.5};
+    for(auto yaw : values) {
+      for(auto pitch : values) {
+        for(auto roll : values) {
+          input.add(100, cpp_math::Vector3d{1, 2, 3}, cpp_math::HeliAngles{yaw, pitch, roll}, cpp_math::CameraAngles{0, 0});
+        }
+      }
+    }
+    return input;
+  }
+
+  PointsInput randomInput(size_t count)
+  {
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> angle(-720, 720);
+    std::uniform_real_distribution<double> coordinate(-1000, 1000);
+    std::uniform_real_distribution<double> distance(0, 20000);
+    auto input = PointsInput();
+    for(size_t i = 0; i < count; ++i) {
+      input.add(
+        distance(generator),
+        cpp_math::Vector3d{coordinate(generator), coordinate(generator), coordinate(generator)},
+        cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)},
+        cpp_math::CameraAngles{angle(generator), angle(generator)}
+      );
+    }
+    return input;
+  }
+}  // namespace
+
+TEST_CASE("calculatePointsByDistanceAndAngles")
+{
+  auto levels = {
+    cpp_math::SimdLevel::None,
+    cpp_math::SimdLevel::Sse2,
+    cpp_math::SimdLevel::Avx2,
+    cpp_math::SimdLevel::Avx512,
+  };
+
+  SECTION("Strict mode is bit-for-bit identical to single calls")
+  {
+    auto input = randomInput(1000);
+    auto output = calculate(input, cpp_math::BatchMode::Strict);
+    for(size_t i = 0; i < input.size(); ++i) {
+      auto expected = cpp_math::calculatePointByDistanceAndAngles(
+        input.distances[i],
+        cpp_math::Vector3d{input.x[i], input.y[i], input.z[i]},
+        cpp_math::HeliAngles{input.yaw[i], input.pitch[i], input.roll[i]},
+        cpp_math::CameraAngles{input.camera_yaw[i], input.camera_pitch[i]}
+      );
+      REQUIRE(std::memcmp(&output.x[i], &expected.x, sizeof(double)) == 0);
+      REQUIRE(std::memcmp(&output.y[i], &expected.y, sizeof(double)) == 0);
+      REQUIRE(std::memcmp(&output.z[i], &expected.z, sizeof(double)) == 0);
+    }
+  }
+
+  SECTION("Every SIMD level matches single calls")
+  {
+    auto random = randomInput(1003);
+    auto corners = cornerCases();
+    for(auto const* input : {&random, &corners}) {
+      auto expected = calculate(*input, cpp_math::BatchMode::Strict);
+      for(auto level : levels) {
+        auto output = calculate(*input, level);
+        for(size_t i = 0; i < input->size(); ++i) {
+          auto angles = cpp_math::HeliAngles{input->yaw[i], input->pitch[i], input->roll[i]};
+          auto camera_angles = cpp_math::CameraAngles{input->camera_yaw[i], input->camera_pitch[i]};
+          INFO("SIMD level is " << level);
+          INFO("Heli angles are " << angles);
+          INFO("Camera angles are " << camera_angles);
+          REQUIRE(std::abs(output.x[i] - expected.x[i]) < 1e-8);
+          REQUIRE(std::abs(output.y[i] - expected.y[i]) < 1e-8);
+          REQUIRE(std::abs(output.z[i] - expected.z[i]) < 1e-8);
+        }
+      }
+    }
+  }
+
+  SECTION("Short batches")
+  {
+    for(size_t count = 0; count < 20; ++count) {
+      auto input = randomInput(count);
+      auto expected = calculate(input, cpp_math::BatchMode::Strict);
+      auto output = calculate(input, cpp_math::BatchMode::Fast);
+      for(size_t i = 0; i < count; ++i) {
+        REQUIRE(std::abs(output.x[i] - expected.x[i]) < 1e-8);
+        REQUIRE(std::abs(output.y[i] - expected.y[i]) < 1e-8);
+        REQUIRE(std::abs(output.z[i] - expected.z[i]) < 1e-8);
+      }
+    }
+  }
+}
@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/camera.h>
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/executor.h>
+#include <cpp-math/heli_attitude.h>
+
+#include <cmath>
+#include <vector>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  bool vectors_almost_equal(
+    cpp_math::Vector3d const& v1,
+    cpp_math::Vector3d const& v2,
+    double epsilon
+  )
+  {
+    return std::abs(v1.x - v2.x) < epsilon && std::abs(v1.y - v2.y) < epsilon
+        && std::abs(v1.z - v2.z) < epsilon;
+  }
+
+  cpp_math::CameraIntrinsics pinhole()
+  {
+    return cpp_math::CameraIntrinsics{
+      .width = 641,
+      .height = 481,
+      .fx = 500,
+      .fy = 500,
+      .cx = 320,
+      .cy = 240,
+      .k1 = 0,
+      .k2 = 0,
+      .k3 = 0,
+      .p1 = 0,
+      .p2 = 0,
+    };
+  }
+
+  struct Rays
+  {
+    std::vector<double> x, y, z;
+
+    explicit Rays(size_t count) :
+      x(count),
+      y(count),
+      z(count)
+    {}
+
+    cpp_math::Vector3dArrays arrays() { return {x.data(), y.data(), z.data()}; }
+
+    cpp_math::Vector3d at(size_t i) const { return cpp_math::Vector3d{x[i], y[i], z[i]}; }
+  };
+}  // namespace
+
+TEST_CASE("PixelRayGrid")
+{
+  SECTION("Pinhole rays")
+  {
+    auto grid = cpp_math::PixelRayGrid(pinhole());
+    REQUIRE(grid.size() == 641 * 481);
+    REQUIRE(vectors_almost_equal(grid.ray(320, 240), cpp_math::Vector3d{1, 0, 0}, 1e-15));
+
+    // Right edge of the image looks to the right, i.e. negative Y
+    auto right = grid.ray(640, 240);
+    auto expected = cpp_math::Vector3d{500, -320, 0};
+    auto norm = std::sqrt(500.0 * 500 + 320 * 320);
+    REQUIRE(vectors_almost_equal(right, cpp_math::multiplyVectorByScalar(expected, 1 / norm), 1e-15));
+
+    // Bottom of the image looks down
+    REQUIRE(grid.ray(320, 480).z < 0);
+  }
+
+  SECTION("Distorted rays project back to their pixels")
+  {
+    auto intrinsics = pinhole();
+    intrinsics.k1 = -0.2;
+    intrinsics.k2 = 0.05;
+    intrinsics.p1 = 0.001;
+    intrinsics.p2 = -0.0005;
+    auto grid = cpp_math::PixelRayGrid(intrinsics);
+    for(size_t row = 0; row < intrinsics.height; row += 60) {
+      for(size_t column = 0; column < intrinsics.width; column += 80) {
+        auto ray = grid.ray(column, row);
+        auto x = -ray.y / ray.x;
+        auto y = -ray.z / ray.x;
+        auto r2 = x * x + y * y;
+        auto radial = 1 + r2 * (intrinsics.k1 + r2 * (intrinsics.k2 + r2 * intrinsics.k3));
+        auto distorted_x = x * radial + 2 * intrinsics.p1 * x * y + intrinsics.p2 * (r2 + 2 * x * x);
+        auto distorted_y = y * radial + intrinsics.p1 * (r2 + 2 * y * y) + 2 * intrinsics.p2 * x * y;
+        INFO("Pixel is " << column << ", " << row);
+        REQUIRE(std::abs(distorted_x * intrinsics.fx + intrinsics.cx - column) < 1e-6);
+        REQUIRE(std::abs(distorted_y * intrinsics.fy + intrinsics.cy - row) < 1e-6);
+      }
+    }
+  }
+
+  SECTION("Principal point looks where calculatePointByDistanceAndAngles does")
+  {
+    auto grid = cpp_math::PixelRayGrid(pinhole());
+    auto heli_angles = cpp_math::HeliAngles{.yaw = 30, .pitch = 10, .roll = 20};
+    auto camera_angles = cpp_math::CameraAngles{.yaw = -10, .pitch = 35};
+    auto attitude = cpp_math::HeliAttitude(heli_angles, camera_angles);
+    auto rays = Rays(grid.size());
+    grid.calculateRays(attitude, rays.arrays());
+
+    auto expected = cpp_math::calculatePointByDistanceAndAngles(1, cpp_math::Vector3d{0, 0, 0}, heli_angles, camera_angles);
+    auto result = rays.at(grid.index(320, 240));
+    INFO("Ray expected is " << expected);
+    INFO("Ray of principal point is " << result);
+    REQUIRE(vectors_almost_equal(result, expected, 1e-12));
+  }
+
+  SECTION("Threads give the same rays")
+  {
+    auto grid = cpp_math::PixelRayGrid(pinhole());
+    auto attitude = cpp_math::HeliAttitude(cpp_math::HeliAngles{.yaw = 10, .pitch = 60, .roll = 5});
+    auto single = Rays(grid.size());
+    auto multiple = Rays(grid.size());
+    grid.calculateGroundPoints(attitude, cpp_math::Vector3d{0, 0, 100}, 0, single.arrays());
+    cpp_math::ThreadPoolExecutor pool(4);
+    grid.calculateGroundPoints(attitude, cpp_math::Vector3d{0, 0, 100}, 0, multiple.arrays(), pool);
+    REQUIRE(single.x == multiple.x);
+    REQUIRE(single.y == multiple.y);
+  }
+
+  SECTION("Ground points")
+  {
+    auto grid = cpp_math::PixelRayGrid(pinhole());
+    auto heli_angles = cpp_math::HeliAngles{.yaw = 0, .pitch = 45, .roll = 0};
+    auto attitude = cpp_math::HeliAttitude(heli_angles);
+    auto points = Rays(grid.size());
+    grid.calculateGroundPoints(attitude, cpp_math::Vector3d{0, 0, 100}, 0, points.arrays());
+    REQUIRE(vectors_almost_equal(points.at(grid.index(320, 240)), cpp_math::Vector3d{100, 0, 0}, 1e-9));
+    // The top row looks 45 - atan(240 / 500) degrees below the horizon, still on the ground
+    REQUIRE(std::abs(points.z[grid.index(0, 0)]) < 1e-9);
+
+    auto looking_up = cpp_math::HeliAttitude(cpp_math::HeliAngles{.yaw = 0, .pitch = -45, .roll = 0});
+    grid.calculateGroundPoints(looking_up, cpp_math::Vector3d{0, 0, 100}, 0, points.arrays());
+    REQUIRE(std::isnan(points.x[grid.index(320, 240)]));
+  }
+}
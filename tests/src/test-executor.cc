@@ -0,0 +1,240 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/batch.h>
+#include <cpp-math/camera.h>
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/executor.h>
+#include <cpp-math/fixed_rotation.h>
+#include <cpp-math/heli_attitude.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+  struct Points
+  {
+    std::vector<double> distances, x, y, z, yaw, pitch, roll, camera_yaw, camera_pitch;
+
+    explicit Points(size_t count)
+    {
+      std::mt19937_64 generator(11);
+      std::uniform_real_distribution<double> angle(-720, 720);
+      std::uniform_real_distribution<double> coordinate(-1000, 1000);
+      for(auto vector : {&distances, &x, &y, &z}) {
+        for(size_t i = 0; i < count; ++i) {
+          vector->push_back(coordinate(generator));
+        }
+      }
+      for(auto vector : {&yaw, &pitch, &roll, &camera_yaw, &camera_pitch}) {
+        for(size_t i = 0; i < count; ++i) {
+          vector->push_back(angle(generator));
+        }
+      }
+    }
+
+    std::vector<double> calculate(cpp_math::Executor& executor, cpp_math::BatchMode mode, size_t chunk_size) const
+    {
+      auto count = distances.size();
+      std::vector<double> result(3 * count);
+      cpp_math::calculatePointsByDistanceAndAngles(
+        count,
+        distances.data(),
+        {x.data(), y.data(), z.data()},
+        {yaw.data(), pitch.data(), roll.data()},
+        {camera_yaw.data(), camera_pitch.data()},
+        {result.data(), result.data() + count, result.data() + 2 * count},
+        executor,
+        mode,
+        chunk_size
+      );
+      return result;
+    }
+  };
+
+  bool sameBits(std::vector<double> const& first, std::vector<double> const& second)
+  {
+    return first.size() == second.size()
+        and std::memcmp(first.data(), second.data(), first.size() * sizeof(double)) == 0;
+  }
+
+  cpp_math::CameraIntrinsics intrinsics()
+  {
+    return cpp_math::CameraIntrinsics{
+      .width = 321,
+      .height = 241,
+      .fx = 250,
+      .fy = 250,
+      .cx = 160,
+      .cy = 120,
+      .k1 = -0.1,
+      .k2 = 0.01,
+      .k3 = 0,
+      .p1 = 0.001,
+      .p2 = 0,
+    };
+  }
+}  // namespace
+
+TEST_CASE("Executors run every index once")
+{
+  cpp_math::ThreadPoolExecutor pool(4);
+  std::vector<cpp_math::Executor*> executors = {&cpp_math::sequentialExecutor(), &pool};
+  for(auto executor : executors) {
+    for(size_t count : {0, 1, 7, 4096, 4097, 100000}) {
+      for(size_t chunk_size : {0, 1, 3, 64, 5000}) {
+        std::vector<std::atomic<int>> visits(count);
+        executor->parallelFor(count, chunk_size, [&](size_t begin, size_t end) {
+          for(auto i = begin; i < end; ++i) {
+            visits[i].fetch_add(1);
+          }
+        });
+        auto all_once = true;
+        for(auto& visit : visits) {
+          all_once = all_once and visit.load() == 1;
+        }
+        INFO("count " << count << ", chunk size " << chunk_size << ", concurrency " << executor->concurrency());
+        REQUIRE(all_once);
+      }
+    }
+  }
+}
+
+TEST_CASE("Chunks do not cross chunk boundaries")
+{
+  cpp_math::ThreadPoolExecutor pool(3);
+  std::atomic<bool> aligned(true);
+  pool.parallelFor(1000, 64, [&](size_t begin, size_t end) {
+    if(begin % 64 != 0 or (end != 1000 and end - begin != 64)) {
+      aligned = false;
+    }
+  });
+  REQUIRE(aligned.load());
+
+  // The last chunk is clamped without overflowing
+  cpp_math::Executor* executors[] = {&pool, &cpp_math::sequentialExecutor()};
+  for(auto* executor : executors) {
+    std::atomic<size_t> calls(0), covered(0);
+    executor->parallelFor(10, SIZE_MAX, [&](size_t begin, size_t end) {
+      ++calls;
+      covered += end - begin;
+    });
+    REQUIRE(calls.load() == 1);
+    REQUIRE(covered.load() == 10);
+  }
+}
+
+TEST_CASE("Exceptions of chunks")
+{
+  for(size_t threads : {1, 4}) {
+    cpp_math::ThreadPoolExecutor pool(threads);
+    std::atomic<size_t> started(0);
+    auto process = [&](size_t begin, size_t) {
+      ++started;
+      if(begin == 10) {
+        throw std::runtime_error("chunk 10");
+      }
+    };
+    INFO("threads " << threads);
+    REQUIRE_THROWS_WITH(pool.parallelFor(1000, 1, process), "chunk 10");
+    if(threads == 1) {
+      REQUIRE(started.load() == 11);
+    }
+
+    // The pool stays usable, also for nested batches on its threads
+    std::atomic<size_t> count(0);
+    pool.parallelFor(1000, 10, [&](size_t begin, size_t end) {
+      pool.parallelFor(end - begin, 1, [&](size_t, size_t) { ++count; });
+    });
+    REQUIRE(count.load() == 1000);
+  }
+  REQUIRE_THROWS_AS(
+    cpp_math::sequentialExecutor().parallelFor(10, 1, [](size_t, size_t) { throw std::runtime_error("sequential"); }),
+    std::runtime_error
+  );
+}
+
+TEST_CASE("Pool results are the same bits as sequential ones")
+{
+  auto points = Points(50000);
+
+  SECTION("Points")
+  {
+    for(auto mode : {cpp_math::BatchMode::Fast, cpp_math::BatchMode::Strict}) {
+      for(size_t chunk_size : {1000, 4096}) {
+        auto expected = points.calculate(cpp_math::sequentialExecutor(), mode, chunk_size);
+        for(size_t threads = 1; threads <= 8; ++threads) {
+          cpp_math::ThreadPoolExecutor pool(threads);
+          INFO("threads " << threads << ", chunk size " << chunk_size);
+          REQUIRE(sameBits(points.calculate(pool, mode, chunk_size), expected));
+        }
+      }
+    }
+  }
+
+  SECTION("Rays and ground points of a pixel grid")
+  {
+    auto grid = cpp_math::PixelRayGrid(intrinsics());
+    auto attitude = cpp_math::HeliAttitude(cpp_math::HeliAngles{30, 10, 5}, cpp_math::CameraAngles{20, -60});
+    auto count = grid.size();
+    auto arrays = [count](std::vector<double>& data) {
+      return cpp_math::Vector3dArrays{data.data(), data.data() + count, data.data() + 2 * count};
+    };
+    std::vector<double> expected_rays(3 * count), expected_points(3 * count);
+    grid.calculateRays(attitude, arrays(expected_rays));
+    grid.calculateGroundPoints(attitude, {0, 0, 500}, 0, arrays(expected_points));
+    for(size_t threads = 1; threads <= 8; ++threads) {
+      cpp_math::ThreadPoolExecutor pool(threads);
+      std::vector<double> rays(3 * count), ground_points(3 * count);
+      grid.calculateRays(attitude, arrays(rays), pool, 512);
+      grid.calculateGroundPoints(attitude, {0, 0, 500}, 0, arrays(ground_points), pool, 512);
+      INFO("threads " << threads);
+      REQUIRE(sameBits(rays, expected_rays));
+      REQUIRE(sameBits(ground_points, expected_points));
+    }
+  }
+
+  SECTION("Rotation compositions")
+  {
+    size_t count = 10000;
+    std::vector<cpp_math::Mat3> first, second;
+    for(size_t i = 0; i < count; ++i) {
+      first.push_back(cpp_math::makeRotation(cpp_math::HeliAngles{points.yaw[i], points.pitch[i], points.roll[i]}));
+      second.push_back(cpp_math::makeRotation(cpp_math::HeliAngles{points.camera_yaw[i], points.camera_pitch[i], 0}));
+    }
+    std::vector<cpp_math::Mat3> expected(count), result(count);
+    cpp_math::composeRotations(count, first.data(), second.data(), expected.data());
+    for(size_t i = 0; i < count; i += 997) {
+      auto single = cpp_math::composeRotations(first[i], second[i]);
+      REQUIRE(std::memcmp(&single, &expected[i], sizeof(single)) == 0);
+    }
+    cpp_math::ThreadPoolExecutor pool(5);
+    cpp_math::composeRotations(count, first.data(), second.data(), result.data(), pool, 100);
+    REQUIRE(std::memcmp(result.data(), expected.data(), count * sizeof(cpp_math::Mat3)) == 0);
+  }
+}
+
+TEST_CASE("Nested batches run on the calling thread")
+{
+  cpp_math::ThreadPoolExecutor pool(4);
+  cpp_math::ThreadPoolExecutor other(2);
+  std::atomic<size_t> sum(0);
+  pool.parallelFor(64, 1, [&](size_t begin, size_t) {
+    pool.parallelFor(10, 1, [&](size_t inner_begin, size_t) { sum += begin * 10 + inner_begin; });
+    other.parallelFor(10, 3, [&](size_t inner_begin, size_t inner_end) { sum += inner_end - inner_begin; });
+  });
+  REQUIRE(sum.load() == 639 * 640 / 2 + 64 * 10);
+}
+
+TEST_CASE("Pinned pool")
+{
+  cpp_math::ThreadPoolExecutor pool(3, cpp_math::CpuPinning::NumaCompact);
+  REQUIRE(pool.concurrency() == 3);
+  std::atomic<size_t> count(0);
+  pool.parallelFor(1000, 10, [&](size_t begin, size_t end) { count += end - begin; });
+  REQUIRE(count.load() == 1000);
+}
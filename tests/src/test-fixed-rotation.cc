@@ -0,0 +1,101 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/fixed_rotation.h>
+#include <cpp-math/heli_attitude.h>
+
+#include <cmath>
+#include <random>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  bool matrices_almost_equal(cpp_math::Mat3 const& m1, cpp_math::Mat3 const& m2, double epsilon)
+  {
+    for(size_t row = 0; row < 3; ++row) {
+      for(size_t col = 0; col < 3; ++col) {
+        if(std::abs(m1[row][col] - m2[row][col]) > epsilon) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool vectors_almost_equal(
+    cpp_math::Vector3d const& v1,
+    cpp_math::Vector3d const& v2,
+    double epsilon
+  )
+  {
+    return std::abs(v1.x - v2.x) < epsilon && std::abs(v1.y - v2.y) < epsilon
+        && std::abs(v1.z - v2.z) < epsilon;
+  }
+
+  // Everything below must be folded at compile time
+  using CameraMount = cpp_math::FixedRotation<cpp_math::Axis::Y, -5, 2>;
+  constexpr auto camera_mount = CameraMount::matrix();
+  constexpr auto lidar_mount = cpp_math::composeRotations(
+    cpp_math::makeRotation(cpp_math::Axis::Z, 180), cpp_math::makeRotation(cpp_math::Axis::X, 0.25)
+  );
+  constexpr auto quarter_turn = cpp_math::makeRotation(cpp_math::Axis::Z, 90);
+  static_assert(quarter_turn[0][0] == 0 && quarter_turn[1][0] == 1 && quarter_turn[0][1] == -1, "");
+  static_assert(cpp_math::makeRotation(cpp_math::Axis::X, -270)[2][1] == 1, "");
+  static_assert(CameraMount::degrees() == -2.5, "");
+  static_assert(cpp_math::makeRotation<float>(cpp_math::Axis::Y, 180)[0][0] == -1.0f, "");
+}  // namespace
+
+TEST_CASE("Fixed rotations")
+{
+  std::mt19937_64 generator(23);
+  std::uniform_real_distribution<double> angle(-720, 720);
+
+  SECTION("Matches runtime rotation matrices")
+  {
+    for(int i = 0; i < 10000; ++i) {
+      auto degrees = angle(generator);
+      for(auto axis : {cpp_math::Axis::X, cpp_math::Axis::Y, cpp_math::Axis::Z}) {
+        INFO("Angle is " << degrees);
+        REQUIRE(matrices_almost_equal(
+          cpp_math::makeRotation(axis, degrees), cpp_math::calculateRotationMatrixFromDegrees(axis, degrees, cpp_math::TrigPolicy::Ulp1),
+          4e-16
+        ));
+        REQUIRE(matrices_almost_equal(
+          cpp_math::makeRotation(axis, degrees), cpp_math::calculateRotationMatrix(axis, cpp_math::degreesToRadians(degrees)), 1e-14
+        ));
+      }
+    }
+    REQUIRE(matrices_almost_equal(camera_mount, cpp_math::calculateRotationMatrix(cpp_math::Axis::Y, cpp_math::degreesToRadians(-2.5)), 1e-16));
+  }
+
+  SECTION("Heli angles match rotateVector")
+  {
+    std::uniform_real_distribution<double> heli_angle(-180, 180);
+    for(int i = 0; i < 1000; ++i) {
+      auto angles = cpp_math::HeliAngles{heli_angle(generator), heli_angle(generator), heli_angle(generator)};
+      auto v = cpp_math::Vector3d{1, 2, 3};
+      INFO("Heli angles are " << angles);
+      REQUIRE(vectors_almost_equal(
+        cpp_math::multiplyMatrixByVector(cpp_math::makeRotation(angles), v), cpp_math::rotateVector(v, angles), 1e-12
+      ));
+    }
+  }
+
+  SECTION("Composes with runtime attitude")
+  {
+    auto attitude = cpp_math::HeliAttitude(cpp_math::HeliAngles{30, 10, 5});
+    auto v = cpp_math::Vector3d{1, 0.5, -0.25};
+    auto expected = attitude.apply(cpp_math::multiplyMatrixByVector(camera_mount, v));
+    REQUIRE(vectors_almost_equal(attitude.apply(CameraMount::apply(v)), expected, 1e-15));
+    auto runtime_rotation = cpp_math::makeRotation(cpp_math::HeliAngles{30, 10, 5});
+    REQUIRE(vectors_almost_equal(
+      cpp_math::multiplyMatrixByVector(CameraMount::then(runtime_rotation), v),
+      cpp_math::rotateVector(cpp_math::multiplyMatrixByVector(camera_mount, v), cpp_math::HeliAngles{30, 10, 5}),
+      1e-12
+    ));
+    REQUIRE(vectors_almost_equal(
+      cpp_math::multiplyMatrixByVector(lidar_mount, cpp_math::Vector3d{1, 0, 0}), cpp_math::Vector3d{-1, 0, 0}, 1e-15
+    ));
+  }
+}
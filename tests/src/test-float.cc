@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <type_traits>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  cpp_math::Vector3f toFloat(cpp_math::Vector3d const& v)
+  {
+    return {static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z)};
+  }
+
+  cpp_math::HeliAnglesf toFloat(cpp_math::HeliAngles const& angles)
+  {
+    return {static_cast<float>(angles.yaw), static_cast<float>(angles.pitch), static_cast<float>(angles.roll)};
+  }
+
+  double distance(cpp_math::Vector3f const& v1, cpp_math::Vector3d const& v2)
+  {
+    return std::sqrt(std::pow(v1.x - v2.x, 2) + std::pow(v1.y - v2.y, 2) + std::pow(v1.z - v2.z, 2));
+  }
+
+  /**
+   * @brief Near multiples of 90 degrees the rotated vector gets close to a rotation axis.
+   *        close_to_zero is relative to the precision, so float may choose another rotation order there
+   */
+  bool near_right_angle(double degrees)
+  {
+    return std::abs(std::remainder(degrees, 90.0)) < 0.01;
+  }
+}  // namespace
+
+TEST_CASE("Float scalar type")
+{
+  static_assert(sizeof(cpp_math::Vector3f) == 3 * sizeof(float), "Vector3f must stay packed");
+  static_assert(std::is_trivially_copyable<cpp_math::Mat3f>::value, "Mat3f must stay trivially copyable");
+  static_assert(std::is_same<decltype(cpp_math::identityMatrix()), cpp_math::Mat3>::value, "T defaults to double");
+
+  std::mt19937_64 generator(17);
+  std::uniform_real_distribution<double> angle(-180, 180);
+  std::uniform_real_distribution<double> coordinate(-1000, 1000);
+
+  SECTION("Matrices")
+  {
+    constexpr auto identity = cpp_math::identityMatrix<float>();
+    constexpr auto v = cpp_math::multiplyMatrixByVector(identity, cpp_math::Vector3f{1, 2, 3});
+    static_assert(v.x == 1 && v.y == 2 && v.z == 3, "");
+
+    for(int i = 0; i < 1000; ++i) {
+      auto degrees = angle(generator);
+      auto matrix = cpp_math::calculateRotationMatrix<float>(cpp_math::Axis::Z, cpp_math::degreesToRadians<float>(degrees));
+      auto expected = cpp_math::calculateRotationMatrix(cpp_math::Axis::Z, cpp_math::degreesToRadians(degrees));
+      for(size_t row = 0; row < 3; ++row) {
+        for(size_t col = 0; col < 3; ++col) {
+          REQUIRE(std::abs(matrix[row][col] - expected[row][col]) < 1e-6);
+        }
+      }
+    }
+  }
+
+  SECTION("rotateVector")
+  {
+    for(int i = 0; i < 10000; ++i) {
+      auto angles = cpp_math::HeliAngles{angle(generator), angle(generator) / 2, angle(generator)};
+      if(near_right_angle(angles.yaw) or near_right_angle(angles.pitch) or near_right_angle(angles.roll)) {
+        continue;
+      }
+      auto v = cpp_math::Vector3d{coordinate(generator), coordinate(generator), coordinate(generator)};
+      auto expected = cpp_math::rotateVector(v, angles);
+      auto result = cpp_math::rotateVector(toFloat(v), toFloat(angles));
+      INFO("Heli angles are " << angles);
+      INFO("Source vector is " << v);
+      REQUIRE(distance(result, expected) < 2e-3);
+    }
+  }
+
+  /**
+   * Max distance between float and double results for positions within 1 km, measured:
+   * distance 100 m    0.14 mm
+   * distance 1 km     1.2 mm
+   * distance 5 km     6 mm
+   * distance 20 km    23 mm
+   * It is dominated by rounding of angles and positions to float, so positions far from
+   * the origin (for example ECEF coordinates) lose much more
+   */
+  SECTION("calculatePointByDistanceAndAngles accuracy up to 20 km")
+  {
+    for(double point_distance : {100.0, 1000.0, 5000.0, 20000.0}) {
+      double max_error = 0;
+      for(int i = 0; i < 20000; ++i) {
+        auto angles = cpp_math::HeliAngles{angle(generator), angle(generator) / 2, angle(generator)};
+        auto camera_angles = cpp_math::CameraAngles{angle(generator), angle(generator) / 2};
+        if(near_right_angle(angles.yaw + camera_angles.yaw) or near_right_angle(angles.pitch + camera_angles.pitch)
+           or near_right_angle(angles.roll))
+        {
+          continue;
+        }
+        auto position = cpp_math::Vector3d{coordinate(generator), coordinate(generator), coordinate(generator) / 10};
+        auto expected = cpp_math::calculatePointByDistanceAndAngles(point_distance, position, angles, camera_angles);
+        auto result = cpp_math::calculatePointByDistanceAndAngles(
+          static_cast<float>(point_distance), toFloat(position), toFloat(angles),
+          cpp_math::CameraAnglesf{static_cast<float>(camera_angles.yaw), static_cast<float>(camera_angles.pitch)}
+        );
+        max_error = std::max(max_error, distance(result, expected));
+      }
+      INFO("Distance is " << point_distance << ", max error is " << max_error);
+      REQUIRE(max_error < point_distance * 2e-6 + 1e-3);
+    }
+  }
+}
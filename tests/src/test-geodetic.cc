@@ -0,0 +1,132 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/geodetic.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  double distance(cpp_math::Vector3d const& v1, cpp_math::Vector3d const& v2)
+  {
+    return std::sqrt(std::pow(v1.x - v2.x, 2) + std::pow(v1.y - v2.y, 2) + std::pow(v1.z - v2.z, 2));
+  }
+}  // namespace
+
+TEST_CASE("Geodetic conversions")
+{
+  std::mt19937_64 generator(21);
+  std::uniform_real_distribution<double> latitude(-90, 90);
+  std::uniform_real_distribution<double> longitude(-180, 180);
+  std::uniform_real_distribution<double> altitude(-10000, 1000000);
+
+  SECTION("Known points")
+  {
+    auto a = cpp_math::wgs84::semi_major_axis;
+    auto b = cpp_math::wgs84::semi_minor_axis;
+    REQUIRE(distance(cpp_math::geodeticToEcef({0, 0, 0}), {a, 0, 0}) < 1e-9);
+    REQUIRE(distance(cpp_math::geodeticToEcef({0, 90, 100}), {0, a + 100, 0}) < 1e-9);
+    REQUIRE(distance(cpp_math::geodeticToEcef({-90, 0, 0}), {0, 0, -b}) < 1e-8);
+
+    auto pole = cpp_math::ecefToGeodetic({0, 0, b + 10});
+    REQUIRE(pole.latitude == Approx(90));
+    REQUIRE(pole.altitude == Approx(10));
+  }
+
+  SECTION("ECEF round trip")
+  {
+    for(int i = 0; i < 100000; ++i) {
+      auto point = cpp_math::Geodetic{latitude(generator), longitude(generator), altitude(generator)};
+      auto result = cpp_math::ecefToGeodetic(cpp_math::geodeticToEcef(point));
+      INFO("Point is " << point << ", result is " << result);
+      REQUIRE(std::abs(result.latitude - point.latitude) < 1e-11);
+      REQUIRE(std::abs(std::remainder(result.longitude - point.longitude, 360.0)) * std::cos(point.latitude * M_PI / 180) < 1e-11);
+      REQUIRE(std::abs(result.altitude - point.altitude) < 1e-7);
+    }
+  }
+
+  SECTION("Local tangent frame")
+  {
+    auto origin = cpp_math::Geodetic{55.75, 37.62, 150};
+    auto frame = cpp_math::LocalTangentFrame(origin);
+    REQUIRE(distance(frame.geodeticToEnu(origin), {0, 0, 0}) < 1e-8);
+    REQUIRE(distance(frame.geodeticToEnu({55.75, 37.62, 250}), {0, 0, 100}) < 1e-8);
+
+    // The matrix is a rotation
+    auto m = frame.ecefToEnuMatrix();
+    auto product = cpp_math::multiplyMatrices(m, cpp_math::Mat3{{
+      {m[0][0], m[1][0], m[2][0]}, {m[0][1], m[1][1], m[2][1]}, {m[0][2], m[1][2], m[2][2]}
+    }});
+    for(size_t row = 0; row < 3; ++row) {
+      for(size_t col = 0; col < 3; ++col) {
+        REQUIRE(std::abs(product[row][col] - (row == col ? 1 : 0)) < 1e-15);
+      }
+    }
+
+    auto north = frame.geodeticToEnu({55.76, 37.62, 150});
+    REQUIRE(std::abs(north.x) < 1e-6);
+    REQUIRE(north.y == Approx(1113.5).epsilon(1e-3));
+    auto east = frame.geodeticToEnu({55.75, 37.63, 150});
+    REQUIRE(east.x > 600);
+    REQUIRE(std::abs(east.y) < 1);
+
+    for(int i = 0; i < 10000; ++i) {
+      auto enu = cpp_math::Vector3d{altitude(generator) / 10, altitude(generator) / 10, altitude(generator) / 100};
+      auto result = frame.geodeticToEnu(frame.enuToGeodetic(enu));
+      INFO("ENU point is " << enu);
+      REQUIRE(distance(result, enu) < 1e-7);
+    }
+  }
+
+  SECTION("ENU is the frame of calculatePointByDistanceAndAngles")
+  {
+    auto origin = cpp_math::Geodetic{10, 20, 0};
+    // Yaw 90 looks to the north
+    auto enu = cpp_math::calculatePointByDistanceAndAngles(1000, {0, 0, 0}, {90, 0, 0}, {0, 0});
+    auto point = cpp_math::enuToGeodetic(enu, origin);
+    REQUIRE(point.latitude > origin.latitude);
+    REQUIRE(point.longitude == Approx(20));
+    REQUIRE(distance(cpp_math::geodeticToEnu(point, origin), enu) < 1e-7);
+  }
+
+  SECTION("Batch gives the same results as single points")
+  {
+    constexpr size_t count = 1000;
+    auto frame = cpp_math::LocalTangentFrame({-33.9, 151.2, 20});
+    std::vector<double> lat, lon, alt, x(count), y(count), z(count), lat2(count), lon2(count), alt2(count);
+    for(size_t i = 0; i < count; ++i) {
+      lat.push_back(-33.9 + latitude(generator) / 900);
+      lon.push_back(151.2 + longitude(generator) / 1800);
+      alt.push_back(altitude(generator) / 100);
+    }
+
+    cpp_math::geodeticToEcef(count, {lat.data(), lon.data(), alt.data()}, {x.data(), y.data(), z.data()});
+    for(size_t i = 0; i < count; ++i) {
+      REQUIRE(distance({x[i], y[i], z[i]}, cpp_math::geodeticToEcef({lat[i], lon[i], alt[i]})) < 1e-8);
+    }
+
+    frame.geodeticToEnu(count, {lat.data(), lon.data(), alt.data()}, {x.data(), y.data(), z.data()});
+    for(size_t i = 0; i < count; ++i) {
+      REQUIRE(distance({x[i], y[i], z[i]}, frame.geodeticToEnu({lat[i], lon[i], alt[i]})) < 1e-8);
+    }
+
+    frame.enuToGeodetic(count, {x.data(), y.data(), z.data()}, {lat2.data(), lon2.data(), alt2.data()});
+    for(size_t i = 0; i < count; ++i) {
+      REQUIRE(std::abs(lat2[i] - lat[i]) < 1e-11);
+      REQUIRE(std::abs(lon2[i] - lon[i]) < 1e-11);
+      REQUIRE(std::abs(alt2[i] - alt[i]) < 1e-7);
+    }
+
+    // In place ENU to ECEF and back
+    std::vector<double> ex = x, ey = y, ez = z;
+    frame.enuToEcef(count, {x.data(), y.data(), z.data()}, {x.data(), y.data(), z.data()});
+    frame.ecefToEnu(count, {x.data(), y.data(), z.data()}, {x.data(), y.data(), z.data()});
+    for(size_t i = 0; i < count; ++i) {
+      REQUIRE(distance({x[i], y[i], z[i]}, {ex[i], ey[i], ez[i]}) < 1e-8);
+    }
+  }
+}
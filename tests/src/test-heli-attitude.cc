@@ -0,0 +1,105 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/heli_attitude.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  bool vectors_almost_equal(
+    cpp_math::Vector3d const& v1,
+    cpp_math::Vector3d const& v2,
+    double epsilon
+  )
+  {
+    return std::abs(v1.x - v2.x) < epsilon && std::abs(v1.y - v2.y) < epsilon
+        && std::abs(v1.z - v2.z) < epsilon;
+  }
+}  // namespace
+
+TEST_CASE("HeliAttitude matches rotateVector")
+{
+  SECTION("Axis vectors and angles which force different rotation orders")
+  {
+    auto vectors = {
+      cpp_math::Vector3d{1, 0, 0},
+      cpp_math::Vector3d{0, 1, 0},
+      cpp_math::Vector3d{0, 0, 1},
+      cpp_math::Vector3d{1, 0, 1},
+      cpp_math::Vector3d{-1, 2, 0.5},
+    };
+    auto values = {0.0, 45.0, 90.0, -90.0, 180.0, 30.0, 720.0};
+    for(auto yaw : values) {
+      for(auto pitch : values) {
+        for(auto roll : values) {
+          auto angles = cpp_math::HeliAngles{yaw, pitch, roll};
+          auto attitude = cpp_math::HeliAttitude(angles);
+          for(auto const& v : vectors) {
+            auto expected = cpp_math::rotateVector(v, angles);
+            auto result = attitude.apply(v);
+            INFO("Heli angles are " << angles);
+            INFO("Source vector is " << v);
+            INFO("Vector expected is " << expected);
+            INFO("Vector after rotation is " << result);
+            REQUIRE(vectors_almost_equal(result, expected, 1e-12));
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("Random angles and vectors")
+  {
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> angle(-400, 400);
+    std::uniform_real_distribution<double> coordinate(-10, 10);
+    for(int i = 0; i < 1000; ++i) {
+      auto angles = cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)};
+      auto v = cpp_math::Vector3d{coordinate(generator), coordinate(generator), coordinate(generator)};
+      auto expected = cpp_math::rotateVector(v, angles);
+      auto result = cpp_math::HeliAttitude(angles).apply(v);
+      INFO("Heli angles are " << angles);
+      INFO("Source vector is " << v);
+      REQUIRE(vectors_almost_equal(result, expected, 1e-12));
+    }
+  }
+
+  SECTION("Direction and matrix agree with calculatePointByDistanceAndAngles")
+  {
+    auto angles = cpp_math::HeliAngles{30, -20, 60};
+    auto camera_angles = cpp_math::CameraAngles{10, 15};
+    auto attitude = cpp_math::HeliAttitude(angles, camera_angles);
+    auto initial_position = cpp_math::Vector3d{100, -50, 20};
+    auto expected = cpp_math::calculatePointByDistanceAndAngles(250, initial_position, angles, camera_angles);
+    REQUIRE(vectors_almost_equal(attitude.calculatePoint(250, initial_position), expected, 1e-9));
+    auto direction = cpp_math::multiplyMatrixByVector(attitude.matrix(), cpp_math::Vector3d{1, 0, 0});
+    REQUIRE(vectors_almost_equal(direction, attitude.direction(), 1e-15));
+  }
+
+  SECTION("directionMatrix is the matrix of HeliAttitude")
+  {
+    std::mt19937_64 generator(22);
+    std::uniform_real_distribution<double> angle(-400, 400);
+    std::vector<cpp_math::HeliAngles> all_angles{{0, 0, 0}, {0, 0, 30}, {90, 0, 45}, {0, 90, 10}, {30, 5, 10}};
+    for(int i = 0; i < 1000; ++i) {
+      all_angles.push_back({angle(generator), angle(generator), angle(generator)});
+    }
+    for(auto const& angles : all_angles) {
+      INFO("Heli angles are " << angles);
+      for(auto policy : {cpp_math::TrigPolicy::Standard, cpp_math::TrigPolicy::Ulp1}) {
+        auto expected = cpp_math::HeliAttitude(angles, policy).matrix();
+        auto result = cpp_math::HeliAttitude::directionMatrix(angles, policy);
+        for(size_t row = 0; row < 3; ++row) {
+          for(size_t column = 0; column < 3; ++column) {
+            REQUIRE(result[row][column] == expected[row][column]);
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/batch.h>
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/instrumentation.h>
+
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  uint64_t sum(std::array<uint64_t, cpp_math::latency_buckets_count> const& buckets)
+  {
+    return std::accumulate(buckets.begin(), buckets.end(), uint64_t(0));
+  }
+}  // namespace
+
+TEST_CASE("Instrumentation")
+{
+  using cpp_math::InstrumentedFunction;
+
+  cpp_math::resetInstrumentation();
+  // X axis can not be rotated by roll, both orders starting with roll fail and yaw, roll, pitch is applied
+  cpp_math::rotateVector(cpp_math::Vector3d{1, 0, 0}, cpp_math::HeliAngles{30, 0, 10});
+  // Nothing can rotate a zero vector, the input comes back
+  cpp_math::rotateVector(cpp_math::Vector3d{0, 0, 0}, cpp_math::HeliAngles{30, 20, 10});
+  cpp_math::rotateVector(cpp_math::Vector3f{1, 2, 3}, cpp_math::HeliAnglesf{0, 0, 0});
+  cpp_math::calculatePointByDistanceAndAngles(100, {0, 0, 0}, {10, 20, 0}, {5, 5});
+  std::thread([]() { cpp_math::rotateVector(cpp_math::Vector3d{1, 0, 0}, cpp_math::HeliAngles{30, 20, 10}); }).join();
+
+  std::vector<double> values(10, 1.0);
+  auto* v = values.data();
+  cpp_math::calculatePointsByDistanceAndAngles(10, v, {v, v, v}, {v, v, v}, {v, v}, {v, v, v}, cpp_math::BatchMode::Strict);
+
+  auto snapshot = cpp_math::instrumentationSnapshot();
+  REQUIRE(snapshot.enabled == cpp_math::instrumentationEnabled());
+
+  if(not snapshot.enabled) {
+    REQUIRE(snapshot.threads == 0);
+    REQUIRE(snapshot[InstrumentedFunction::RotateVector].calls == 0);
+    REQUIRE(snapshot.fallbacks == 0);
+  }
+  else {
+    // Strict batch of 10 points calls calculatePointByDistanceAndAngles for every point
+    REQUIRE(snapshot[InstrumentedFunction::RotateVector].calls == 5 + 10);
+    REQUIRE(snapshot[InstrumentedFunction::CalculatePointByDistanceAndAngles].calls == 1 + 10);
+    REQUIRE(snapshot[InstrumentedFunction::CalculatePointsByDistanceAndAngles].calls == 1);
+    for(auto const& function : snapshot.functions) {
+      REQUIRE(sum(function.latency_ns) == function.calls);
+    }
+    REQUIRE(snapshot.zero_angles == 1);
+    REQUIRE(snapshot.fallbacks == 1);
+    REQUIRE(snapshot.rotation_orders[2] >= 1);
+    auto applied = std::accumulate(snapshot.rotation_orders.begin(), snapshot.rotation_orders.end(), uint64_t(0));
+    REQUIRE(applied == 5 + 10 - 2);
+    REQUIRE(snapshot.orders_tried > applied);
+    // The thread has exited, its counters stay in the snapshot
+    REQUIRE(snapshot.threads >= 2);
+
+    cpp_math::resetInstrumentation();
+    auto reset = cpp_math::instrumentationSnapshot();
+    REQUIRE(reset[InstrumentedFunction::RotateVector].calls == 0);
+    REQUIRE(reset.fallbacks == 0);
+  }
+
+  std::ostringstream json;
+  cpp_math::writeInstrumentationJson(snapshot, json);
+  auto text = json.str();
+  REQUIRE(text.find("\"enabled\": " + std::string(snapshot.enabled ? "true" : "false")) != std::string::npos);
+  REQUIRE(text.find("\"fallbacks\": " + std::to_string(snapshot.fallbacks)) != std::string::npos);
+  REQUIRE(text.find("{\"order\": \"yaw, roll, pitch\", \"applied\": " + std::to_string(snapshot.rotation_orders[2])) != std::string::npos);
+  REQUIRE(text.find("\"rotateVector\": {\"calls\": " + std::to_string(snapshot[InstrumentedFunction::RotateVector].calls)) != std::string::npos);
+}
@@ -0,0 +1,256 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/executor.h>
+#include <cpp-math/fixed_rotation.h>
+#include <cpp-math/lidar_scan.h>
+#include <cpp-math/quaternion.h>
+#include <cpp-math/sensor_rig.h>
+#include <cpp-math/vector_expression.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+  bool vectorsAlmostEqual(cpp_math::Vector3d const& v1, cpp_math::Vector3d const& v2, double epsilon)
+  {
+    return std::abs(v1.x - v2.x) < epsilon && std::abs(v1.y - v2.y) < epsilon && std::abs(v1.z - v2.z) < epsilon;
+  }
+
+  struct Cloud
+  {
+    std::vector<double> x, y, z;
+
+    explicit Cloud(size_t size) : x(size), y(size), z(size) {}
+
+    cpp_math::Vector3d operator[](size_t i) const { return {x[i], y[i], z[i]}; }
+
+    cpp_math::Vector3dArrays arrays() { return {x.data(), y.data(), z.data()}; }
+  };
+
+  struct Sweep
+  {
+    std::vector<uint32_t> beams;
+    std::vector<double> ranges, timestamps;
+  };
+
+  /// @brief Heli flying along X and turning while the sweep is taken, 10 poses over 0.1 s
+  cpp_math::PoseTrack makeTrack()
+  {
+    cpp_math::PoseTrack track;
+    for(size_t i = 0; i <= 10; ++i) {
+      auto t = 0.01 * static_cast<double>(i);
+      track.push(t, {50 * t, 2 * t, 300 - t}, {170 + 100 * t, 5 * std::sin(30 * t), -3 + 20 * t});
+    }
+    return track;
+  }
+
+  Sweep makeSweep(size_t count, size_t beams_count, bool sorted)
+  {
+    std::mt19937_64 generator(25);
+    std::uniform_int_distribution<uint32_t> beam(0, static_cast<uint32_t>(beams_count - 1));
+    std::uniform_real_distribution<double> range(1, 200);
+    std::uniform_real_distribution<double> time(0, 0.1);
+    Sweep sweep;
+    for(size_t i = 0; i < count; ++i) {
+      sweep.beams.push_back(beam(generator));
+      sweep.ranges.push_back(range(generator));
+      sweep.timestamps.push_back(time(generator));
+    }
+    if(sorted) {
+      std::sort(sweep.timestamps.begin(), sweep.timestamps.end());
+    }
+    return sweep;
+  }
+}  // namespace
+
+TEST_CASE("PoseTrack")
+{
+  cpp_math::PoseTrack track;
+  cpp_math::Pose pose{};
+  REQUIRE_FALSE(track.poseAt(0, pose));
+
+  track.push(1, {0, 0, 0}, {10, 0, 0});
+  REQUIRE(track.poseAt(1, pose));
+  REQUIRE_FALSE(track.poseAt(1.5, pose));
+  REQUIRE_THROWS_AS(track.push(1, {0, 0, 0}, {0, 0, 0}), std::runtime_error);
+
+  // The same attitude with the opposite sign, interpolation still stays on it
+  auto q = cpp_math::quaternionFromHeliAngles({30, 0, 0});
+  track.push(2, cpp_math::Pose{{10, 20, 30}, q});
+  track.push(3, cpp_math::Pose{{20, 20, 30}, {-q.w, -q.x, -q.y, -q.z}});
+  REQUIRE(track.attitudes().w[2] == Approx(q.w));
+
+  REQUIRE(track.poseAt(1.5, pose));
+  REQUIRE(vectorsAlmostEqual(pose.position, {5, 10, 15}, 1e-12));
+  REQUIRE(cpp_math::rollPitchYawFromQuaternion(pose.attitude).yaw == Approx(20));
+
+  REQUIRE(track.poseAt(2.5, pose));
+  REQUIRE(vectorsAlmostEqual(pose.position, {15, 20, 30}, 1e-12));
+  REQUIRE(cpp_math::rollPitchYawFromQuaternion(pose.attitude).yaw == Approx(30));
+  REQUIRE(track.poseAt(3, pose));
+  REQUIRE_FALSE(track.poseAt(3.5, pose));
+  REQUIRE_FALSE(track.poseAt(std::nan(""), pose));
+
+  track.clear();
+  REQUIRE(track.size() == 0);
+}
+
+TEST_CASE("LidarScanPattern")
+{
+  SECTION("Beams")
+  {
+    cpp_math::SensorMount identity{cpp_math::identityMatrix(), {0, 0, 0}};
+    auto pattern = cpp_math::LidarScanPattern::spinning({-15, 0, 15}, 4, identity);
+    REQUIRE(pattern.size() == 12);
+    // Azimuth 1 of 4 looks along Y, laser 2 looks down
+    REQUIRE(vectorsAlmostEqual(pattern.beam(1 * 3 + 1), {0, 1, 0}, 1e-15));
+    REQUIRE(vectorsAlmostEqual(pattern.beam(0 * 3 + 2), {std::cos(M_PI / 12), 0, -std::sin(M_PI / 12)}, 1e-15));
+    for(size_t i = 0; i < pattern.size(); ++i) {
+      auto beam = pattern.beam(i);
+      REQUIRE(std::sqrt(beam.x * beam.x + beam.y * beam.y + beam.z * beam.z) == Approx(1));
+    }
+
+    // Mount rotation turns every beam into the heli frame
+    cpp_math::SensorMount turned{cpp_math::makeRotation(cpp_math::Axis::Z, 90.0), {1, 0, 0}};
+    auto mounted = cpp_math::LidarScanPattern({{0, 0}, {90, 0}}, turned);
+    REQUIRE(vectorsAlmostEqual(mounted.beam(0), {0, 1, 0}, 1e-15));
+    REQUIRE(vectorsAlmostEqual(mounted.beam(1), {-1, 0, 0}, 1e-15));
+  }
+
+  cpp_math::SensorMount mount{cpp_math::makeRotation(cpp_math::Axis::Y, 20.0), {0.3, -0.1, -0.8}};
+  auto pattern = cpp_math::LidarScanPattern::spinning({-15, -10, -5, 0, 5, 10, 15, 20}, 360, mount);
+  auto track = makeTrack();
+
+  SECTION("Every point uses the pose at its own time")
+  {
+    for(bool sorted : {true, false}) {
+      auto sweep = makeSweep(5000, pattern.size(), sorted);
+      Cloud cloud(sweep.beams.size());
+      auto projected = pattern.projectSweep(
+        track, sweep.beams.size(), sweep.beams.data(), sweep.ranges.data(), sweep.timestamps.data(), cloud.arrays()
+      );
+      REQUIRE(projected == sweep.beams.size());
+      for(size_t i = 0; i < sweep.beams.size(); ++i) {
+        cpp_math::Pose pose{};
+        REQUIRE(track.poseAt(sweep.timestamps[i], pose));
+        auto local = mount.lever_arm + sweep.ranges[i] * pattern.beam(sweep.beams[i]);
+        auto expected = pose.position + cpp_math::rotateVector(local, pose.attitude);
+        REQUIRE(vectorsAlmostEqual(cloud[i], expected, 1e-10));
+      }
+    }
+  }
+
+  SECTION("Constant pose is the same as one pose per sweep")
+  {
+    // With heli pitch and roll zero camera angles are simply added to heli angles, see SensorRig
+    cpp_math::PoseTrack still;
+    cpp_math::Vector3d const position{100, -200, 1500};
+    still.push(0, position, {40, 0, 0});
+    still.push(1, position, {40, 0, 0});
+    std::vector<cpp_math::CameraAngles> beam_angles{{10, 30}, {-60, 5}, {170, -20}};
+    auto beams = cpp_math::LidarScanPattern(beam_angles, {cpp_math::identityMatrix(), {0, 0, 0}});
+    std::vector<uint32_t> indices{0, 1, 2};
+    std::vector<double> ranges{100, 200, 300}, timestamps{0, 0.5, 1};
+    Cloud cloud(3);
+    REQUIRE(beams.projectSweep(still, 3, indices.data(), ranges.data(), timestamps.data(), cloud.arrays()) == 3);
+    for(size_t i = 0; i < 3; ++i) {
+      auto expected = cpp_math::calculatePointByDistanceAndAngles(ranges[i], position, {40, 0, 0}, beam_angles[i]);
+      REQUIRE(vectorsAlmostEqual(cloud[i], expected, 1e-9));
+    }
+  }
+
+  SECTION("Constant pose with roll is the same as SensorRig")
+  {
+    cpp_math::HeliAngles const angles{30, 5, 10};
+    cpp_math::Vector3d const position{100, -200, 1500};
+    cpp_math::PoseTrack still;
+    still.push(0, position, angles);
+    still.push(1, position, angles);
+    std::vector<cpp_math::CameraAngles> beam_angles{{0, 0}, {20, 10}, {-70, 40}, {150, -15}};
+    for(auto const& beam_mount : {cpp_math::SensorMount{cpp_math::identityMatrix(), {0, 0, 0}}, mount}) {
+      auto beams = cpp_math::LidarScanPattern(beam_angles, beam_mount);
+      cpp_math::SensorRig rig(std::vector<cpp_math::SensorMount>(beam_angles.size(), beam_mount));
+      std::vector<uint32_t> indices{0, 1, 2, 3};
+      std::vector<double> ranges{100, 100, 250, 40}, timestamps{0, 0.25, 0.5, 1};
+      std::vector<double> yaw, pitch;
+      for(auto const& beam : beam_angles) {
+        yaw.push_back(beam.yaw);
+        pitch.push_back(beam.pitch);
+      }
+      Cloud cloud(4), expected(4);
+      REQUIRE(beams.projectSweep(still, 4, indices.data(), ranges.data(), timestamps.data(), cloud.arrays()) == 4);
+      rig.calculatePoints(position, angles, {yaw.data(), pitch.data()}, ranges.data(), expected.arrays());
+      for(size_t i = 0; i < 4; ++i) {
+        INFO("Beam " << i);
+        REQUIRE(vectorsAlmostEqual(cloud[i], expected[i], 1e-9));
+      }
+    }
+    // Identity mount
+    auto beams = cpp_math::LidarScanPattern(beam_angles, {cpp_math::identityMatrix(), {0, 0, 0}});
+    std::vector<uint32_t> indices{0, 1};
+    std::vector<double> ranges{100, 100}, timestamps{0, 1};
+    Cloud cloud(2);
+    beams.projectSweep(still, 2, indices.data(), ranges.data(), timestamps.data(), cloud.arrays());
+    REQUIRE(vectorsAlmostEqual(cloud[0] - position, {87.03, 49.24, 1.10}, 0.01));
+    REQUIRE(vectorsAlmostEqual(cloud[1] - position, {62.71, 77.31, -9.50}, 0.01));
+    // The beam straight ahead is the heli direction
+    auto ahead = cpp_math::calculatePointByDistanceAndAngles(100, position, angles, {0, 0});
+    cpp_math::Pose pose{};
+    REQUIRE(still.poseAt(0.5, pose));
+    REQUIRE(vectorsAlmostEqual(position + cpp_math::rotateVector(cpp_math::Vector3d{100, 0, 0}, pose.attitude), ahead, 1e-9));
+  }
+
+  SECTION("Points outside of the track are NaN")
+  {
+    auto sweep = makeSweep(1000, pattern.size(), true);
+    sweep.timestamps[0] = -1;
+    sweep.timestamps[500] = std::nan("");
+    sweep.timestamps[999] = 0.2;
+    Cloud cloud(sweep.beams.size());
+    auto projected = pattern.projectSweep(
+      track, sweep.beams.size(), sweep.beams.data(), sweep.ranges.data(), sweep.timestamps.data(), cloud.arrays()
+    );
+    REQUIRE(projected == sweep.beams.size() - 3);
+    for(size_t i : {0, 500, 999}) {
+      REQUIRE(std::isnan(cloud.x[i]));
+      REQUIRE(std::isnan(cloud.y[i]));
+      REQUIRE(std::isnan(cloud.z[i]));
+    }
+    REQUIRE_FALSE(std::isnan(cloud.x[1]));
+
+    cpp_math::PoseTrack empty;
+    REQUIRE(pattern.projectSweep(empty, 10, sweep.beams.data(), sweep.ranges.data(), sweep.timestamps.data(), cloud.arrays()) == 0);
+    REQUIRE(std::isnan(cloud.x[9]));
+  }
+
+  SECTION("Threads and chunks give the same bits")
+  {
+    auto sweep = makeSweep(20000, pattern.size(), true);
+    Cloud sequential(sweep.beams.size()), parallel(sweep.beams.size());
+    pattern.projectSweep(track, sweep.beams.size(), sweep.beams.data(), sweep.ranges.data(), sweep.timestamps.data(), sequential.arrays());
+    cpp_math::ThreadPoolExecutor executor(4);
+    auto projected = pattern.projectSweep(
+      track, sweep.beams.size(), sweep.beams.data(), sweep.ranges.data(), sweep.timestamps.data(), parallel.arrays(), executor, 1000
+    );
+    REQUIRE(projected == sweep.beams.size());
+    REQUIRE(sequential.x == parallel.x);
+    REQUIRE(sequential.y == parallel.y);
+    REQUIRE(sequential.z == parallel.z);
+  }
+
+  SECTION("Beam out of the pattern")
+  {
+    std::vector<uint32_t> indices{0, static_cast<uint32_t>(pattern.size())};
+    std::vector<double> ranges{10, 10}, timestamps{0.05, 0.05};
+    Cloud cloud(2);
+    REQUIRE_THROWS_AS(
+      pattern.projectSweep(track, 2, indices.data(), ranges.data(), timestamps.data(), cloud.arrays()), std::runtime_error
+    );
+    REQUIRE(cloud.x[0] == 0);
+  }
+}
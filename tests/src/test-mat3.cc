@@ -0,0 +1,77 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+
+#include <cmath>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  bool matrices_almost_equal(
+    cpp_math::Mat3 const& m1,
+    cpp_math::Mat3 const& m2,
+    double epsilon
+  )
+  {
+    for(size_t row = 0; row < 3; ++row) {
+      for(size_t col = 0; col < 3; ++col) {
+        if(std::abs(m1[row][col] - m2[row][col]) > epsilon) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}  // namespace
+
+TEST_CASE("Mat3")
+{
+  SECTION("Is usable in constant expressions")
+  {
+    constexpr auto swap_xy = cpp_math::Mat3{{{0, 1, 0}, {1, 0, 0}, {0, 0, 1}}};
+    constexpr auto result = cpp_math::multiplyMatrixByVector(swap_xy, cpp_math::Vector3d{1, 2, 3});
+    static_assert(result.x == 2 && result.y == 1 && result.z == 3, "constexpr multiply");
+    constexpr auto squared = cpp_math::multiplyMatrices(swap_xy, swap_xy);
+    static_assert(squared[0][0] == 1 && squared[0][1] == 0, "constexpr multiplyMatrices");
+    static_assert(cpp_math::transposeMatrix(swap_xy)[1][0] == 1, "constexpr transpose");
+    REQUIRE(matrices_almost_equal(squared, cpp_math::identityMatrix(), 0));
+  }
+
+  SECTION("Transpose inverts rotation")
+  {
+    auto rotation = cpp_math::calculateRotationMatrix(cpp_math::Axis::Y, 0.7);
+    auto result = cpp_math::multiplyMatrices(rotation, cpp_math::transposeMatrix(rotation));
+    INFO("Result is\n" << result);
+    REQUIRE(matrices_almost_equal(result, cpp_math::identityMatrix(), 1e-15));
+  }
+
+  SECTION("Compose applies first rotation first")
+  {
+    auto yaw = cpp_math::calculateRotationMatrix(cpp_math::Axis::Z, M_PI / 2);
+    auto pitch = cpp_math::calculateRotationMatrix(cpp_math::Axis::Y, -M_PI / 2);
+    auto composed = cpp_math::composeRotations(yaw, pitch);
+    auto v = cpp_math::Vector3d{1, 0, 0};
+    auto expected = cpp_math::multiplyMatrixByVector(pitch, cpp_math::multiplyMatrixByVector(yaw, v));
+    auto result = cpp_math::multiplyMatrixByVector(composed, v);
+    INFO("Vector expected is " << expected);
+    INFO("Vector after rotation is " << result);
+    REQUIRE(std::abs(result.x - expected.x) < 1e-15);
+    REQUIRE(std::abs(result.y - expected.y) < 1e-15);
+    REQUIRE(std::abs(result.z - expected.z) < 1e-15);
+  }
+
+  SECTION("Matrix3d compatibility")
+  {
+    cpp_math::Matrix3d legacy = cpp_math::calculateRotationMatrix(cpp_math::Axis::Z, 0.3);
+    REQUIRE(legacy.size() == 3);
+    auto fixed = cpp_math::toMat3(legacy);
+    REQUIRE(matrices_almost_equal(fixed, cpp_math::calculateRotationMatrix(cpp_math::Axis::Z, 0.3), 0));
+
+    auto legacy_product = cpp_math::multiplyMatrices(legacy, legacy);
+    auto fixed_product = cpp_math::multiplyMatrices(fixed, fixed);
+    REQUIRE(matrices_almost_equal(cpp_math::toMat3(legacy_product), fixed_product, 1e-15));
+
+    REQUIRE_THROWS(cpp_math::toMat3(cpp_math::Matrix3d{{1, 0}, {0, 1}}));
+  }
+}
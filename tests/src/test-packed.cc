@@ -0,0 +1,260 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/packed.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+  struct Poses
+  {
+    std::vector<double> x, y, z, yaw, pitch, roll, camera_yaw, camera_pitch;
+
+    explicit Poses(size_t count = 0) :
+      x(count),
+      y(count),
+      z(count),
+      yaw(count),
+      pitch(count),
+      roll(count),
+      camera_yaw(count),
+      camera_pitch(count)
+    {}
+
+    size_t size() const { return x.size(); }
+
+    void add(cpp_math::Vector3d const& position, cpp_math::HeliAngles const& angles, cpp_math::CameraAngles const& camera)
+    {
+      x.push_back(position.x);
+      y.push_back(position.y);
+      z.push_back(position.z);
+      yaw.push_back(angles.yaw);
+      pitch.push_back(angles.pitch);
+      roll.push_back(angles.roll);
+      camera_yaw.push_back(camera.yaw);
+      camera_pitch.push_back(camera.pitch);
+    }
+
+    void pack(std::vector<uint8_t>& buffer, cpp_math::PackingOptions const& options) const
+    {
+      cpp_math::packPoses(
+        size(),
+        {x.data(), y.data(), z.data()},
+        {yaw.data(), pitch.data(), roll.data()},
+        {camera_yaw.data(), camera_pitch.data()},
+        buffer,
+        options
+      );
+    }
+
+    size_t unpack(uint8_t const* data, size_t size)
+    {
+      return cpp_math::unpackPoses(
+        data,
+        size,
+        {x.data(), y.data(), z.data()},
+        {yaw.data(), pitch.data(), roll.data()},
+        {camera_yaw.data(), camera_pitch.data()}
+      );
+    }
+  };
+
+  /// @brief Heli at 200 Hz flying at 50 m/s with attitude and camera slowly turning
+  Poses flight(size_t count)
+  {
+    std::mt19937_64 generator(9);
+    std::normal_distribution<double> noise(0, 1);
+    Poses poses;
+    for(size_t i = 0; i < count; ++i) {
+      auto t = static_cast<double>(i) / 200;
+      poses.add(
+        {500000 + 50 * t, 6000000 + 5 * std::sin(t), 1500 + 0.01 * noise(generator)},
+        {30 + 2 * std::sin(t / 10), 3 * std::sin(t), 5 * std::cos(t)},
+        {40 * std::sin(t / 3), -60 + 20 * std::cos(t / 3)}
+      );
+    }
+    return poses;
+  }
+
+  /// @return Difference of two angles in degrees, wrapped into [-180, 180]
+  double angleDifference(double a, double b)
+  {
+    auto difference = a - b;
+    return difference - 360 * std::floor(difference / 360 + 0.5);
+  }
+
+  void requireClose(Poses const& decoded, Poses const& original, double angle_error, double position_error)
+  {
+    REQUIRE(decoded.size() == original.size());
+    for(size_t i = 0; i < original.size(); ++i) {
+      REQUIRE(std::abs(decoded.x[i] - original.x[i]) <= position_error);
+      REQUIRE(std::abs(decoded.y[i] - original.y[i]) <= position_error);
+      REQUIRE(std::abs(decoded.z[i] - original.z[i]) <= position_error);
+      REQUIRE(std::abs(angleDifference(decoded.yaw[i], original.yaw[i])) <= angle_error);
+      REQUIRE(std::abs(angleDifference(decoded.pitch[i], original.pitch[i])) <= angle_error);
+      REQUIRE(std::abs(angleDifference(decoded.roll[i], original.roll[i])) <= angle_error);
+      REQUIRE(std::abs(angleDifference(decoded.camera_yaw[i], original.camera_yaw[i])) <= angle_error);
+      REQUIRE(std::abs(angleDifference(decoded.camera_pitch[i], original.camera_pitch[i])) <= angle_error);
+      REQUIRE(std::abs(decoded.yaw[i]) <= 180);
+    }
+  }
+
+  constexpr size_t raw_pose_size = 8 * sizeof(double);
+}  // namespace
+
+TEST_CASE("Packed poses")
+{
+  auto original = flight(2000);
+
+  SECTION("MicroDegrees")
+  {
+    std::vector<uint8_t> buffer;
+    original.pack(buffer, cpp_math::PackingOptions());
+    INFO("bytes per pose " << static_cast<double>(buffer.size()) / original.size());
+    REQUIRE(buffer.size() * 2.4 < original.size() * raw_pose_size);
+
+    auto decoded = Poses(original.size());
+    REQUIRE(decoded.unpack(buffer.data(), buffer.size()) == buffer.size());
+    requireClose(decoded, original, 5e-7 + 1e-12, 5e-4 + 1e-9);
+
+    // Same point within the documented 0.2 mm at 20 km
+    for(size_t i = 0; i < original.size(); ++i) {
+      auto point = [](Poses const& poses, size_t i) {
+        return cpp_math::calculatePointByDistanceAndAngles(
+          20000,
+          {poses.x[i], poses.y[i], poses.z[i]},
+          {poses.yaw[i], poses.pitch[i], poses.roll[i]},
+          {poses.camera_yaw[i], poses.camera_pitch[i]}
+        );
+      };
+      auto expected = point(original, i);
+      auto result = point(decoded, i);
+      auto error = std::hypot(result.x - expected.x, result.y - expected.y, result.z - expected.z);
+      REQUIRE(error < 0.0005 + 1e-3);
+    }
+  }
+
+  SECTION("CentiDegrees")
+  {
+    std::vector<uint8_t> buffer;
+    auto options = cpp_math::PackingOptions();
+    options.angle_precision = cpp_math::AnglePrecision::CentiDegrees;
+    original.pack(buffer, options);
+    INFO("bytes per pose " << static_cast<double>(buffer.size()) / original.size());
+    REQUIRE(buffer.size() * 3.9 < original.size() * raw_pose_size);
+
+    auto decoded = Poses(original.size());
+    REQUIRE(decoded.unpack(buffer.data(), buffer.size()) == buffer.size());
+    requireClose(decoded, original, 0.005 + 1e-12, 5e-4 + 1e-9);
+  }
+
+  SECTION("Angles are wrapped, large jumps and coarse resolution")
+  {
+    std::mt19937_64 generator(4);
+    std::uniform_real_distribution<double> angle(-1e5, 1e5);
+    std::uniform_real_distribution<double> coordinate(-7e6, 7e6);
+    Poses poses;
+    for(auto special : {180.0, -180.0, 179.9999999, -179.9999999, 360.0, 540.0, 0.0}) {
+      poses.add({0, 0, 0}, {special, -special, special}, {special, special});
+    }
+    for(size_t i = 0; i < 1000; ++i) {
+      poses.add(
+        {coordinate(generator), coordinate(generator), coordinate(generator)},
+        {angle(generator), angle(generator), angle(generator)},
+        {angle(generator), angle(generator)}
+      );
+    }
+    auto options = cpp_math::PackingOptions();
+    options.position_resolution = 0.25;
+    std::vector<uint8_t> buffer;
+    poses.pack(buffer, options);
+    auto decoded = Poses(poses.size());
+    decoded.unpack(buffer.data(), buffer.size());
+    // Wrapping 1e5 degrees loses about 1e-11 degree
+    requireClose(decoded, poses, 5e-7 + 1e-10, 0.125 + 1e-9);
+  }
+}
+
+TEST_CASE("Packed points")
+{
+  // Sweep of a scanner over the ground, neighbouring points are a few meters apart
+  std::vector<double> x, y, z;
+  for(size_t i = 0; i < 5000; ++i) {
+    auto angle = static_cast<double>(i) * 0.01;
+    x.push_back(400000 + 300 * std::cos(angle) + 0.01 * static_cast<double>(i));
+    y.push_back(5500000 + 300 * std::sin(angle));
+    z.push_back(120 + 3 * std::sin(angle * 7));
+  }
+  std::vector<uint8_t> buffer;
+  cpp_math::packPoints(x.size(), {x.data(), y.data(), z.data()}, buffer);
+  INFO("bytes per point " << static_cast<double>(buffer.size()) / x.size());
+  REQUIRE(buffer.size() * 3 < x.size() * 3 * sizeof(double));
+
+  std::vector<double> decoded_x(x.size()), decoded_y(x.size()), decoded_z(x.size());
+  REQUIRE(cpp_math::unpackPoints(buffer.data(), buffer.size(), {decoded_x.data(), decoded_y.data(), decoded_z.data()}) == buffer.size());
+  for(size_t i = 0; i < x.size(); ++i) {
+    REQUIRE(std::abs(decoded_x[i] - x[i]) <= 5e-4 + 1e-9);
+    REQUIRE(std::abs(decoded_y[i] - y[i]) <= 5e-4 + 1e-9);
+    REQUIRE(std::abs(decoded_z[i] - z[i]) <= 5e-4 + 1e-9);
+  }
+}
+
+TEST_CASE("Packed blocks")
+{
+  auto poses = flight(300);
+  std::vector<uint8_t> buffer;
+  poses.pack(buffer, cpp_math::PackingOptions());
+  auto first_size = buffer.size();
+
+  SECTION("Blocks follow each other")
+  {
+    Poses empty;
+    empty.pack(buffer, cpp_math::PackingOptions());
+    cpp_math::packPoints(poses.size(), {poses.x.data(), poses.y.data(), poses.z.data()}, buffer);
+
+    auto const* data = buffer.data();
+    auto remaining = buffer.size();
+    std::vector<cpp_math::PackedBlockKind> kinds;
+    std::vector<uint32_t> counts;
+    while(remaining != 0) {
+      auto header = cpp_math::readPackedBlockHeader(data, remaining);
+      kinds.push_back(header.kind);
+      counts.push_back(header.count);
+      auto decoded = Poses(header.count);
+      auto size = header.kind == cpp_math::PackedBlockKind::Poses
+                ? decoded.unpack(data, remaining)
+                : cpp_math::unpackPoints(data, remaining, {decoded.x.data(), decoded.y.data(), decoded.z.data()});
+      data += size;
+      remaining -= size;
+    }
+    REQUIRE(kinds == std::vector<cpp_math::PackedBlockKind>{
+      cpp_math::PackedBlockKind::Poses, cpp_math::PackedBlockKind::Poses, cpp_math::PackedBlockKind::Points
+    });
+    REQUIRE(counts == std::vector<uint32_t>{300, 0, 300});
+  }
+
+  SECTION("Corrupted blocks")
+  {
+    auto decoded = Poses(poses.size());
+    REQUIRE_THROWS_AS(decoded.unpack(buffer.data(), first_size - 1), std::runtime_error);
+    REQUIRE_THROWS_AS(decoded.unpack(buffer.data(), 10), std::runtime_error);
+    REQUIRE_THROWS_AS(
+      cpp_math::unpackPoints(buffer.data(), buffer.size(), {decoded.x.data(), decoded.y.data(), decoded.z.data()}),
+      std::runtime_error
+    );
+
+    // Continuation bit on the last byte makes the last varint run past the block
+    auto broken = buffer;
+    broken.back() |= 0x80;
+    REQUIRE_THROWS_AS(decoded.unpack(broken.data(), broken.size()), std::runtime_error);
+
+    broken = buffer;
+    broken[0] = 'X';
+    REQUIRE_THROWS_AS(cpp_math::readPackedBlockHeader(broken.data(), broken.size()), std::runtime_error);
+  }
+}
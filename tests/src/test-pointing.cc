@@ -0,0 +1,134 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/pointing.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  double distance(cpp_math::Vector3d const& v1, cpp_math::Vector3d const& v2)
+  {
+    return std::sqrt(std::pow(v1.x - v2.x, 2) + std::pow(v1.y - v2.y, 2) + std::pow(v1.z - v2.z, 2));
+  }
+
+  /// @brief Target reached by the forward function with the solved angles
+  cpp_math::Vector3d reached(
+    cpp_math::Vector3d const& position,
+    cpp_math::HeliAngles const& angles,
+    cpp_math::CameraPointing const& pointing
+  )
+  {
+    return cpp_math::calculatePointByDistanceAndAngles(pointing.distance, position, angles, pointing.camera_angles);
+  }
+}  // namespace
+
+TEST_CASE("Pointing solver is the inverse of calculatePointByDistanceAndAngles")
+{
+  std::mt19937_64 generator(13);
+  std::uniform_real_distribution<double> angle(-180, 180);
+  std::uniform_real_distribution<double> coordinate(-1000, 1000);
+  std::uniform_real_distribution<double> range(1, 20000);
+
+  SECTION("Round trip from camera angles")
+  {
+    for(int i = 0; i < 20000; ++i) {
+      auto angles = cpp_math::HeliAngles{angle(generator), angle(generator) / 6, angle(generator) / 6};
+      if(i % 3 == 0) {
+        angles.roll = 0;
+      }
+      auto position = cpp_math::Vector3d{coordinate(generator), coordinate(generator), coordinate(generator)};
+      auto camera_angles = cpp_math::CameraAngles{angle(generator), angle(generator) / 2};
+      auto point_distance = range(generator);
+      auto target = cpp_math::calculatePointByDistanceAndAngles(point_distance, position, angles, camera_angles);
+
+      auto pointing = cpp_math::calculateCameraAnglesToPoint(position, angles, target);
+      INFO("Heli angles are " << angles);
+      INFO("Camera angles are " << camera_angles);
+      INFO("Solved camera angles are " << pointing.camera_angles);
+      REQUIRE(std::abs(pointing.distance - point_distance) < 1e-9 * point_distance);
+      REQUIRE(std::abs(pointing.camera_angles.yaw) <= 180);
+      REQUIRE(std::abs(pointing.camera_angles.pitch) <= 180);
+      REQUIRE(distance(reached(position, angles, pointing), target) < 1e-9 * point_distance);
+    }
+  }
+
+  SECTION("Without roll the solution is the usual azimuth and elevation")
+  {
+    auto angles = cpp_math::HeliAngles{30, 5, 0};
+    auto pointing = cpp_math::calculateCameraAnglesToPoint({0, 0, 100}, angles, {100, 100, 100 - 100 * std::sqrt(2.0)});
+    REQUIRE(pointing.camera_angles.yaw == Approx(15));
+    REQUIRE(pointing.camera_angles.pitch == Approx(40));
+    REQUIRE(pointing.distance == Approx(200));
+  }
+
+  SECTION("Degenerate directions")
+  {
+    std::vector<cpp_math::HeliAngles> heli_angles = {
+      {0, 0, 0}, {30, 10, 0}, {200, -20, 0}, {30, 10, 15}, {0, 0, 90}, {-90, 45, -30}, {0, 0, 180}
+    };
+    std::vector<cpp_math::Vector3d> targets = {
+      {0, 0, -50}, {0, 0, 50}, {50, 0, 0}, {-50, 0, 0}, {30, 0, -40}, {0, 30, -40}, {1e-9, 0, -50}
+    };
+    for(auto const& angles : heli_angles) {
+      for(auto const& target : targets) {
+        auto pointing = cpp_math::calculateCameraAnglesToPoint({0, 0, 0}, angles, target);
+        INFO("Heli angles are " << angles);
+        INFO("Target is " << target);
+        INFO("Solved camera angles are " << pointing.camera_angles);
+        if(std::isnan(pointing.camera_angles.yaw)) {
+          // Only sideways targets with a roll may be out of reach
+          REQUIRE(std::abs(target.y) / pointing.distance > std::abs(std::cos(cpp_math::degreesToRadians(angles.roll))));
+          REQUIRE(std::isnan(pointing.camera_angles.pitch));
+          continue;
+        }
+        REQUIRE(distance(reached({0, 0, 0}, angles, pointing), target) < 1e-9);
+      }
+    }
+  }
+
+  SECTION("Targets out of reach of the rolled camera")
+  {
+    auto pointing = cpp_math::calculateCameraAnglesToPoint({0, 0, 0}, {0, 0, 60}, {10, 100, -10});
+    REQUIRE(std::isnan(pointing.camera_angles.yaw));
+    REQUIRE(std::isnan(pointing.camera_angles.pitch));
+    REQUIRE(pointing.distance == Approx(std::sqrt(10200.0)));
+  }
+
+  SECTION("Target at the position")
+  {
+    auto pointing = cpp_math::calculateCameraAnglesToPoint({1, 2, 3}, {10, 20, 30}, {1, 2, 3});
+    REQUIRE(pointing.distance == 0);
+    REQUIRE(distance(reached({1, 2, 3}, {10, 20, 30}, pointing), {1, 2, 3}) == 0);
+  }
+
+  SECTION("Batch gives the same results as single targets")
+  {
+    constexpr size_t count = 1000;
+    auto position = cpp_math::Vector3d{10, -20, 500};
+    auto angles = cpp_math::HeliAngles{45, -3, 4};
+    auto solver = cpp_math::PointingSolver(position, angles);
+    std::vector<double> x, y, z, yaw(count), pitch(count), distances(count);
+    for(size_t i = 0; i < count; ++i) {
+      x.push_back(coordinate(generator));
+      y.push_back(coordinate(generator));
+      z.push_back(coordinate(generator) / 10);
+    }
+    solver.solve(count, {x.data(), y.data(), z.data()}, {yaw.data(), pitch.data()}, distances.data());
+    for(size_t i = 0; i < count; ++i) {
+      auto expected = cpp_math::calculateCameraAnglesToPoint(position, angles, {x[i], y[i], z[i]});
+      REQUIRE(distances[i] == expected.distance);
+      if(std::isnan(expected.camera_angles.yaw)) {
+        REQUIRE(std::isnan(yaw[i]));
+        REQUIRE(std::isnan(pitch[i]));
+        continue;
+      }
+      REQUIRE(yaw[i] == expected.camera_angles.yaw);
+      REQUIRE(pitch[i] == expected.camera_angles.pitch);
+    }
+  }
+}
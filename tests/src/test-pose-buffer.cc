@@ -0,0 +1,140 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/pose_buffer.h>
+#include <cpp-math/quaternion.h>
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  bool vectors_almost_equal(
+    cpp_math::Vector3d const& v1,
+    cpp_math::Vector3d const& v2,
+    double epsilon
+  )
+  {
+    return std::abs(v1.x - v2.x) < epsilon && std::abs(v1.y - v2.y) < epsilon
+        && std::abs(v1.z - v2.z) < epsilon;
+  }
+
+  /// @brief Position and yaw grow linearly with time, so interpolation must give exact values
+  void pushSample(cpp_math::PoseBuffer& buffer, double timestamp)
+  {
+    buffer.push(
+      timestamp,
+      cpp_math::Vector3d{timestamp, 2 * timestamp, -timestamp},
+      cpp_math::HeliAngles{timestamp, 0, 0}
+    );
+  }
+}  // namespace
+
+TEST_CASE("PoseBuffer")
+{
+  SECTION("Empty buffer")
+  {
+    auto buffer = cpp_math::PoseBuffer(8);
+    cpp_math::Pose pose;
+    REQUIRE_FALSE(buffer.poseAt(0, pose));
+  }
+
+  SECTION("Capacity is rounded up to a power of two")
+  {
+    REQUIRE(cpp_math::PoseBuffer(5).capacity() == 8);
+    REQUIRE(cpp_math::PoseBuffer(16).capacity() == 16);
+  }
+
+  SECTION("Interpolation")
+  {
+    auto buffer = cpp_math::PoseBuffer(8);
+    for(int i = 0; i < 5; ++i) {
+      pushSample(buffer, i * 10);
+    }
+
+    cpp_math::Pose pose;
+    REQUIRE(buffer.poseAt(25, pose));
+    REQUIRE(vectors_almost_equal(pose.position, cpp_math::Vector3d{25, 50, -25}, 1e-12));
+    auto angles = cpp_math::rollPitchYawFromQuaternion(pose.attitude);
+    INFO("Interpolated angles are " << angles);
+    REQUIRE(std::abs(angles.yaw - 25) < 1e-9);
+
+    REQUIRE(buffer.poseAt(0, pose));
+    REQUIRE(vectors_almost_equal(pose.position, cpp_math::Vector3d{0, 0, 0}, 1e-12));
+    REQUIRE(buffer.poseAt(40, pose));
+    REQUIRE(vectors_almost_equal(pose.position, cpp_math::Vector3d{40, 80, -40}, 1e-12));
+
+    REQUIRE_FALSE(buffer.poseAt(-1, pose));
+    REQUIRE_FALSE(buffer.poseAt(41, pose));
+  }
+
+  SECTION("Heli angles look where calculatePointByDistanceAndAngles does")
+  {
+    for(auto const& angles : {cpp_math::HeliAngles{30, 5, 10}, cpp_math::HeliAngles{-120, -40, 75}, cpp_math::HeliAngles{0, 20, -30}}) {
+      auto buffer = cpp_math::PoseBuffer(8);
+      buffer.push(1, cpp_math::Vector3d{0, 0, 0}, angles);
+      buffer.push(2, cpp_math::Vector3d{0, 0, 0}, angles);
+      cpp_math::Pose pose;
+      REQUIRE(buffer.poseAt(1.5, pose));
+      auto expected = cpp_math::calculatePointByDistanceAndAngles(1, cpp_math::Vector3d{0, 0, 0}, angles, {0, 0});
+      INFO("Heli angles are " << angles);
+      REQUIRE(vectors_almost_equal(cpp_math::rotateVector(cpp_math::Vector3d{1, 0, 0}, pose.attitude), expected, 1e-12));
+    }
+  }
+
+  SECTION("Old samples are overwritten")
+  {
+    auto buffer = cpp_math::PoseBuffer(4);
+    for(int i = 0; i < 10; ++i) {
+      pushSample(buffer, i);
+    }
+
+    cpp_math::Pose pose;
+    double timestamp;
+    REQUIRE(buffer.latest(timestamp, pose));
+    REQUIRE(timestamp == 9);
+    // The oldest of the four stored samples is not used, it is the next one to be overwritten
+    REQUIRE_FALSE(buffer.poseAt(6.5, pose));
+    REQUIRE(buffer.poseAt(7.5, pose));
+    REQUIRE(vectors_almost_equal(pose.position, cpp_math::Vector3d{7.5, 15, -7.5}, 1e-12));
+  }
+
+  SECTION("Readers see consistent samples while the writer runs")
+  {
+    auto buffer = cpp_math::PoseBuffer(16);
+    pushSample(buffer, 0);
+    std::atomic<bool> done(false);
+    std::atomic<int> inconsistent(0);
+
+    std::vector<std::thread> readers;
+    for(int i = 0; i < 4; ++i) {
+      readers.emplace_back([&]() {
+        while(not done) {
+          double timestamp;
+          cpp_math::Pose pose;
+          if(not buffer.latest(timestamp, pose)) {
+            continue;
+          }
+          auto query = timestamp - 3.5;
+          if(buffer.poseAt(query, pose)
+             && not vectors_almost_equal(pose.position, cpp_math::Vector3d{query, 2 * query, -query}, 1e-9))
+          {
+            ++inconsistent;
+          }
+        }
+      });
+    }
+
+    for(int i = 1; i < 200000; ++i) {
+      pushSample(buffer, i);
+    }
+    done = true;
+    for(auto& reader : readers) {
+      reader.join();
+    }
+    REQUIRE(inconsistent == 0);
+  }
+}
@@ -0,0 +1,93 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/pose_context.h>
+
+#include <cstring>
+#include <random>
+
+namespace
+{
+  bool sameBits(cpp_math::Vector3d const& v1, cpp_math::Vector3d const& v2)
+  {
+    return std::memcmp(&v1, &v2, sizeof(v1)) == 0;
+  }
+}  // namespace
+
+TEST_CASE("PoseContext matches calculatePointByDistanceAndAngles")
+{
+  auto const position = cpp_math::Vector3d{100, -200, 1500};
+
+  SECTION("Angles which force different rotation orders")
+  {
+    auto values = {0.0, 45.0, 90.0, -90.0, 180.0, 30.0, 1e-20};
+    for(auto policy : {cpp_math::TrigPolicy::Standard, cpp_math::TrigPolicy::Ulp1}) {
+      cpp_math::PoseContext context(policy);
+      for(auto yaw : values) {
+        for(auto pitch : values) {
+          for(auto roll : values) {
+            for(auto camera_yaw : {0.0, -90.0, 10.0}) {
+              for(auto camera_pitch : {0.0, 90.0, -30.0}) {
+                auto angles = cpp_math::HeliAngles{yaw, pitch, roll};
+                auto camera = cpp_math::CameraAngles{camera_yaw, camera_pitch};
+                auto expected = cpp_math::calculatePointByDistanceAndAngles(1000, position, angles, camera, policy);
+                INFO("yaw " << yaw << ", pitch " << pitch << ", roll " << roll << ", camera " << camera_yaw << " " << camera_pitch);
+                REQUIRE(sameBits(context.calculatePoint(1000, position, angles, camera), expected));
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("Random poses")
+  {
+    std::mt19937_64 generator(21);
+    std::uniform_real_distribution<double> angle(-180, 180);
+    cpp_math::PoseContext context;
+    for(size_t i = 0; i < 10000; ++i) {
+      auto angles = cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)};
+      // Every third pose keeps the heli angles of the previous one
+      for(size_t j = 0; j < 1 + i % 3; ++j) {
+        auto camera = cpp_math::CameraAngles{angle(generator), j == 0 ? angle(generator) : -30.0};
+        auto expected = cpp_math::calculatePointByDistanceAndAngles(500, position, angles, camera);
+        REQUIRE(sameBits(context.calculatePoint(500, position, angles, camera), expected));
+      }
+    }
+  }
+}
+
+TEST_CASE("PoseContext reuses rotations")
+{
+  auto const angles = cpp_math::HeliAngles{30, 5, 2};
+  cpp_math::PoseContext context;
+
+  SECTION("Camera sweeping in yaw recalculates only the yaw rotation")
+  {
+    for(int i = 0; i < 100; ++i) {
+      context.direction(angles, {-45 + 0.9 * i, -60});
+    }
+    // First call resolves yaw, roll and pitch, every next one only yaw
+    REQUIRE(context.stats().direction_misses == 100);
+    REQUIRE(context.stats().direction_hits == 0);
+    REQUIRE(context.stats().rotation_misses == 3 + 99);
+    REQUIRE(context.stats().rotation_hits == 2 * 99);
+  }
+
+  SECTION("Same pose with another distance reuses the direction")
+  {
+    auto camera = cpp_math::CameraAngles{10, -60};
+    auto first = context.calculatePoint(100, {0, 0, 0}, angles, camera);
+    auto second = context.calculatePoint(200, {0, 0, 0}, angles, camera);
+    REQUIRE(second.x == Approx(2 * first.x));
+    REQUIRE(context.stats().direction_hits == 1);
+    REQUIRE(context.stats().direction_misses == 1);
+
+    context.resetStats();
+    context.invalidate();
+    context.calculatePoint(100, {0, 0, 0}, angles, camera);
+    REQUIRE(context.stats().direction_misses == 1);
+    REQUIRE(context.stats().rotation_misses == 3);
+  }
+}
@@ -0,0 +1,170 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/heli_attitude.h>
+#include <cpp-math/quaternion.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  bool vectors_almost_equal(
+    cpp_math::Vector3d const& v1,
+    cpp_math::Vector3d const& v2,
+    double epsilon
+  )
+  {
+    return std::abs(v1.x - v2.x) < epsilon && std::abs(v1.y - v2.y) < epsilon
+        && std::abs(v1.z - v2.z) < epsilon;
+  }
+
+  /// @brief q and -q are the same rotation
+  bool quaternions_almost_equal(
+    cpp_math::Quaternion const& q1,
+    cpp_math::Quaternion const& q2,
+    double epsilon
+  )
+  {
+    auto sign = q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z < 0 ? -1 : 1;
+    return std::abs(q1.w - sign * q2.w) < epsilon && std::abs(q1.x - sign * q2.x) < epsilon
+        && std::abs(q1.y - sign * q2.y) < epsilon && std::abs(q1.z - sign * q2.z) < epsilon;
+  }
+}  // namespace
+
+TEST_CASE("Quaternion")
+{
+  std::mt19937_64 generator(3);
+  std::uniform_real_distribution<double> angle(-180, 180);
+  std::uniform_real_distribution<double> coordinate(-10, 10);
+
+  SECTION("Heli angles look along the X axis of rotateVector")
+  {
+    std::vector<cpp_math::HeliAngles> all_angles{{30, 5, 10}, {0, 0, 45}, {90, 0, 30}, {180, 10, 20}, {0, 90, 15}, {40, 20, 0}};
+    for(int i = 0; i < 1000; ++i) {
+      all_angles.push_back({angle(generator), angle(generator), angle(generator)});
+    }
+    for(auto const& angles : all_angles) {
+      auto q = cpp_math::quaternionFromHeliAngles(angles);
+      auto expected = cpp_math::rotateVector(cpp_math::Vector3d{1, 0, 0}, angles);
+      INFO("Heli angles are " << angles);
+      REQUIRE(vectors_almost_equal(cpp_math::rotateVector(cpp_math::Vector3d{1, 0, 0}, q), expected, 1e-12));
+    }
+  }
+
+  SECTION("Roll, pitch and yaw rotate like rotateVector off the axes")
+  {
+    for(int i = 0; i < 1000; ++i) {
+      auto angles = cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)};
+      auto v = cpp_math::Vector3d{coordinate(generator), coordinate(generator), coordinate(generator)};
+      auto q = cpp_math::quaternionFromRollPitchYaw(angles);
+      auto expected = cpp_math::rotateVector(v, angles);
+      INFO("Heli angles are " << angles);
+      INFO("Source vector is " << v);
+      REQUIRE(vectors_almost_equal(cpp_math::rotateVector(v, q), expected, 1e-12));
+      auto matrix = cpp_math::matrixFromQuaternion(q);
+      REQUIRE(vectors_almost_equal(cpp_math::multiplyMatrixByVector(matrix, v), expected, 1e-12));
+    }
+  }
+
+  SECTION("Roll, pitch and yaw round trip")
+  {
+    for(int i = 0; i < 1000; ++i) {
+      auto angles = cpp_math::HeliAngles{angle(generator), angle(generator) / 2, angle(generator)};
+      auto result = cpp_math::rollPitchYawFromQuaternion(cpp_math::quaternionFromRollPitchYaw(angles));
+      INFO("Heli angles are " << angles);
+      INFO("Heli angles after round trip are " << result);
+      REQUIRE(std::abs(result.yaw - angles.yaw) < 1e-9);
+      REQUIRE(std::abs(result.pitch - angles.pitch) < 1e-9);
+      REQUIRE(std::abs(result.roll - angles.roll) < 1e-9);
+    }
+  }
+
+  SECTION("Matrix round trip")
+  {
+    for(int i = 0; i < 1000; ++i) {
+      auto angles = cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)};
+      auto q = cpp_math::quaternionFromHeliAngles(angles);
+      auto result = cpp_math::quaternionFromMatrix(cpp_math::matrixFromQuaternion(q));
+      INFO("Quaternion is " << q);
+      INFO("Quaternion after round trip is " << result);
+      REQUIRE(quaternions_almost_equal(result, q, 1e-12));
+    }
+  }
+
+  SECTION("HeliAttitude matrix")
+  {
+    auto attitude = cpp_math::HeliAttitude(cpp_math::HeliAngles{40, 20, 10}, cpp_math::CameraAngles{5, 30});
+    auto q = cpp_math::quaternionFromMatrix(attitude.matrix());
+    REQUIRE(vectors_almost_equal(cpp_math::rotateVector(cpp_math::Vector3d{1, 0, 0}, q), attitude.direction(), 1e-12));
+  }
+
+  SECTION("Composition")
+  {
+    auto first = cpp_math::quaternionFromHeliAngles(cpp_math::HeliAngles{30, 0, 0});
+    auto second = cpp_math::quaternionFromHeliAngles(cpp_math::HeliAngles{0, -90, 0});
+    auto composed = cpp_math::composeRotations(first, second);
+    auto v = cpp_math::Vector3d{1, 2, 3};
+    auto expected = cpp_math::rotateVector(cpp_math::rotateVector(v, first), second);
+    REQUIRE(vectors_almost_equal(cpp_math::rotateVector(v, composed), expected, 1e-12));
+    auto inverse = cpp_math::conjugateQuaternion(composed);
+    REQUIRE(vectors_almost_equal(cpp_math::rotateVector(expected, inverse), v, 1e-12));
+  }
+
+  SECTION("Interpolation")
+  {
+    auto q1 = cpp_math::quaternionFromHeliAngles(cpp_math::HeliAngles{10, 0, 0});
+    auto q2 = cpp_math::quaternionFromHeliAngles(cpp_math::HeliAngles{70, 0, 0});
+    auto halfway = cpp_math::quaternionFromHeliAngles(cpp_math::HeliAngles{40, 0, 0});
+    REQUIRE(quaternions_almost_equal(cpp_math::slerp(q1, q2, 0), q1, 1e-15));
+    REQUIRE(quaternions_almost_equal(cpp_math::slerp(q1, q2, 1), q2, 1e-15));
+    REQUIRE(quaternions_almost_equal(cpp_math::slerp(q1, q2, 0.5), halfway, 1e-15));
+    REQUIRE(quaternions_almost_equal(cpp_math::nlerp(q1, q2, 0.5), halfway, 1e-15));
+    auto quarter = cpp_math::quaternionFromHeliAngles(cpp_math::HeliAngles{25, 0, 0});
+    REQUIRE(quaternions_almost_equal(cpp_math::slerp(q1, q2, 0.25), quarter, 1e-15));
+
+    // The shortest path goes through 180 degrees
+    auto q3 = cpp_math::quaternionFromHeliAngles(cpp_math::HeliAngles{170, 0, 0});
+    auto q4 = cpp_math::quaternionFromHeliAngles(cpp_math::HeliAngles{-170, 0, 0});
+    auto back = cpp_math::quaternionFromHeliAngles(cpp_math::HeliAngles{180, 0, 0});
+    REQUIRE(quaternions_almost_equal(cpp_math::slerp(q3, q4, 0.5), back, 1e-15));
+  }
+
+  SECTION("Batch interpolation")
+  {
+    size_t const count = 37;
+    std::vector<double> w1, x1, y1, z1, w2, x2, y2, z2, t;
+    for(size_t i = 0; i < count; ++i) {
+      auto q1 = cpp_math::quaternionFromHeliAngles(cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)});
+      auto q2 = cpp_math::quaternionFromHeliAngles(cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)});
+      w1.push_back(q1.w);
+      x1.push_back(q1.x);
+      y1.push_back(q1.y);
+      z1.push_back(q1.z);
+      w2.push_back(q2.w);
+      x2.push_back(q2.x);
+      y2.push_back(q2.y);
+      z2.push_back(q2.z);
+      t.push_back(static_cast<double>(i) / count);
+    }
+    std::vector<double> w(count), x(count), y(count), z(count);
+    auto q1 = cpp_math::ConstQuaternionArrays{w1.data(), x1.data(), y1.data(), z1.data()};
+    auto q2 = cpp_math::ConstQuaternionArrays{w2.data(), x2.data(), y2.data(), z2.data()};
+    auto result = cpp_math::QuaternionArrays{w.data(), x.data(), y.data(), z.data()};
+
+    cpp_math::slerp(count, q1, q2, t.data(), result);
+    for(size_t i = 0; i < count; ++i) {
+      auto expected = cpp_math::slerp(cpp_math::Quaternion{w1[i], x1[i], y1[i], z1[i]}, cpp_math::Quaternion{w2[i], x2[i], y2[i], z2[i]}, t[i]);
+      REQUIRE(quaternions_almost_equal(cpp_math::Quaternion{w[i], x[i], y[i], z[i]}, expected, 1e-15));
+    }
+
+    cpp_math::nlerp(count, q1, q2, t.data(), result);
+    for(size_t i = 0; i < count; ++i) {
+      auto expected = cpp_math::nlerp(cpp_math::Quaternion{w1[i], x1[i], y1[i], z1[i]}, cpp_math::Quaternion{w2[i], x2[i], y2[i], z2[i]}, t[i]);
+      REQUIRE(quaternions_almost_equal(cpp_math::Quaternion{w[i], x[i], y[i], z[i]}, expected, 1e-15));
+    }
+  }
+}
@@ -2,6 +2,7 @@
 #include <catch2/catch.hpp>
 
 #include <cpp-math/cpp_math.h>
+#include <cpp-math/heli_attitude.h>
 
 using cpp_math::operator<<;
 
@@ -43,6 +44,10 @@ TEST_CASE("calculatePointByDistanceAndAngles")
     INFO("Point expected is " << expected);
     INFO("Point after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles, camera_angles)
+                             .calculatePoint(distance, initial_point);
+    INFO("Point from HeliAttitude is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli is 45 pitch and camera is 45 pitch")
@@ -71,6 +76,10 @@ TEST_CASE("calculatePointByDistanceAndAngles")
     INFO("Point expected is " << expected);
     INFO("Point after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles, camera_angles)
+                             .calculatePoint(distance, initial_point);
+    INFO("Point from HeliAttitude is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli is 90 yaw and camera is 45 pitch")
@@ -103,6 +112,10 @@ TEST_CASE("calculatePointByDistanceAndAngles")
     INFO("Point expected is " << expected);
     INFO("Point after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles, camera_angles)
+                             .calculatePoint(distance, initial_point);
+    INFO("Point from HeliAttitude is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli looks 45 yaw and camera is 45 pitch")
@@ -134,6 +147,10 @@ TEST_CASE("calculatePointByDistanceAndAngles")
     INFO("Point expected is " << expected);
     INFO("Point after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles, camera_angles)
+                             .calculatePoint(distance, initial_point);
+    INFO("Point from HeliAttitude is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli looks 90 roll and camera is 45 pitch")
@@ -165,6 +182,10 @@ TEST_CASE("calculatePointByDistanceAndAngles")
     INFO("Point expected is " << expected);
     INFO("Point after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles, camera_angles)
+                             .calculatePoint(distance, initial_point);
+    INFO("Point from HeliAttitude is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 }
 
@@ -185,6 +206,9 @@ TEST_CASE("Heli rotations")
     INFO("Vector expected is " << expected);
     INFO("Vector after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles).apply(x_vector);
+    INFO("Vector after HeliAttitude rotation is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli looks left")
@@ -201,6 +225,9 @@ TEST_CASE("Heli rotations")
     INFO("Vector expected is " << expected);
     INFO("Vector after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles).apply(x_vector);
+    INFO("Vector after HeliAttitude rotation is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli looks right")
@@ -217,6 +244,9 @@ TEST_CASE("Heli rotations")
     INFO("Vector expected is " << expected);
     INFO("Vector after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles).apply(x_vector);
+    INFO("Vector after HeliAttitude rotation is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli looks up")
@@ -233,6 +263,9 @@ TEST_CASE("Heli rotations")
     INFO("Vector expected is " << expected);
     INFO("Vector after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles).apply(x_vector);
+    INFO("Vector after HeliAttitude rotation is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli looks 45 yaw, -45 pitch")
@@ -249,6 +282,9 @@ TEST_CASE("Heli rotations")
     INFO("Vector expected is " << expected);
     INFO("Vector after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles).apply(x_vector);
+    INFO("Vector after HeliAttitude rotation is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli looks 45 yaw, 45 pitch")
@@ -265,6 +301,9 @@ TEST_CASE("Heli rotations")
     INFO("Vector expected is " << expected);
     INFO("Vector after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles).apply(x_vector);
+    INFO("Vector after HeliAttitude rotation is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli looks 45 roll")
@@ -281,6 +320,9 @@ TEST_CASE("Heli rotations")
     INFO("Vector expected is " << expected);
     INFO("Vector after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles).apply(x_vector);
+    INFO("Vector after HeliAttitude rotation is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli looks 90 roll")
@@ -298,6 +340,9 @@ TEST_CASE("Heli rotations")
     INFO("Vector expected is " << expected);
     INFO("Vector after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles).apply(source_vector);
+    INFO("Vector after HeliAttitude rotation is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli looks -90 roll")
@@ -315,6 +360,9 @@ TEST_CASE("Heli rotations")
     INFO("Vector expected is " << expected);
     INFO("Vector after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles).apply(source_vector);
+    INFO("Vector after HeliAttitude rotation is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 
   SECTION("Heli looks 90 roll and 45 pitch")
@@ -332,6 +380,9 @@ TEST_CASE("Heli rotations")
     INFO("Vector expected is " << expected);
     INFO("Vector after rotation is " << result);
     REQUIRE(vectors_almost_equal(result, expected, 0.0001));
+    auto attitude_result = cpp_math::HeliAttitude(heli_angles).apply(source_vector);
+    INFO("Vector after HeliAttitude rotation is " << attitude_result);
+    REQUIRE(vectors_almost_equal(attitude_result, expected, 0.0001));
   }
 }
 
@@ -0,0 +1,130 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/fixed_rotation.h>
+#include <cpp-math/heli_attitude.h>
+#include <cpp-math/sensor_rig.h>
+#include <cpp-math/vector_expression.h>
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+  bool vectorsAlmostEqual(cpp_math::Vector3d const& v1, cpp_math::Vector3d const& v2, double epsilon)
+  {
+    return std::abs(v1.x - v2.x) < epsilon && std::abs(v1.y - v2.y) < epsilon && std::abs(v1.z - v2.z) < epsilon;
+  }
+
+  struct RigResult
+  {
+    std::vector<double> x, y, z;
+
+    explicit RigResult(size_t size) : x(size), y(size), z(size) {}
+
+    cpp_math::Vector3d operator[](size_t i) const { return {x[i], y[i], z[i]}; }
+
+    cpp_math::Vector3dArrays arrays() { return {x.data(), y.data(), z.data()}; }
+  };
+}  // namespace
+
+TEST_CASE("SensorRig")
+{
+  auto const position = cpp_math::Vector3d{100, -200, 1500};
+
+  SECTION("Matches rotating every sensor separately")
+  {
+    std::mt19937_64 generator(22);
+    std::uniform_real_distribution<double> angle(-180, 180);
+    std::uniform_real_distribution<double> offset(-3, 3);
+    std::uniform_real_distribution<double> distance(10, 5000);
+
+    // More sensors than one chunk
+    std::vector<cpp_math::SensorMount> mounts;
+    for(size_t i = 0; i < 70; ++i) {
+      mounts.push_back({
+        cpp_math::makeRotation(cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)}),
+        {offset(generator), offset(generator), offset(generator)}
+      });
+    }
+    cpp_math::SensorRig rig(mounts);
+    REQUIRE(rig.size() == mounts.size());
+
+    for(size_t pose = 0; pose < 200; ++pose) {
+      auto angles = cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)};
+      std::vector<double> camera_yaw, camera_pitch, distances;
+      for(size_t i = 0; i < rig.size(); ++i) {
+        camera_yaw.push_back(angle(generator));
+        camera_pitch.push_back(angle(generator));
+        distances.push_back(distance(generator));
+      }
+      RigResult result(rig.size());
+      rig.calculatePoints(position, angles, {camera_yaw.data(), camera_pitch.data()}, distances.data(), result.arrays());
+
+      auto heli = cpp_math::HeliAttitude(angles).matrix();
+      for(size_t i = 0; i < rig.size(); ++i) {
+        auto camera = cpp_math::rotateVector(cpp_math::Vector3d{1, 0, 0}, cpp_math::HeliAngles{camera_yaw[i], camera_pitch[i], 0});
+        auto direction = cpp_math::multiplyMatrixByVector(heli, cpp_math::multiplyMatrixByVector(mounts[i].rotation, camera));
+        auto expected = position + cpp_math::multiplyMatrixByVector(heli, mounts[i].lever_arm) + distances[i] * direction;
+        INFO("pose " << pose << ", sensor " << i);
+        REQUIRE(vectorsAlmostEqual(result[i], expected, 1e-8));
+      }
+    }
+  }
+
+  SECTION("Heli rotation is the one of HeliAttitude for angles which force different orders")
+  {
+    cpp_math::SensorRig rig;
+    rig.addSensor({cpp_math::identityMatrix(), {0, 0, 0}});
+    double camera_yaw[] = {0};
+    double camera_pitch[] = {0};
+    double distances[] = {100};
+    auto values = {0.0, 45.0, 90.0, -90.0, 180.0, 30.0, 1e-20};
+    for(auto yaw : values) {
+      for(auto pitch : values) {
+        for(auto roll : values) {
+          auto angles = cpp_math::HeliAngles{yaw, pitch, roll};
+          RigResult result(1);
+          rig.calculatePoints(position, angles, {camera_yaw, camera_pitch}, distances, result.arrays());
+          auto expected = position + 100 * cpp_math::HeliAttitude(angles).direction();
+          INFO("yaw " << yaw << ", pitch " << pitch << ", roll " << roll);
+          REQUIRE(vectorsAlmostEqual(result[0], expected, 1e-9));
+        }
+      }
+    }
+  }
+
+  SECTION("Identity mount without heli pitch and roll is calculatePointByDistanceAndAngles")
+  {
+    cpp_math::SensorRig rig;
+    rig.addSensor({cpp_math::identityMatrix(), {0, 0, 0}});
+    rig.addSensor({cpp_math::makeRotation(cpp_math::Axis::Z, 90), {0, 0, -1}});
+    double camera_yaw[] = {25, 0};
+    double camera_pitch[] = {-40, 0};
+    double distances[] = {1000, 10};
+    RigResult result(rig.size());
+    rig.calculatePoints(position, {30, 0, 0}, {camera_yaw, camera_pitch}, distances, result.arrays());
+
+    auto expected = cpp_math::calculatePointByDistanceAndAngles(1000, position, {30, 0, 0}, {25, -40});
+    REQUIRE(vectorsAlmostEqual(result[0], expected, 1e-9));
+    // Looks to the left of the heli from one meter below it
+    auto expected_left = position + cpp_math::Vector3d{-10 * std::sin(M_PI / 6), 10 * std::cos(M_PI / 6), -1};
+    REQUIRE(vectorsAlmostEqual(result[1], expected_left, 1e-9));
+  }
+
+  SECTION("Mounts are kept")
+  {
+    auto mount = cpp_math::SensorMount{cpp_math::makeRotation(cpp_math::Axis::Y, -2.5), {1, 2, 3}};
+    cpp_math::SensorRig rig;
+    REQUIRE(rig.addSensor(mount) == 0);
+    for(size_t row = 0; row < 3; ++row) {
+      for(size_t column = 0; column < 3; ++column) {
+        REQUIRE(rig.mount(0).rotation[row][column] == mount.rotation[row][column]);
+      }
+    }
+    REQUIRE(rig.mount(0).lever_arm.z == 3);
+    REQUIRE_THROWS_AS(rig.mount(1), std::runtime_error);
+  }
+}
@@ -0,0 +1,143 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/telemetry_log.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+  /// @brief Temporary file removed at the end of the test
+  class TemporaryFile
+  {
+  public:
+    TemporaryFile()
+    {
+      char path[] = "/tmp/cpp-math-telemetry-XXXXXX";
+      auto fd = mkstemp(path);
+      if(fd < 0) {
+        throw std::runtime_error("Can not create temporary file");
+      }
+      close(fd);
+      path_ = path;
+    }
+
+    ~TemporaryFile() { std::remove(path_.c_str()); }
+
+    std::string const& path() const { return path_; }
+
+  private:
+    std::string path_;
+  };
+
+  std::vector<cpp_math::TelemetryRecord> randomRecords(size_t count)
+  {
+    std::mt19937_64 generator(3);
+    std::uniform_real_distribution<double> angle(-180, 180);
+    std::uniform_real_distribution<double> coordinate(-1000, 1000);
+    std::uniform_real_distribution<double> distance(0, 5000);
+    std::vector<cpp_math::TelemetryRecord> records;
+    for(size_t i = 0; i < count; ++i) {
+      records.push_back(cpp_math::TelemetryRecord{
+        static_cast<double>(i) / 200,
+        {coordinate(generator), coordinate(generator), coordinate(generator)},
+        {angle(generator), angle(generator), angle(generator)},
+        {angle(generator), angle(generator)},
+        distance(generator)
+      });
+    }
+    return records;
+  }
+}  // namespace
+
+TEST_CASE("TelemetryLog")
+{
+  TemporaryFile file;
+
+  SECTION("Maps written records")
+  {
+    auto records = randomRecords(5000);
+    cpp_math::writeTelemetryLog(file.path(), records);
+    cpp_math::TelemetryLog log(file.path());
+    REQUIRE(log.size() == records.size());
+    REQUIRE(std::memcmp(log.records(), records.data(), records.size() * sizeof(records[0])) == 0);
+
+    // Released pages come back from the file when they are touched again
+    log.release(4000);
+    REQUIRE(std::memcmp(log.records(), records.data(), records.size() * sizeof(records[0])) == 0);
+  }
+
+  SECTION("Empty log")
+  {
+    cpp_math::writeTelemetryLog(file.path(), {});
+    cpp_math::TelemetryLog log(file.path());
+    REQUIRE(log.size() == 0);
+  }
+
+  SECTION("Truncated record")
+  {
+    std::ofstream(file.path(), std::ios::binary) << std::string(sizeof(cpp_math::TelemetryRecord) + 8, '\0');
+    REQUIRE_THROWS_AS(cpp_math::TelemetryLog(file.path()), std::runtime_error);
+  }
+
+  SECTION("Missing file")
+  {
+    REQUIRE_THROWS_AS(cpp_math::TelemetryLog(file.path() + "-missing"), std::runtime_error);
+  }
+}
+
+TEST_CASE("Georeferencer")
+{
+  auto records = randomRecords(2500);
+
+  SECTION("Strict mode gives the points of single calls")
+  {
+    for(size_t chunk_size : {1, 7, 1024, 5000}) {
+      cpp_math::Georeferencer georeferencer(chunk_size, cpp_math::BatchMode::Strict);
+      std::vector<cpp_math::GeoreferencedRecord> result(records.size());
+      georeferencer.process(records.data(), records.size(), result.data());
+      for(size_t i = 0; i < records.size(); ++i) {
+        auto const& record = records[i];
+        auto expected = cpp_math::calculatePointByDistanceAndAngles(
+          record.distance, record.position, record.angles, record.camera_angles
+        );
+        INFO("record " << i << ", chunk size " << chunk_size);
+        REQUIRE(result[i].timestamp == record.timestamp);
+        REQUIRE(std::memcmp(&result[i].point, &expected, sizeof(expected)) == 0);
+      }
+    }
+  }
+
+  SECTION("Writes into a mapped output file")
+  {
+    TemporaryFile input, output;
+    cpp_math::writeTelemetryLog(input.path(), records);
+    {
+      cpp_math::TelemetryLog log(input.path());
+      cpp_math::GeoreferencedLogWriter writer(output.path(), log.size());
+      cpp_math::Georeferencer georeferencer;
+      georeferencer.process(log.records(), 1000, writer.records());
+      writer.release(1000);
+      log.release(1000);
+      georeferencer.process(log.records() + 1000, log.size() - 1000, writer.records() + 1000);
+    }
+
+    std::vector<cpp_math::GeoreferencedRecord> expected(records.size());
+    cpp_math::Georeferencer().process(records.data(), records.size(), expected.data());
+    std::vector<cpp_math::GeoreferencedRecord> written(records.size());
+    std::ifstream file(output.path(), std::ios::binary);
+    file.read(reinterpret_cast<char*>(written.data()), static_cast<std::streamsize>(written.size() * sizeof(written[0])));
+    REQUIRE(file.gcount() == static_cast<std::streamsize>(written.size() * sizeof(written[0])));
+    REQUIRE(file.peek() == std::char_traits<char>::eof());
+    REQUIRE(std::memcmp(written.data(), expected.data(), written.size() * sizeof(written[0])) == 0);
+  }
+}
@@ -0,0 +1,255 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/terrain.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  constexpr double tile_size = 100;
+
+  /// @brief Directory with tiles which is removed with everything in it
+  class TileDirectory
+  {
+  public:
+    TileDirectory()
+    {
+      char path[] = "/tmp/cpp-math-terrain-XXXXXX";
+      if(mkdtemp(path) == nullptr) {
+        throw std::runtime_error("Can not create temporary directory");
+      }
+      path_ = path;
+    }
+
+    ~TileDirectory()
+    {
+      for(auto const& file : files_) {
+        std::remove(file.c_str());
+      }
+      rmdir(path_.c_str());
+    }
+
+    std::string const& path() const { return path_; }
+
+    /// @brief Writes tile (column, row) of 101 x 101 samples with heights given by function of x and y
+    void write(int64_t column, int64_t row, std::function<double(double, double)> const& height)
+    {
+      constexpr uint32_t samples = 101;
+      auto cell_size = tile_size / (samples - 1);
+      auto origin_x = static_cast<double>(column) * tile_size;
+      auto origin_y = static_cast<double>(row) * tile_size;
+      std::vector<float> heights;
+      for(uint32_t j = 0; j < samples; ++j) {
+        for(uint32_t i = 0; i < samples; ++i) {
+          heights.push_back(static_cast<float>(height(origin_x + i * cell_size, origin_y + j * cell_size)));
+        }
+      }
+      auto file = path_ + "/" + std::to_string(column) + "_" + std::to_string(row) + ".dem";
+      cpp_math::writeDemTile(file, cpp_math::makeDemTileHeader(samples, samples, origin_x, origin_y, cell_size), heights);
+      files_.push_back(file);
+    }
+
+  private:
+    std::string path_;
+    std::vector<std::string> files_;
+  };
+
+  double hills(double x, double y)
+  {
+    return 20 + 8 * std::sin(x / 7) * std::cos(y / 11) + 3 * std::sin((x + y) / 3);
+  }
+}  // namespace
+
+TEST_CASE("Ray intersection with DEM tiles")
+{
+  TileDirectory directory;
+  std::mt19937_64 generator(3);
+  std::uniform_real_distribution<double> coordinate(0, 2 * tile_size);
+  std::uniform_real_distribution<double> unit(-1, 1);
+
+  SECTION("Flat terrain")
+  {
+    directory.write(0, 0, [](double, double) { return 100; });
+    cpp_math::DemTileCache cache(directory.path(), tile_size, 4);
+    auto hit = cpp_math::intersectTerrain(cache, {50, 50, 500}, {0, 0, -2}, 1000);
+    REQUIRE(hit.distance == Approx(400));
+    REQUIRE(hit.point.z == Approx(100));
+    REQUIRE(cache.heightAt(12.5, 33.3) == 100);
+
+    auto up = cpp_math::intersectTerrain(cache, {50, 50, 500}, {0.1, 0, 1}, 1000);
+    REQUIRE(std::isnan(up.distance));
+    auto short_ray = cpp_math::intersectTerrain(cache, {50, 50, 500}, {0, 0, -1}, 300);
+    REQUIRE(std::isnan(short_ray.distance));
+  }
+
+  SECTION("Plane over several tiles is intersected exactly")
+  {
+    auto plane = [](double x, double y) { return 0.1 * x + 0.05 * y + 20; };
+    for(int64_t column = 0; column < 2; ++column) {
+      for(int64_t row = 0; row < 2; ++row) {
+        directory.write(column, row, plane);
+      }
+    }
+    cpp_math::DemTileCache cache(directory.path(), tile_size, 4);
+    for(int i = 0; i < 2000; ++i) {
+      auto origin = cpp_math::Vector3d{coordinate(generator), coordinate(generator), 80};
+      auto direction = cpp_math::Vector3d{unit(generator), unit(generator), -1};
+      auto t = (origin.z - plane(origin.x, origin.y)) / (0.1 * direction.x + 0.05 * direction.y - direction.z);
+      auto expected = cpp_math::addVectors(origin, cpp_math::multiplyVectorByScalar(direction, t));
+      auto hit = cpp_math::intersectTerrain(cache, origin, direction, 1000);
+      INFO("Origin is " << origin << ", direction is " << direction);
+      if(expected.x < 0 or expected.y < 0 or expected.x > 2 * tile_size or expected.y > 2 * tile_size) {
+        REQUIRE(std::isnan(hit.distance));
+        continue;
+      }
+      INFO("Expected point is " << expected << ", hit is " << hit.point);
+      REQUIRE(std::abs(hit.point.x - expected.x) < 1e-4);
+      REQUIRE(std::abs(hit.point.y - expected.y) < 1e-4);
+      REQUIRE(std::abs(hit.point.z - expected.z) < 1e-4);
+    }
+  }
+
+  SECTION("Hills: the hit is on the surface and the ray is above it before")
+  {
+    for(int64_t column = 0; column < 2; ++column) {
+      for(int64_t row = 0; row < 2; ++row) {
+        directory.write(column, row, hills);
+      }
+    }
+    cpp_math::DemTileCache cache(directory.path(), tile_size, 4);
+    int hits = 0;
+    for(int i = 0; i < 500; ++i) {
+      auto origin = cpp_math::Vector3d{coordinate(generator), coordinate(generator), 40 + 20 * unit(generator)};
+      auto direction = cpp_math::Vector3d{unit(generator), unit(generator), -0.2 + 0.15 * unit(generator)};
+      auto hit = cpp_math::intersectTerrain(cache, origin, direction, 1000);
+      if(std::isnan(hit.distance)) {
+        continue;
+      }
+      ++hits;
+      INFO("Origin is " << origin << ", direction is " << direction << ", hit is " << hit.point);
+      if(origin.z < cache.heightAt(origin.x, origin.y)) {
+        // Rays which start under the surface hit it right away
+        REQUIRE(hit.distance == 0);
+        continue;
+      }
+      REQUIRE(std::abs(hit.point.z - cache.heightAt(hit.point.x, hit.point.y)) < 1e-6);
+      auto length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+      for(double t = 0; t < hit.distance - 1e-6; t += 0.01) {
+        auto point = cpp_math::addVectors(origin, cpp_math::multiplyVectorByScalar(direction, t / length));
+        REQUIRE(point.z >= cache.heightAt(point.x, point.y) - 1e-9);
+      }
+    }
+    REQUIRE(hits > 250);
+  }
+
+  SECTION("Batch gives the same results as single rays")
+  {
+    directory.write(0, 0, hills);
+    directory.write(1, 0, hills);
+    cpp_math::DemTileCache cache(directory.path(), tile_size, 4);
+    constexpr size_t count = 300;
+    auto origin = cpp_math::Vector3d{50, 50, 60};
+    std::vector<double> x, y, z, hit_x(count), hit_y(count), hit_z(count), distances(count);
+    for(size_t i = 0; i < count; ++i) {
+      x.push_back(unit(generator));
+      y.push_back(unit(generator));
+      z.push_back(-0.5);
+    }
+    cpp_math::intersectTerrain(
+      cache, count, origin, {x.data(), y.data(), z.data()}, 500, {hit_x.data(), hit_y.data(), hit_z.data()}, distances.data()
+    );
+    for(size_t i = 0; i < count; ++i) {
+      auto expected = cpp_math::intersectTerrain(cache, origin, {x[i], y[i], z[i]}, 500);
+      if(std::isnan(expected.distance)) {
+        REQUIRE(std::isnan(distances[i]));
+        continue;
+      }
+      REQUIRE(distances[i] == expected.distance);
+      REQUIRE(hit_x[i] == expected.point.x);
+      REQUIRE(hit_y[i] == expected.point.y);
+      REQUIRE(hit_z[i] == expected.point.z);
+    }
+  }
+
+  SECTION("Cache keeps recently used tiles")
+  {
+    directory.write(0, 0, hills);
+    directory.write(1, 0, hills);
+    directory.write(2, 0, hills);
+    cpp_math::DemTileCache cache(directory.path(), tile_size, 2);
+    auto first = cache.tile(0, 0);
+    REQUIRE(first != nullptr);
+    cache.tile(1, 0);
+    REQUIRE(cache.tile(0, 0) == first);
+    REQUIRE(cache.misses() == 2);
+    REQUIRE(cache.hits() == 1);
+
+    // (1, 0) is the least recently used one now
+    cache.tile(2, 0);
+    cache.tile(0, 0);
+    REQUIRE(cache.misses() == 3);
+    cache.tile(1, 0);
+    REQUIRE(cache.misses() == 4);
+    // Evicted tiles stay valid while they are held
+    REQUIRE(first->heightAt(10, 10) == Approx(hills(10, 10)).margin(1e-5));
+
+    // Tiles which are not on disk do not evict loaded ones
+    REQUIRE(cache.tile(5, 5) == nullptr);
+    REQUIRE(std::isnan(cache.heightAt(550, 550)));
+    cache.tile(0, 0);
+    REQUIRE(cache.misses() == 4);
+  }
+
+  SECTION("Walk stops outside of tiles and above them")
+  {
+    directory.write(0, 0, [](double, double) { return 50; });
+    directory.write(1, 0, [](double, double) { return 100; });
+    cpp_math::DemTileCache cache(directory.path(), tile_size, 4);
+    int64_t min_column, min_row, max_column, max_row;
+    REQUIRE(cache.tileExtent(min_column, min_row, max_column, max_row));
+    REQUIRE(min_column == 0);
+    REQUIRE(max_column == 1);
+    REQUIRE(min_row == 0);
+    REQUIRE(max_row == 0);
+    REQUIRE(std::isinf(cache.maxHeight()));
+
+    auto infinite = cpp_math::intersectTerrain(cache, {50, 50, 500}, {0, 0, -1}, std::numeric_limits<double>::infinity());
+    REQUIRE(std::isnan(infinite.distance));
+
+    // Starts far away and leaves the tiles after a few steps instead of walking 1e13 tiles
+    auto far = cpp_math::intersectTerrain(cache, {-1e9, 50, 80}, {1, 0, 0}, 1e15);
+    REQUIRE(far.point.x == Approx(100));
+    REQUIRE(far.point.z == 80);
+    auto away = cpp_math::intersectTerrain(cache, {-1e9, 50, 120}, {1, 0, 0}, 1e15);
+    REQUIRE(std::isnan(away.distance));
+    REQUIRE(cache.maxHeight() == 100);
+    REQUIRE(cache.misses() == 2);
+
+    cpp_math::DemTileCache empty(directory.path() + "/missing", tile_size, 4);
+    REQUIRE_FALSE(empty.tileExtent(min_column, min_row, max_column, max_row));
+    REQUIRE(std::isnan(cpp_math::intersectTerrain(empty, {50, 50, 500}, {0, 0, -1}, 1000).distance));
+  }
+
+  SECTION("Broken files")
+  {
+    auto path = directory.path() + "/0_0.dem";
+    std::ofstream(path) << "not a tile at all, just some text which is longer than the header";
+    cpp_math::DemTileCache cache(directory.path(), tile_size, 2);
+    REQUIRE_THROWS_AS(cache.tile(0, 0), std::runtime_error);
+    std::remove(path.c_str());
+  }
+}
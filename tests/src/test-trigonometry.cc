@@ -0,0 +1,181 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/heli_attitude.h>
+#include <cpp-math/trigonometry.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  bool vectors_almost_equal(
+    cpp_math::Vector3d const& v1,
+    cpp_math::Vector3d const& v2,
+    double epsilon
+  )
+  {
+    return std::abs(v1.x - v2.x) < epsilon && std::abs(v1.y - v2.y) < epsilon
+        && std::abs(v1.z - v2.z) < epsilon;
+  }
+
+  /// @brief Reference sin and cos which reduce degrees exactly before going to radians
+  void reference_sincos(double degrees, long double& sin_result, long double& cos_result)
+  {
+    auto reduced = std::fmod(static_cast<long double>(degrees), 360.0L);
+    auto quadrant = std::nearbyint(reduced / 90);
+    auto radians = (reduced - 90 * quadrant) * (3.14159265358979323846264338327950288L / 180);
+    auto s = std::sin(radians);
+    auto c = std::cos(radians);
+    switch((static_cast<int>(quadrant) % 4 + 4) % 4) {
+      case 0: sin_result = s; cos_result = c; break;
+      case 1: sin_result = c; cos_result = -s; break;
+      case 2: sin_result = -s; cos_result = -c; break;
+      default: sin_result = -c; cos_result = s; break;
+    }
+  }
+
+  double ulps(double value, long double reference)
+  {
+    auto rounded = std::abs(static_cast<double>(reference));
+    auto ulp = rounded == 0 ? std::numeric_limits<double>::denorm_min()
+                            : std::nextafter(rounded, std::numeric_limits<double>::infinity()) - rounded;
+    return static_cast<double>(std::abs(value - reference) / ulp);
+  }
+
+  std::vector<double> test_angles()
+  {
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> angle(-720, 720);
+    std::vector<double> result;
+    for(int i = 0; i < 20000; ++i) {
+      result.push_back(angle(generator));
+    }
+    for(int i = 0; i < 2000; ++i) {
+      result.push_back(std::ldexp(angle(generator), i % 50));
+    }
+    return result;
+  }
+}  // namespace
+
+TEST_CASE("sincosDeg")
+{
+  auto angles = test_angles();
+
+  SECTION("Multiples of 90 degrees are exact")
+  {
+    for(auto policy : {cpp_math::TrigPolicy::Ulp1, cpp_math::TrigPolicy::AbsError1e9, cpp_math::TrigPolicy::AbsError1e6}) {
+      for(int k = -16; k <= 16; ++k) {
+        double s, c;
+        cpp_math::sincosDeg(90.0 * k, s, c, policy);
+        INFO("Angle is " << 90.0 * k);
+        auto quadrant = (k % 4 + 4) % 4;
+        REQUIRE(s == (quadrant == 1 ? 1 : quadrant == 3 ? -1 : 0));
+        REQUIRE(c == (quadrant == 0 ? 1 : quadrant == 2 ? -1 : 0));
+      }
+    }
+    double s, c;
+    cpp_math::sincosDeg(180.0 * (1ll << 40), s, c);
+    REQUIRE(s == 0);
+    REQUIRE(c == 1);
+  }
+
+  SECTION("Ulp1 is below one ULP")
+  {
+    for(auto degrees : angles) {
+      double s, c;
+      long double reference_s, reference_c;
+      cpp_math::sincosDeg(degrees, s, c, cpp_math::TrigPolicy::Ulp1);
+      reference_sincos(degrees, reference_s, reference_c);
+      INFO("Angle is " << degrees);
+      REQUIRE(ulps(s, reference_s) < 1);
+      REQUIRE(ulps(c, reference_c) < 1);
+    }
+  }
+
+  SECTION("Absolute error modes stay within their bounds")
+  {
+    auto check = [&](cpp_math::TrigPolicy policy, double bound) {
+      for(auto degrees : angles) {
+        double s, c;
+        long double reference_s, reference_c;
+        cpp_math::sincosDeg(degrees, s, c, policy);
+        reference_sincos(degrees, reference_s, reference_c);
+        INFO("Angle is " << degrees);
+        REQUIRE(std::abs(s - reference_s) < bound);
+        REQUIRE(std::abs(c - reference_c) < bound);
+      }
+    };
+    check(cpp_math::TrigPolicy::AbsError1e9, 1e-9);
+    check(cpp_math::TrigPolicy::AbsError1e6, 1e-6);
+  }
+
+  SECTION("Batch matches single values")
+  {
+    for(auto policy : {cpp_math::TrigPolicy::Ulp1, cpp_math::TrigPolicy::AbsError1e9, cpp_math::TrigPolicy::AbsError1e6}) {
+      // Odd count to go through the tail of SIMD kernels
+      auto count = angles.size() - 3;
+      std::vector<double> sin_values(count), cos_values(count);
+      cpp_math::sincosDeg(count, angles.data(), sin_values.data(), cos_values.data(), policy);
+      for(size_t i = 0; i < count; ++i) {
+        double s, c;
+        cpp_math::sincosDeg(angles[i], s, c, policy);
+        INFO("Angle is " << angles[i]);
+        REQUIRE(std::abs(sin_values[i] - s) <= 4 * std::numeric_limits<double>::epsilon());
+        REQUIRE(std::abs(cos_values[i] - c) <= 4 * std::numeric_limits<double>::epsilon());
+      }
+    }
+  }
+}
+
+TEST_CASE("TrigPolicy")
+{
+  std::mt19937_64 generator(11);
+  std::uniform_real_distribution<double> angle(-180, 180);
+  std::uniform_real_distribution<double> coordinate(-10, 10);
+
+  SECTION("Standard is the default")
+  {
+    for(int i = 0; i < 1000; ++i) {
+      auto angles = cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)};
+      auto v = cpp_math::Vector3d{coordinate(generator), coordinate(generator), coordinate(generator)};
+      auto expected = cpp_math::rotateVector(v, angles);
+      auto result = cpp_math::rotateVector(v, angles, cpp_math::TrigPolicy::Standard);
+      REQUIRE(result.x == expected.x);
+      REQUIRE(result.y == expected.y);
+      REQUIRE(result.z == expected.z);
+    }
+  }
+
+  SECTION("Policies rotate like Standard")
+  {
+    auto check = [&](cpp_math::TrigPolicy policy, double epsilon) {
+      for(int i = 0; i < 1000; ++i) {
+        auto angles = cpp_math::HeliAngles{angle(generator), angle(generator), angle(generator)};
+        auto camera_angles = cpp_math::CameraAngles{angle(generator), angle(generator)};
+        auto v = cpp_math::Vector3d{coordinate(generator), coordinate(generator), coordinate(generator)};
+        auto position = cpp_math::Vector3d{coordinate(generator), coordinate(generator), coordinate(generator)};
+        INFO("Heli angles are " << angles);
+        INFO("Source vector is " << v);
+        REQUIRE(vectors_almost_equal(
+          cpp_math::rotateVector(v, angles, policy), cpp_math::rotateVector(v, angles), epsilon
+        ));
+        REQUIRE(vectors_almost_equal(
+          cpp_math::calculatePointByDistanceAndAngles(100, position, angles, camera_angles, policy),
+          cpp_math::calculatePointByDistanceAndAngles(100, position, angles, camera_angles),
+          100 * epsilon
+        ));
+        REQUIRE(vectors_almost_equal(
+          cpp_math::HeliAttitude(angles, policy).apply(v), cpp_math::rotateVector(v, angles), epsilon
+        ));
+      }
+    };
+    check(cpp_math::TrigPolicy::Ulp1, 1e-12);
+    check(cpp_math::TrigPolicy::AbsError1e9, 1e-7);
+    check(cpp_math::TrigPolicy::AbsError1e6, 1e-4);
+  }
+}
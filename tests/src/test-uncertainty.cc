@@ -0,0 +1,214 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/uncertainty.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+  struct Input
+  {
+    double distance;
+    cpp_math::Vector3d position;
+    cpp_math::HeliAngles angles;
+    cpp_math::CameraAngles camera_angles;
+  };
+
+  cpp_math::Vector3d point(Input const& input)
+  {
+    return cpp_math::calculatePointByDistanceAndAngles(
+      input.distance, input.position, input.angles, input.camera_angles
+    );
+  }
+
+  /// @brief Input i moved by delta, in the order of cpp_math::PointInput
+  Input moved(Input input, size_t i, double delta)
+  {
+    double* values[] = {
+      &input.distance, &input.position.x, &input.position.y, &input.position.z, &input.angles.yaw,
+      &input.angles.pitch, &input.angles.roll, &input.camera_angles.yaw, &input.camera_angles.pitch
+    };
+    *values[i] += delta;
+    return input;
+  }
+
+  std::vector<Input> randomInputs(size_t count)
+  {
+    std::mt19937_64 generator(5);
+    std::uniform_real_distribution<double> angle(-180, 180);
+    std::uniform_real_distribution<double> coordinate(-1000, 1000);
+    std::uniform_real_distribution<double> distance(10, 20000);
+    std::vector<Input> inputs;
+    for(size_t i = 0; i < count; ++i) {
+      inputs.push_back(Input{
+        distance(generator),
+        {coordinate(generator), coordinate(generator), coordinate(generator)},
+        {angle(generator), angle(generator), angle(generator)},
+        {angle(generator), angle(generator)}
+      });
+    }
+    return inputs;
+  }
+
+  bool sameBits(cpp_math::Vector3d const& a, cpp_math::Vector3d const& b)
+  {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+  }
+}  // namespace
+
+TEST_CASE("calculatePointWithJacobian")
+{
+  SECTION("Point is the same bits as calculatePointByDistanceAndAngles")
+  {
+    auto inputs = randomInputs(2000);
+    auto values = {0.0, 1e-15, 30.0, 45.0, 90.0, -90.0, 180.0, 270.0, -360.0};
+    for(auto yaw : values) {
+      for(auto pitch : values) {
+        for(auto roll : values) {
+          inputs.push_back(Input{100, {1, 2, 3}, {yaw, pitch, roll}, {0, 0}});
+          inputs.push_back(Input{100, {1, 2, 3}, {yaw, pitch, roll}, {-yaw, 10}});
+        }
+      }
+    }
+    cpp_math::PointJacobian jacobian;
+    for(auto const& input : inputs) {
+      auto result = cpp_math::calculatePointWithJacobian(
+        input.distance, input.position, input.angles, input.camera_angles, jacobian
+      );
+      INFO(input.angles << ", " << input.camera_angles);
+      REQUIRE(sameBits(result, point(input)));
+    }
+  }
+
+  SECTION("Derivatives match central differences")
+  {
+    cpp_math::PointJacobian jacobian;
+    for(auto const& input : randomInputs(2000)) {
+      cpp_math::calculatePointWithJacobian(input.distance, input.position, input.angles, input.camera_angles, jacobian);
+      for(size_t i = 0; i < cpp_math::point_inputs_count; ++i) {
+        // Degrees and meters, both are far from where rounding or curvature matter
+        auto const delta = 1e-5;
+        auto forward = point(moved(input, i, delta));
+        auto backward = point(moved(input, i, -delta));
+        auto const& column = jacobian.columns[i];
+        auto tolerance = 1e-6 * std::max(1.0, input.distance * 3.14159265358979323846 / 180);
+        INFO("input " << i << ", " << input.angles << ", " << input.camera_angles);
+        REQUIRE(column.x == Approx((forward.x - backward.x) / (2 * delta)).margin(tolerance));
+        REQUIRE(column.y == Approx((forward.y - backward.y) / (2 * delta)).margin(tolerance));
+        REQUIRE(column.z == Approx((forward.z - backward.z) / (2 * delta)).margin(tolerance));
+      }
+    }
+  }
+}
+
+TEST_CASE("propagateCovariance")
+{
+  SECTION("Yaw error moves a point ahead sideways")
+  {
+    cpp_math::PointJacobian jacobian;
+    cpp_math::calculatePointWithJacobian(1000, {0, 0, 0}, {0, 0, 0}, {0, 0}, jacobian);
+    cpp_math::PointInputCovariance covariance{};
+    covariance[static_cast<size_t>(cpp_math::PointInput::Yaw)][static_cast<size_t>(cpp_math::PointInput::Yaw)] = 0.01;
+    covariance[static_cast<size_t>(cpp_math::PointInput::Distance)][static_cast<size_t>(cpp_math::PointInput::Distance)] = 4;
+    auto result = cpp_math::propagateCovariance(jacobian, covariance);
+    auto sideways = 1000 * 0.1 * 3.14159265358979323846 / 180;
+    REQUIRE(result[0][0] == Approx(4));
+    REQUIRE(result[1][1] == Approx(sideways * sideways));
+    REQUIRE(result[2][2] == Approx(0).margin(1e-12));
+    REQUIRE(result[0][1] == Approx(0).margin(1e-12));
+  }
+
+  SECTION("Batches match single points")
+  {
+    auto inputs = randomInputs(3000);
+    auto count = inputs.size();
+    std::vector<double> distances, x, y, z, yaw, pitch, roll, camera_yaw, camera_pitch;
+    for(auto const& input : inputs) {
+      distances.push_back(input.distance);
+      x.push_back(input.position.x);
+      y.push_back(input.position.y);
+      z.push_back(input.position.z);
+      yaw.push_back(input.angles.yaw);
+      pitch.push_back(input.angles.pitch);
+      roll.push_back(input.angles.roll);
+      camera_yaw.push_back(input.camera_angles.yaw);
+      camera_pitch.push_back(input.camera_angles.pitch);
+    }
+    std::vector<double> sigma_distance(count, 0.5), sigma_xy(count, 2), sigma_angle(count, 0.05), sigma_camera(count, 0.02);
+    std::vector<double> points(3 * count), covariances(6 * count);
+    auto points_arrays = cpp_math::Vector3dArrays{points.data(), points.data() + count, points.data() + 2 * count};
+    auto covariance_arrays = cpp_math::CovarianceArrays{
+      covariances.data(),
+      covariances.data() + count,
+      covariances.data() + 2 * count,
+      covariances.data() + 3 * count,
+      covariances.data() + 4 * count,
+      covariances.data() + 5 * count
+    };
+
+    // Sigmas of every input except z, which has no uncertainty
+    cpp_math::PointInputCovariance diagonal{};
+    double const sigmas[] = {0.5, 2, 2, 0, 0.05, 0.05, 0.05, 0.02, 0.02};
+    for(size_t i = 0; i < cpp_math::point_inputs_count; ++i) {
+      diagonal[i][i] = sigmas[i] * sigmas[i];
+    }
+    // Correlated heli angles, for example of one attitude filter
+    auto correlated = diagonal;
+    correlated[4][5] = correlated[5][4] = 0.001;
+    correlated[5][6] = correlated[6][5] = -0.0005;
+
+    auto check = [&](cpp_math::PointInputCovariance const& expected_covariance) {
+      cpp_math::PointJacobian jacobian;
+      for(size_t i = 0; i < count; ++i) {
+        auto const& input = inputs[i];
+        auto expected = cpp_math::calculatePointWithJacobian(
+          input.distance, input.position, input.angles, input.camera_angles, jacobian
+        );
+        REQUIRE(sameBits(expected, cpp_math::Vector3d{points[i], points[count + i], points[2 * count + i]}));
+        auto covariance = cpp_math::propagateCovariance(jacobian, expected_covariance);
+        double const upper[] = {
+          covariance[0][0], covariance[0][1], covariance[0][2], covariance[1][1], covariance[1][2], covariance[2][2]
+        };
+        for(size_t k = 0; k < 6; ++k) {
+          REQUIRE(covariances[k * count + i] == Approx(upper[k]).epsilon(1e-12).margin(1e-9));
+        }
+      }
+    };
+
+    cpp_math::calculatePointsWithCovariance(
+      count,
+      distances.data(),
+      {x.data(), y.data(), z.data()},
+      {yaw.data(), pitch.data(), roll.data()},
+      {camera_yaw.data(), camera_pitch.data()},
+      cpp_math::PointInputSigmas{
+        sigma_distance.data(),
+        {sigma_xy.data(), sigma_xy.data(), nullptr},
+        {sigma_angle.data(), sigma_angle.data(), sigma_angle.data()},
+        {sigma_camera.data(), sigma_camera.data()}
+      },
+      points_arrays,
+      covariance_arrays
+    );
+    check(diagonal);
+
+    cpp_math::ThreadPoolExecutor pool(3);
+    cpp_math::calculatePointsWithCovariance(
+      count,
+      distances.data(),
+      {x.data(), y.data(), z.data()},
+      {yaw.data(), pitch.data(), roll.data()},
+      {camera_yaw.data(), camera_pitch.data()},
+      correlated,
+      points_arrays,
+      covariance_arrays,
+      pool,
+      500
+    );
+    check(correlated);
+  }
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch.hpp>
+
+#include <cpp-math/cpp_math.h>
+#include <cpp-math/vector_expression.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using cpp_math::operator<<;
+
+namespace
+{
+  bool vectors_almost_equal(
+    cpp_math::Vector3d const& v1,
+    cpp_math::Vector3d const& v2,
+    double epsilon
+  )
+  {
+    return std::abs(v1.x - v2.x) <= epsilon && std::abs(v1.y - v2.y) <= epsilon
+        && std::abs(v1.z - v2.z) <= epsilon;
+  }
+}  // namespace
+
+TEST_CASE("Vector expressions")
+{
+  std::mt19937_64 generator(29);
+  std::uniform_real_distribution<double> coordinate(-100, 100);
+  auto random_vector = [&]() {
+    return cpp_math::Vector3d{coordinate(generator), coordinate(generator), coordinate(generator)};
+  };
+
+  SECTION("Same as free functions")
+  {
+    for(int i = 0; i < 1000; ++i) {
+      auto p = random_vector();
+      auto v = random_vector();
+      auto d = coordinate(generator);
+      auto matrix = cpp_math::calculateRotationMatrix(cpp_math::Axis::Y, d);
+
+      cpp_math::Vector3d sum = p + v;
+      cpp_math::Vector3d difference = p - v;
+      cpp_math::Vector3d scaled = v * d;
+      cpp_math::Vector3d negated = -v;
+      cpp_math::Vector3d point = p + d * matrix * v;
+      REQUIRE(vectors_almost_equal(sum, cpp_math::addVectors(p, v), 0));
+      REQUIRE(vectors_almost_equal(difference, cpp_math::subtractVectors(p, v), 0));
+      REQUIRE(vectors_almost_equal(scaled, cpp_math::multiplyVectorByScalar(v, d), 0));
+      REQUIRE(vectors_almost_equal(negated, cpp_math::multiplyVectorByScalar(v, -1), 0));
+      auto expected = cpp_math::addVectors(
+        p, cpp_math::multiplyVectorByScalar(cpp_math::multiplyMatrixByVector(matrix, v), d)
+      );
+      REQUIRE(vectors_almost_equal(point, expected, 1e-10));
+      REQUIRE(vectors_almost_equal(cpp_math::evaluate(p - (v + p) * 2 + v), cpp_math::Vector3d{-p.x - v.x, -p.y - v.y, -p.z - v.z}, 1e-10));
+    }
+  }
+
+  SECTION("Expressions keep operands by value")
+  {
+    auto make_expression = [](double d) {
+      auto p = cpp_math::Vector3d{1, 2, 3};
+      return p + d * cpp_math::Vector3d{1, 1, 1};
+    };
+    auto expression = make_expression(2);
+    cpp_math::Vector3d result = expression;
+    REQUIRE(vectors_almost_equal(result, cpp_math::Vector3d{3, 4, 5}, 0));
+  }
+
+  SECTION("Float")
+  {
+    cpp_math::Vector3f result = cpp_math::Vector3f{1, 2, 3} + 2 * cpp_math::identityMatrix<float>() * cpp_math::Vector3f{1, 0, 0};
+    REQUIRE(result.x == 3);
+    REQUIRE(result.y == 2);
+    REQUIRE(result.z == 3);
+  }
+
+  SECTION("Arrays in a single pass")
+  {
+    constexpr size_t count = 1001;
+    std::vector<double> x(count), y(count), z(count), distances(count);
+    for(size_t i = 0; i < count; ++i) {
+      auto v = random_vector();
+      x[i] = v.x;
+      y[i] = v.y;
+      z[i] = v.z;
+      distances[i] = coordinate(generator);
+    }
+    auto direction = cpp_math::Vector3d{0.6, 0, 0.8};
+    auto matrix = cpp_math::calculateRotationMatrix(cpp_math::Axis::Z, 0.5);
+    std::vector<double> result_x(count), result_y(count), result_z(count);
+    cpp_math::evaluate(
+      count, {result_x.data(), result_y.data(), result_z.data()},
+      cpp_math::arrays({x.data(), y.data(), z.data()}) + cpp_math::perElement(distances.data()) * matrix * direction
+    );
+    for(size_t i = 0; i < count; ++i) {
+      cpp_math::Vector3d expected = cpp_math::Vector3d{x[i], y[i], z[i]} + distances[i] * (matrix * direction);
+      INFO("Index is " << i);
+      REQUIRE(vectors_almost_equal({result_x[i], result_y[i], result_z[i]}, expected, 0));
+    }
+
+    // In place
+    auto source_x = x, source_y = y, source_z = z;
+    cpp_math::evaluate(count, {x.data(), y.data(), z.data()}, cpp_math::arrays({x.data(), y.data(), z.data()}) * 2 - direction);
+    for(size_t i = 0; i < count; ++i) {
+      auto expected = cpp_math::Vector3d{2 * source_x[i] - 0.6, 2 * source_y[i], 2 * source_z[i] - 0.8};
+      REQUIRE(vectors_almost_equal({x[i], y[i], z[i]}, expected, 0));
+    }
+  }
+}
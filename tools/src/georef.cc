@@ -0,0 +1,196 @@
+#include <cpp-math/executor.h>
+#include <cpp-math/telemetry_log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  // 64 MiB of records between releases of pages and progress lines
+  constexpr size_t window_size = (64 << 20) / sizeof(cpp_math::TelemetryRecord);
+
+  struct Options
+  {
+    std::string input;
+    std::string output;
+    size_t threads = 1;
+    size_t chunk_size = cpp_math::georeference_chunk_size;
+    cpp_math::BatchMode mode = cpp_math::BatchMode::Fast;
+    size_t generate = 0;
+  };
+
+  void printUsage(char const* program)
+  {
+    std::cerr << "Usage: " << program << " [options] <telemetry log> <output>\n"
+              << "Georeferences records (timestamp, position, heli angles, camera angles, distance) of 10 doubles\n"
+              << "into records (timestamp, x, y, z) of 4 doubles, both in native byte order\n"
+              << "  --threads <count>      threads to use, 0 for every core, 1 by default\n"
+              << "  --chunk <records>      records per batch call, " << cpp_math::georeference_chunk_size << " by default\n"
+              << "  --strict               the same bits as single calls, see BatchMode::Strict\n"
+              << "  --generate <records>   write a random telemetry log to <telemetry log> and exit\n";
+  }
+
+  /// @brief std::stoul takes "-1" as SIZE_MAX and ignores trailing characters, counts need only digits
+  size_t parseCount(std::string const& option, std::string const& text)
+  {
+    auto digits = not text.empty() and text.find_first_not_of("0123456789") == std::string::npos;
+    try {
+      if(digits) {
+        return std::stoul(text);
+      }
+    } catch(std::out_of_range const&) {
+    }
+    throw std::invalid_argument(
+      option + " needs a count from 0 to " + std::to_string(std::numeric_limits<unsigned long>::max()) + ", not " + text
+    );
+  }
+
+  Options parseOptions(int argc, char** argv)
+  {
+    Options options;
+    std::vector<std::string> positional;
+    for(int i = 1; i < argc; ++i) {
+      auto option = std::string(argv[i]);
+      auto value = [&]() {
+        if(i + 1 >= argc) {
+          throw std::invalid_argument(option + " needs a value");
+        }
+        return std::string(argv[++i]);
+      };
+      if(option == "--threads") {
+        options.threads = parseCount(option, value());
+      } else if(option == "--chunk") {
+        options.chunk_size = std::max<size_t>(1, parseCount(option, value()));
+      } else if(option == "--strict") {
+        options.mode = cpp_math::BatchMode::Strict;
+      } else if(option == "--generate") {
+        options.generate = parseCount(option, value());
+      } else if(option.size() > 1 and option[0] == '-') {
+        throw std::invalid_argument("Unknown option " + option);
+      } else {
+        positional.push_back(option);
+      }
+    }
+    auto expected = options.generate != 0 ? 1u : 2u;
+    if(positional.size() != expected) {
+      throw std::invalid_argument("Wrong number of files");
+    }
+    options.input = positional[0];
+    if(options.generate == 0) {
+      options.output = positional[1];
+    }
+    return options;
+  }
+
+  /// @brief Heli flying over an area and a camera sweeping across, written window by window
+  void generate(std::string const& path, size_t count)
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    std::mt19937_64 generator(1);
+    std::uniform_real_distribution<double> noise(-1, 1);
+    std::vector<cpp_math::TelemetryRecord> window;
+    for(size_t begin = 0; begin < count and file; begin += window_size) {
+      window.clear();
+      for(auto i = begin; i < std::min(count, begin + window_size); ++i) {
+        auto t = static_cast<double>(i) / 1000;
+        window.push_back(cpp_math::TelemetryRecord{
+          t,
+          {50 * t, 10 * noise(generator), 1500 + noise(generator)},
+          {30 + noise(generator), 2 * noise(generator), 3 * noise(generator)},
+          {45 * noise(generator), -60 + 10 * noise(generator)},
+          1700 + 100 * noise(generator)
+        });
+      }
+      file.write(
+        reinterpret_cast<char const*>(window.data()), static_cast<std::streamsize>(window.size() * sizeof(cpp_math::TelemetryRecord))
+      );
+    }
+    if(not file) {
+      throw std::runtime_error("Can not write " + path);
+    }
+  }
+
+  void printProgress(size_t done, size_t total, Clock::time_point start, bool final)
+  {
+    auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    auto rate = seconds > 0 ? static_cast<double>(done) / seconds : 0;
+    std::cerr << (final ? "" : "\r") << std::fixed << std::setprecision(1)
+              << (total == 0 ? 100.0 : 100.0 * static_cast<double>(done) / static_cast<double>(total)) << "% " << done
+              << "/" << total << " records, " << seconds << " s, " << rate / 1e6 << " M records/s, "
+              << rate * sizeof(cpp_math::TelemetryRecord) / (1 << 20) << " MiB/s" << (final ? "\n" : "") << std::flush;
+  }
+
+  void georeference(Options const& options)
+  {
+    cpp_math::TelemetryLog log(options.input);
+    cpp_math::GeoreferencedLogWriter writer(options.output, log.size());
+    std::unique_ptr<cpp_math::Executor> pool;
+    if(options.threads != 1) {
+      pool.reset(new cpp_math::ThreadPoolExecutor(options.threads));
+    }
+    auto& executor = pool ? *pool : cpp_math::sequentialExecutor();
+    std::cerr << "Georeferencing " << log.size() << " records of " << options.input << " on " << executor.concurrency()
+              << " threads\n";
+
+    auto const start = Clock::now();
+    auto last_progress = start;
+    for(size_t window = 0; window < log.size(); window += window_size) {
+      auto count = std::min(window_size, log.size() - window);
+      auto const* records = log.records() + window;
+      auto* result = writer.records() + window;
+      executor.parallelFor(count, options.chunk_size, [&](size_t begin, size_t end) {
+        // Chunks of one thread go through the same arrays, so they stay in its cache
+        thread_local std::unique_ptr<cpp_math::Georeferencer> georeferencer;
+        if(not georeferencer or georeferencer->chunkSize() != options.chunk_size) {
+          georeferencer.reset(new cpp_math::Georeferencer(options.chunk_size, options.mode));
+        }
+        georeferencer->process(records + begin, end - begin, result + begin);
+      });
+      // Files bigger than RAM: the window is done, its pages are not needed in this process anymore
+      log.release(window + count);
+      writer.release(window + count);
+      if(Clock::now() - last_progress > std::chrono::seconds(1)) {
+        last_progress = Clock::now();
+        printProgress(window + count, log.size(), start, false);
+      }
+    }
+    printProgress(log.size(), log.size(), start, true);
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  Options options;
+  try {
+    options = parseOptions(argc, argv);
+  } catch(std::exception const& error) {
+    std::cerr << error.what() << "\n";
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  try {
+    if(options.generate != 0) {
+      generate(options.input, options.generate);
+    } else {
+      georeference(options);
+    }
+  } catch(std::exception const& error) {
+    std::cerr << error.what() << "\n";
+    return 1;
+  }
+  return 0;
+}